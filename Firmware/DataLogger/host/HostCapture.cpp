@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          HostCapture.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, a running capture for the host programs
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "HostCapture.h"
+#include "HostCard.h"
+#include "WArduino.h"
+#include "Simulation.h"
+#include "SdCardSim.h"
+
+#include "DataLogger_config.h"         // SS_Pin
+#include "aweLog.h"                    // DbgSerial
+#include "Uart.h"
+#include "Config.h"
+#include "Capture.h"
+#include "Timebase.h"
+#include "picoOS/picoOS.h"
+#include "SdFat/SdFat.h"
+
+extern SdFat sd;                       // SdCardTask.cpp
+extern Capture capture;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+const char *hostCaptureImage( ImageBlockDevice *image, const char *dir, uint32_t size_mb )
+{
+   char path[ 1024 ];
+   snprintf( path, sizeof( path ), "%s/capture-XXXXXX", dir );
+   int fd = mkstemp( path );
+   if( fd < 0 )
+      return "can't create the image";
+   close( fd );
+
+   bool opened = image->open( path, ( uint64_t )size_mb << 20, true );
+   unlink( path );
+   if( !opened )
+      return "can't open the image";
+   sdCardSim.insert( image );
+   return NULL;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+const char *hostCaptureStart( ImageBlockDevice *image, const char *config, size_t len,
+                              const SdLatency_t *latency )
+{
+   // the files without latency
+   if( !hostFormatCard() || !hostWriteFile( "config.txt", config, len ) )
+      return "can't prepare the image";
+
+   sim.powerOn();
+   image->setLatency( latency );
+
+   DbgSerial.begin( UART_DEFAULT_BAUDRATE );
+   posDISABLE_INTERRUPTS();
+   posInit( 144 );
+   posENABLE_INTERRUPTS();
+   timebase.begin();
+
+   if( !sd.begin( SS_Pin, SD_SCK_MHZ( 50 ) ) )
+      return "sd.begin() failed";
+   if( !getConfiguration() )
+      return "getConfiguration() failed";
+   if( !capture.setup() )
+      return "Capture::setup() failed";
+   capture.arm();
+   if( !capture.start() )
+      return "Capture::start() failed";
+   return NULL;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, a running capture for the host programs
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __HOSTCAPTURE_H__
+#define __HOSTCAPTURE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "ImageBlockDevice.h"
+
+// --------------------------------------------------------------------------
+// The firmware up to a running capture, for the programs which drive
+// Capture::run() by their own, like the SdCardTask does.
+//
+// The functions return NULL, or what failed. The static state of the
+// firmware is that after the power on only once, so a program runs one
+// capture per process.
+// --------------------------------------------------------------------------
+
+// a new image of size_mb in dir, mapped, and removed from dir at once, the
+// image is inserted into sdCardSim
+const char *hostCaptureImage( ImageBlockDevice *image, const char *dir, uint32_t size_mb );
+
+// format the image, write config.txt, then power on, setup() and the
+// SdCardTask up to Capture::start(), the card with latency
+const char *hostCaptureStart( ImageBlockDevice *image, const char *config, size_t len,
+                              const SdLatency_t *latency );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __HOSTCAPTURE_H__
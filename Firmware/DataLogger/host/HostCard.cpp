@@ -0,0 +1,165 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          HostCard.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, moved from main.cpp, shared with the benchmark
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include "HostCard.h"
+#include "WArduino.h"
+
+#include "DataLogger_config.h"         // SS_Pin
+#include "SdFat/SdFat.h"
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static SdSpiConfig hostSpiConfig( void )
+{
+   return SdSpiConfig( SS_Pin, SHARED_SPI, SD_SCK_MHZ( 50 ) );
+}
+
+// SdFat::format() clears the cache of the volume, which isn't initialized
+// before a begin() in a local SdFat, so the formatter gets an own buffer
+bool hostFormatCard( void )
+{
+   SdFat fs;
+   FatFormatter formatter;
+   uint8_t buf[ 512 ];
+
+   if( !fs.cardBegin( hostSpiConfig() ) )
+      return false;
+   return formatter.format( fs.card(), buf, NULL );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool hostWriteFile( const char *name, const void *data, size_t len )
+{
+   SdFat fs;
+   File32 file;
+
+   bool ok = fs.begin( hostSpiConfig() )
+             && file.open( name, O_WRONLY | O_CREAT | O_TRUNC )
+             && file.write( data, len ) == len;
+
+   return file.close() && ok;
+}
+
+bool hostCopyFile( const char *path, const char *name )
+{
+   FILE *in = fopen( path, "rb" );
+   if( in == NULL )
+      return false;
+
+   SdFat fs;
+   File32 file;
+   bool ok = fs.begin( hostSpiConfig() )
+             && file.open( name, O_WRONLY | O_CREAT | O_TRUNC );
+
+   char buf[ 512 ];
+   size_t n;
+   while( ok && ( n = fread( buf, 1, sizeof( buf ), in ) ) > 0 )
+      ok = file.write( buf, n ) == n;
+
+   ok = file.close() && ok;
+   fclose( in );
+   return ok;
+}
+
+bool hostReadFile( const char *name, std::vector< uint8_t > *data )
+{
+   SdFat fs;
+   File32 file;
+
+   if( !fs.begin( hostSpiConfig() ) || !file.open( name, O_RDONLY ) )
+      return false;
+
+   data->resize( file.fileSize() );
+   bool ok = data->empty()
+             || file.read( data->data(), data->size() ) == ( int )data->size();
+
+   file.close();
+   return ok;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool hostExtractFiles( const char *dir, bool verbose )
+{
+   SdFat fs;
+   File32 root;
+   File32 file;
+
+   mkdir( dir, 0755 );
+   if( !fs.begin( hostSpiConfig() ) || !root.open( "/" ) )
+      return false;
+
+   while( file.openNext( &root, O_RDONLY ) )
+   {
+      char name[ 13 ];
+      char path[ 1024 ];
+
+      file.getName( name, sizeof( name ) );
+      snprintf( path, sizeof( path ), "%s/%s", dir, name );
+
+      FILE *out = file.isDir() ? NULL : fopen( path, "wb" );
+      if( out != NULL )
+      {
+         uint8_t buf[ 512 ];
+         int n;
+         while( ( n = file.read( buf, sizeof( buf ) ) ) > 0 )
+            fwrite( buf, 1, n, out );
+         fclose( out );
+         if( verbose )
+            fprintf( stderr, "%-12s %10lu bytes\n", name, ( unsigned long )file.fileSize() );
+      }
+      file.close();
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
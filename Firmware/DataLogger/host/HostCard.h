@@ -0,0 +1,64 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, the files of the image from the host side
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __HOSTCARD_H__
+#define __HOSTCARD_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// --------------------------------------------------------------------------
+// The files of the sd card image, accessed by the host with an own SdFat.
+//
+// Only while the firmware doesn't use the card: before its start, or after
+// the end of a run. The image is inserted into sdCardSim.
+// --------------------------------------------------------------------------
+
+// format the card like the SdFormatter example
+bool hostFormatCard( void );
+
+// write data into a new file of the root directory
+bool hostWriteFile( const char *name, const void *data, size_t len );
+
+// copy the host file path to name
+bool hostCopyFile( const char *path, const char *name );
+
+// read a file of the root directory
+bool hostReadFile( const char *name, std::vector< uint8_t > *data );
+
+// copy all files of the root directory to the host directory dir
+bool hostExtractFiles( const char *dir, bool verbose );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __HOSTCARD_H__
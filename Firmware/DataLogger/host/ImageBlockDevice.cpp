@@ -0,0 +1,329 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          ImageBlockDevice.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   stall(), a garbage collection stall at a given time
+// 2026-10-18  AWe   mmap of the image, latency model of a sd card
+// 2026-10-18  AWe   initial version, block device on an image file
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ImageBlockDevice.h"
+#include "Simulation.h"                // sim.nanos()
+
+// --------------------------------------------------------------------------
+// latency profiles
+// --------------------------------------------------------------------------
+
+#define US     1000UL
+#define MS     1000000UL
+
+static const SdLatency_t latencyProfiles[] =
+{
+   // name        command   read      program   AU sectors  open  AU open   gc every  gc min    gc max
+   { "none",      0,        0,        0,        0,          0,    0,        0,        0,        0        },
+   { "fast",      50 * US,  250 * US, 40 * US,  8192,       4,    1 * MS,   4096,     100 * MS, 150 * MS },
+   { "typical",   100 * US, 500 * US, 100 * US, 8192,       2,    3 * MS,   2048,     100 * MS, 250 * MS },
+   { "slow",      250 * US, 1 * MS,   300 * US, 8192,       1,    10 * MS,  512,      150 * MS, 250 * MS },
+};
+
+const SdLatency_t *sdLatencyProfile( const char *name )
+{
+   for( size_t i = 0; i < sizeof( latencyProfiles ) / sizeof( latencyProfiles[ 0 ] ); i++ )
+   {
+      if( strcasecmp( name, latencyProfiles[ i ].name ) == 0 )
+         return &latencyProfiles[ i ];
+   }
+   return NULL;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+ImageBlockDevice::ImageBlockDevice( void )
+{
+   fd = -1;
+   sectors = 0;
+   map = NULL;
+   setLatency( NULL );
+}
+
+ImageBlockDevice::~ImageBlockDevice( void )
+{
+   close();
+}
+
+// a new image is a sparse file, only the written sectors need space
+
+bool ImageBlockDevice::open( const char *path, uint64_t size, bool mapped )
+{
+   close();
+
+   fd = ::open( path, size ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644 );
+   if( fd < 0 )
+      return false;
+
+   if( size && ftruncate( fd, size ) != 0 )
+   {
+      close();
+      return false;
+   }
+
+   struct stat st;
+   if( fstat( fd, &st ) != 0 || st.st_size < IMAGE_SECTOR_SIZE )
+   {
+      close();
+      return false;
+   }
+
+   sectors = st.st_size / IMAGE_SECTOR_SIZE;
+
+   if( mapped )
+   {
+      void *addr = mmap( NULL, ( size_t )sectors * IMAGE_SECTOR_SIZE,
+                         PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+      if( addr == MAP_FAILED )
+      {
+         close();
+         return false;
+      }
+      map = ( uint8_t * )addr;
+   }
+
+   reset();
+   return true;
+}
+
+void ImageBlockDevice::close( void )
+{
+   if( map )
+      munmap( map, ( size_t )sectors * IMAGE_SECTOR_SIZE );
+   map = NULL;
+
+   if( fd >= 0 )
+      ::close( fd );
+   fd = -1;
+   sectors = 0;
+}
+
+void ImageBlockDevice::setLatency( const SdLatency_t *profile )
+{
+   if( profile )
+      latency = *profile;
+   else
+      latency = latencyProfiles[ 0 ];
+
+   if( latency.openAus > IMAGE_OPEN_AUS_MAX )
+      latency.openAus = IMAGE_OPEN_AUS_MAX;
+
+   reset();
+}
+
+void ImageBlockDevice::reset( void )
+{
+   busyUntil = 0;
+   nextSector = UINT32_MAX;
+   lastWrite = false;
+   openAuCount = 0;
+   gcCount = 0;
+   random = 0x2545F491;
+   memset( &stats, 0, sizeof( stats ) );
+}
+
+// --------------------------------------------------------------------------
+// the latency model
+// --------------------------------------------------------------------------
+
+void ImageBlockDevice::busy( uint64_t ns )
+{
+   if( ns == 0 )
+      return;
+
+   uint64_t now = sim.nanos();
+   busyUntil = ( busyUntil > now ? busyUntil : now ) + ns;
+
+   stats.busyNs += ns;
+   if( ns > stats.maxBusyNs )
+      stats.maxBusyNs = ns;
+}
+
+void ImageBlockDevice::stall( uint64_t ns )
+{
+   stats.gcStalls++;
+   busy( ns );
+}
+
+// the AUs are kept in the order of their last use, a write into an AU which
+// isn't open closes the oldest one
+
+uint32_t ImageBlockDevice::auCost( uint32_t au )
+{
+   uint8_t i;
+
+   for( i = 0; i < openAuCount; i++ )
+   {
+      if( openAu[ i ] == au )
+         break;
+   }
+
+   uint32_t ns = 0;
+   if( i == openAuCount )
+   {
+      stats.auOpens++;
+      ns = latency.auOpenNs;
+      if( openAuCount < latency.openAus )
+         openAuCount++;
+      i = openAuCount - 1;
+   }
+
+   memmove( &openAu[ 1 ], &openAu[ 0 ], i * sizeof( openAu[ 0 ] ) );
+   openAu[ 0 ] = au;
+   return ns;
+}
+
+void ImageBlockDevice::access( uint32_t sector, size_t ns, bool write )
+{
+   uint64_t t = 0;
+
+   if( sector != nextSector || write != lastWrite )
+   {
+      stats.commands++;
+      t += latency.commandNs;
+   }
+   nextSector = sector + ns;
+   lastWrite = write;
+
+   for( size_t i = 0; i < ns; i++ )
+   {
+      if( !write )
+      {
+         t += latency.readNs;
+         continue;
+      }
+
+      t += latency.programNs;
+      if( latency.auSectors && latency.openAus )
+         t += auCost( ( sector + i ) / latency.auSectors );
+
+      if( latency.gcInterval && ++gcCount >= latency.gcInterval )
+      {
+         // xorshift32, the same stalls in each run
+         random ^= random << 13;
+         random ^= random >> 17;
+         random ^= random << 5;
+
+         gcCount = 0;
+         stats.gcStalls++;
+         t += latency.gcMinNs + random % ( latency.gcMaxNs - latency.gcMinNs + 1 );
+      }
+   }
+
+   busy( t );
+}
+
+// --------------------------------------------------------------------------
+// BlockDeviceInterface
+// --------------------------------------------------------------------------
+
+bool ImageBlockDevice::isBusy( void )
+{
+   return sim.nanos() < busyUntil;
+}
+
+bool ImageBlockDevice::readSector( uint32_t sector, uint8_t *dst )
+{
+   return readSectors( sector, dst, 1 );
+}
+
+bool ImageBlockDevice::readSectors( uint32_t sector, uint8_t *dst, size_t ns )
+{
+   if( fd < 0 || sector + ns > sectors )
+      return false;
+
+   access( sector, ns, false );
+
+   size_t len = ns * IMAGE_SECTOR_SIZE;
+   off_t offset = ( off_t )sector * IMAGE_SECTOR_SIZE;
+
+   if( map )
+   {
+      memcpy( dst, map + offset, len );
+      return true;
+   }
+   return pread( fd, dst, len, offset ) == ( ssize_t )len;
+}
+
+uint32_t ImageBlockDevice::sectorCount( void )
+{
+   return sectors;
+}
+
+// the end of a multi sector transfer, the next access is a new command
+bool ImageBlockDevice::syncDevice( void )
+{
+   nextSector = UINT32_MAX;
+   return fd >= 0;
+}
+
+bool ImageBlockDevice::writeSector( uint32_t sector, const uint8_t *src )
+{
+   return writeSectors( sector, src, 1 );
+}
+
+bool ImageBlockDevice::writeSectors( uint32_t sector, const uint8_t *src, size_t ns )
+{
+   if( fd < 0 || sector + ns > sectors )
+      return false;
+
+   access( sector, ns, true );
+
+   size_t len = ns * IMAGE_SECTOR_SIZE;
+   off_t offset = ( off_t )sector * IMAGE_SECTOR_SIZE;
+
+   if( map )
+   {
+      memcpy( map + offset, src, len );
+      return true;
+   }
+   return pwrite( fd, src, len, offset ) == ( ssize_t )len;
+}
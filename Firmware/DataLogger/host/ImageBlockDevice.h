@@ -0,0 +1,137 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   stall(), a garbage collection stall at a given time
+// 2026-10-18  AWe   mmap of the image, latency model of a sd card
+// 2026-10-18  AWe   initial version, block device on an image file
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __IMAGE_BLOCK_DEVICE_H__
+#define __IMAGE_BLOCK_DEVICE_H__
+
+#include <stdint.h>
+#include "SdFat/common/BlockDeviceInterface.h"
+
+// --------------------------------------------------------------------------
+// the sectors of a simulated sd card in an image file of the host
+//
+// The image is accessed with pread() and pwrite(), or mapped into the memory
+// with mmap(). Without a latency model the device is never busy. With one
+// each access makes it busy for a while on the clock of the simulation:
+//
+//  - a command, a sector which doesn't follow the previous access
+//  - the access time of a read, the program time of a written sector
+//  - a write into an allocation unit (AU) which isn't open, the card has
+//    only a few open AUs, the least recently used one is closed
+//  - a garbage collection stall after each gcInterval written sectors, its
+//    length is taken from gcMinNs .. gcMaxNs with a fixed seed
+//
+// So the worst case of the buffering in the firmware can be measured, and
+// the same run gives the same stalls.
+// --------------------------------------------------------------------------
+
+#define IMAGE_SECTOR_SIZE     512
+#define IMAGE_OPEN_AUS_MAX    4
+
+typedef struct
+{
+   const char *name;
+   uint32_t commandNs;        // ns, a new read or write command
+   uint32_t readNs;           // ns, access time of a sector
+   uint32_t programNs;        // ns, program time of a sector
+   uint32_t auSectors;        // sectors of an allocation unit, 0 without AUs
+   uint8_t  openAus;          // AUs which are open at the same time
+   uint32_t auOpenNs;         // ns, to write into an AU which isn't open
+   uint32_t gcInterval;       // written sectors between two stalls, 0 no stalls
+   uint32_t gcMinNs;          // ns, shortest stall
+   uint32_t gcMaxNs;          // ns, longest stall
+} SdLatency_t;
+
+typedef struct
+{
+   uint32_t commands;         // non sequential accesses
+   uint32_t auOpens;          // writes into an AU which wasn't open
+   uint32_t gcStalls;
+   uint64_t busyNs;           // sum of all busy times
+   uint64_t maxBusyNs;        // longest busy time of one access
+} ImageStats_t;
+
+// the latency profiles by name: none, fast, typical, slow
+const SdLatency_t *sdLatencyProfile( const char *name );
+
+class ImageBlockDevice : public BlockDeviceInterface
+{
+private:
+   int      fd;
+   uint32_t sectors;
+   uint8_t *map;                          // the mapped image or NULL
+
+   SdLatency_t latency;
+   uint64_t busyUntil;                    // ns, on the clock of the simulation
+   uint32_t nextSector;                   // sector after the last access
+   bool     lastWrite;
+   uint32_t openAu[ IMAGE_OPEN_AUS_MAX ]; // most recently used first
+   uint8_t  openAuCount;
+   uint32_t gcCount;                      // written sectors since the last stall
+   uint32_t random;                       // xorshift state of the stall length
+
+   void busy( uint64_t ns );
+   void access( uint32_t sector, size_t ns, bool write );
+   uint32_t auCost( uint32_t au );
+
+public:
+   ImageStats_t stats;
+
+   ImageBlockDevice( void );
+   virtual ~ImageBlockDevice( void );
+
+   // size is used for a new image, 0 opens an existing one
+   bool open( const char *path, uint64_t size, bool mapped = false );
+   void close( void );
+   bool isOpen( void ) { return fd >= 0; }
+
+   // NULL or the profile "none" switches the latency model off
+   void setLatency( const SdLatency_t *profile );
+
+   // the card is idle, e.g. after the time of the simulation starts again
+   void reset( void );
+
+   // a garbage collection stall of ns from now, besides those of the latency
+   // model, e.g. the stall of a field incident in a replayed trace
+   void stall( uint64_t ns );
+
+   virtual bool isBusy( void );
+   virtual bool readSector( uint32_t sector, uint8_t *dst );
+   virtual bool readSectors( uint32_t sector, uint8_t *dst, size_t ns );
+   virtual uint32_t sectorCount( void );
+   virtual bool syncDevice( void );
+   virtual bool writeSector( uint32_t sector, const uint8_t *src );
+   virtual bool writeSectors( uint32_t sector, const uint8_t *src, size_t ns );
+};
+
+#endif // __IMAGE_BLOCK_DEVICE_H__
@@ -0,0 +1,74 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, spi bus with the simulated sd card
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __HOST_SPI_H__
+#define __HOST_SPI_H__
+
+#include "WArduino.h"
+
+// --------------------------------------------------------------------------
+// the SPI library of the Arduino core, the only device on the bus is the
+// sd card of SdCardSim, its chip select is SS
+// --------------------------------------------------------------------------
+
+#define MSBFIRST           1
+#define LSBFIRST           0
+#define SPI_MODE0          0x00
+
+class SPISettings
+{
+public:
+   SPISettings( uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0 )
+      : clock( clock ) { ( void )bitOrder; ( void )dataMode; }
+
+   uint32_t clock;
+};
+
+class SPIClass
+{
+private:
+   uint32_t byteNs;                       // 8 bits at the clock of the transaction
+
+public:
+   SPIClass( void );
+
+   void begin( void );
+   void end( void );
+   void beginTransaction( SPISettings settings );
+   void endTransaction( void );
+
+   uint8_t transfer( uint8_t data );
+   void transfer( void *buf, size_t count );
+};
+
+extern SPIClass SPI;
+
+#endif // __HOST_SPI_H__
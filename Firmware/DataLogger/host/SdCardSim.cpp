@@ -0,0 +1,473 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          SdCardSim.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   the time spent polling the busy card
+// 2026-10-18  AWe   each read and write command is a new access of the block device
+// 2026-10-18  AWe   initial version, sd card in spi mode on a block device
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "Simulation.h"
+#include "SdCardSim.h"
+#include "SPI.h"
+
+// --------------------------------------------------------------------------
+// sd card in spi mode
+// --------------------------------------------------------------------------
+
+#define R1_IDLE            0x01
+#define R1_ILLEGAL         0x04
+#define R1_PARAMETER       0x40
+
+#define TOKEN_DATA         0xFE           // CMD17, CMD18, CMD24
+#define TOKEN_WRITE_MULT   0xFC           // CMD25
+#define TOKEN_STOP_TRAN    0xFD           // end of CMD25
+
+#define DATA_ACCEPTED      0x05
+#define DATA_WRITE_ERROR   0x0D
+
+#define SD_STATUS_SIZE     64             // ACMD13
+
+SdCardSim sdCardSim;
+
+SdCardSim::SdCardSim( void )
+{
+   dev = NULL;
+   remove();
+}
+
+void SdCardSim::insert( BlockDeviceInterface *device )
+{
+   remove();
+   dev = device;
+}
+
+void SdCardSim::remove( void )
+{
+   dev = NULL;
+   state = Command;
+   cmdLen = 0;
+   appCmd = false;
+   idle = true;
+   multiple = false;
+   readPending = false;
+   pendingLen = 0;
+   sector = 0;
+   eraseStart = 0;
+   eraseEnd = 0;
+   outLen = 0;
+   outPos = 0;
+   dataLen = 0;
+   memset( &stats, 0, sizeof( stats ) );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// the response follows one byte after the command
+
+void SdCardSim::respond( const uint8_t *buf, uint16_t len )
+{
+   out[ 0 ] = 0xFF;
+   memcpy( &out[ 1 ], buf, len );
+   outLen = 1 + len;
+   outPos = 0;
+}
+
+void SdCardSim::queueBlock( const uint8_t *buf, uint16_t len )
+{
+   out[ 0 ] = TOKEN_DATA;
+   memcpy( &out[ 1 ], buf, len );
+   out[ 1 + len ] = 0xFF;                 // crc, not checked by SdFat
+   out[ 2 + len ] = 0xFF;
+   outLen = 3 + len;
+   outPos = 0;
+}
+
+// CSD version 2.0 of a SDHC card with the size of the block device
+
+static void buildCsd( uint8_t *csd, uint32_t sectors )
+{
+   uint32_t c_size = sectors / 1024 - 1;
+
+   memset( csd, 0, 16 );
+   csd[ 0 ] = 0x40;                       // csd_ver 1, version 2.0
+   csd[ 1 ] = 0x0E;                       // taac
+   csd[ 3 ] = 0x5A;                       // tran_speed 50 MHz
+   csd[ 4 ] = 0x5B;                       // ccc, read_bl_len 9
+   csd[ 5 ] = 0x59;
+   csd[ 7 ] = ( c_size >> 16 ) & 0x3F;
+   csd[ 8 ] = ( c_size >> 8 ) & 0xFF;
+   csd[ 9 ] = c_size & 0xFF;
+   csd[ 10 ] = 0x7F;                      // erase_blk_en, sector_size
+   csd[ 11 ] = 0x80;
+   csd[ 12 ] = 0x0A;                      // r2w_factor, write_bl_len 9
+   csd[ 13 ] = 0x40;
+   csd[ 15 ] = 0x01;
+}
+
+static void buildCid( uint8_t *cid )
+{
+   static const uint8_t host_cid[ 16 ] =
+   {
+      0x00, 'W', 'A', 'H', 'O', 'S', 'T', ' ', 0x10,
+      0x00, 0x00, 0x00, 0x01, 0x01, 0x6A, 0x01
+   };
+
+   memcpy( cid, host_cid, sizeof( host_cid ) );
+}
+
+void SdCardSim::execute( void )
+{
+   uint8_t  cmd_index = cmd[ 0 ] & 0x3F;
+   uint32_t arg = ( ( uint32_t )cmd[ 1 ] << 24 ) | ( ( uint32_t )cmd[ 2 ] << 16 )
+                | ( ( uint32_t )cmd[ 3 ] << 8 ) | cmd[ 4 ];
+   uint8_t  r1 = idle ? R1_IDLE : 0x00;
+   uint8_t  resp[ 8 ];
+   bool     acmd = appCmd;
+
+   stats.commands++;
+   appCmd = false;
+
+   if( acmd )
+   {
+      switch( cmd_index )
+      {
+         case 41:                         // SD_SEND_OP_COND
+            idle = false;
+            resp[ 0 ] = 0x00;
+            respond( resp, 1 );
+            return;
+
+         case 13:                         // SD_STATUS, R2 and a data block
+            resp[ 0 ] = r1;
+            resp[ 1 ] = 0x00;
+            respond( resp, 2 );
+            memset( data, 0, SD_STATUS_SIZE );
+            pendingLen = SD_STATUS_SIZE;
+            readPending = true;
+            return;
+
+         case 23:                         // SET_WR_BLK_ERASE_COUNT
+            resp[ 0 ] = r1;
+            respond( resp, 1 );
+            return;
+      }
+   }
+
+   switch( cmd_index )
+   {
+      case 0:                             // GO_IDLE_STATE
+         idle = true;
+         state = Command;
+         readPending = false;
+         resp[ 0 ] = R1_IDLE;
+         respond( resp, 1 );
+         break;
+
+      case 8:                             // SEND_IF_COND, echo the check pattern
+         resp[ 0 ] = r1;
+         resp[ 1 ] = 0x00;
+         resp[ 2 ] = 0x00;
+         resp[ 3 ] = ( arg >> 8 ) & 0x0F;
+         resp[ 4 ] = arg & 0xFF;
+         respond( resp, 5 );
+         break;
+
+      case 9:                             // SEND_CSD
+      case 10:                            // SEND_CID
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         if( cmd_index == 9 )
+            buildCsd( data, dev->sectorCount() );
+         else
+            buildCid( data );
+         pendingLen = 16;
+         readPending = true;
+         break;
+
+      case 12:                            // STOP_TRANSMISSION
+         state = Command;
+         readPending = false;
+         resp[ 0 ] = 0x00;
+         respond( resp, 1 );
+         break;
+
+      case 13:                            // SEND_STATUS, R2
+         resp[ 0 ] = r1;
+         resp[ 1 ] = 0x00;
+         respond( resp, 2 );
+         break;
+
+      case 17:                            // READ_SINGLE_BLOCK
+      case 18:                            // READ_MULTIPLE_BLOCK
+         if( arg >= dev->sectorCount() )
+         {
+            resp[ 0 ] = r1 | R1_PARAMETER;
+            respond( resp, 1 );
+            break;
+         }
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         sector = arg;
+         dev->syncDevice();               // a new command for the latency model
+         dev->readSector( sector, data );
+         stats.sectorsRead++;
+         pendingLen = 512;
+         readPending = true;
+         state = cmd_index == 18 ? ReadMultiple : Command;
+         break;
+
+      case 24:                            // WRITE_BLOCK
+      case 25:                            // WRITE_MULTIPLE_BLOCK
+         if( arg >= dev->sectorCount() )
+         {
+            resp[ 0 ] = r1 | R1_PARAMETER;
+            respond( resp, 1 );
+            break;
+         }
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         sector = arg;
+         dev->syncDevice();
+         multiple = cmd_index == 25;
+         state = WriteToken;
+         break;
+
+      case 32:                            // ERASE_WR_BLK_START
+         eraseStart = arg;
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         break;
+
+      case 33:                            // ERASE_WR_BLK_END
+         eraseEnd = arg;
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         break;
+
+      case 38:                            // ERASE, the erased sectors read as 0
+      {
+         static const uint8_t zero[ 512 ] = { 0 };
+
+         if( eraseEnd >= dev->sectorCount() || eraseStart > eraseEnd )
+         {
+            resp[ 0 ] = r1 | R1_PARAMETER;
+            respond( resp, 1 );
+            break;
+         }
+         for( uint32_t s = eraseStart; s <= eraseEnd; s++ )
+            dev->writeSector( s, zero );
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         break;
+      }
+
+      case 55:                            // APP_CMD
+         appCmd = true;
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         break;
+
+      case 58:                            // READ_OCR, powered up, SDHC
+         resp[ 0 ] = r1;
+         resp[ 1 ] = 0xC0;
+         resp[ 2 ] = 0xFF;
+         resp[ 3 ] = 0x80;
+         resp[ 4 ] = 0x00;
+         respond( resp, 5 );
+         break;
+
+      case 59:                            // CRC_ON_OFF
+         resp[ 0 ] = r1;
+         respond( resp, 1 );
+         break;
+
+      default:
+         resp[ 0 ] = r1 | R1_ILLEGAL;
+         respond( resp, 1 );
+         break;
+   }
+}
+
+// --------------------------------------------------------------------------
+// one byte on the bus, miso is shifted out while mosi is shifted in
+// --------------------------------------------------------------------------
+
+uint8_t SdCardSim::transfer( uint8_t mosi, bool selected )
+{
+   if( dev == NULL || !selected )
+      return 0xFF;
+
+   uint8_t miso;
+
+   // next data block of CMD18 after the previous one is shifted out
+   if( state == ReadMultiple && !readPending && outPos >= outLen )
+   {
+      if( sector + 1 < dev->sectorCount() )
+      {
+         dev->readSector( ++sector, data );
+         stats.sectorsRead++;
+         pendingLen = 512;
+         readPending = true;
+      }
+   }
+
+   if( outPos < outLen )
+      miso = out[ outPos++ ];
+   else if( dev->isBusy() )
+   {
+      // 0xFF until the read data is there, 0x00 while programming
+      miso = readPending ? 0xFF : 0x00;
+      stats.busyBytes++;
+   }
+   else if( readPending )
+   {
+      readPending = false;
+      queueBlock( data, pendingLen );
+      miso = out[ outPos++ ];
+   }
+   else
+      miso = 0xFF;
+
+   switch( state )
+   {
+      case Command:
+      case ReadMultiple:
+         if( cmdLen == 0 )
+         {
+            if( ( mosi & 0xC0 ) != 0x40 )
+               break;
+            if( state == ReadMultiple )
+            {
+               // CMD12 aborts the running data block
+               state = Command;
+               readPending = false;
+               outLen = 0;
+               outPos = 0;
+            }
+         }
+         cmd[ cmdLen++ ] = mosi;
+         if( cmdLen == sizeof( cmd ) )
+         {
+            cmdLen = 0;
+            execute();
+         }
+         break;
+
+      case WriteToken:
+         if( mosi == ( multiple ? TOKEN_WRITE_MULT : TOKEN_DATA ) )
+         {
+            state = WriteData;
+            dataLen = 0;
+         }
+         else if( multiple && mosi == TOKEN_STOP_TRAN )
+            state = Command;
+         break;
+
+      case WriteData:
+         data[ dataLen++ ] = mosi;
+         if( dataLen == sizeof( data ) )
+         {
+            bool ok = dev->writeSector( sector++, data );
+            stats.sectorsWritten++;
+
+            // the data response is the next byte, without the stuff byte
+            out[ 0 ] = ok ? DATA_ACCEPTED : DATA_WRITE_ERROR;
+            outLen = 1;
+            outPos = 0;
+            state = multiple && ok ? WriteToken : Command;
+         }
+         break;
+   }
+
+   return miso;
+}
+
+// --------------------------------------------------------------------------
+// SPI library
+// --------------------------------------------------------------------------
+
+SPIClass SPI;
+
+SPIClass::SPIClass( void )
+{
+   byteNs = 8ULL * SIM_NS_PER_S / 4000000;
+}
+
+void SPIClass::begin( void )
+{
+   pinMode( SS, OUTPUT );
+}
+
+void SPIClass::end( void )
+{
+}
+
+// the spi clock of the ATmega328P is at most F_CPU / 2
+
+void SPIClass::beginTransaction( SPISettings settings )
+{
+   uint32_t clock = settings.clock < F_CPU / 2 ? settings.clock : F_CPU / 2;
+   byteNs = 8ULL * SIM_NS_PER_S / clock;
+}
+
+void SPIClass::endTransaction( void )
+{
+}
+
+uint8_t SPIClass::transfer( uint8_t data )
+{
+   uint32_t busy = sdCardSim.stats.busyBytes;
+   uint64_t from = sim.nanos();
+
+   sim.spend( byteNs + sim.cost.spiByte );
+   uint8_t miso = sdCardSim.transfer( data, sim.level( SS ) == LOW );
+   if( sdCardSim.stats.busyBytes != busy )
+      sdCardSim.stats.waitNs += sim.nanos() - from;
+   return miso;
+}
+
+void SPIClass::transfer( void *buf, size_t count )
+{
+   uint8_t *p = ( uint8_t * )buf;
+
+   for( size_t i = 0; i < count; i++ )
+      p[ i ] = transfer( p[ i ] );
+}
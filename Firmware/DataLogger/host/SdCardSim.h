@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   the time spent polling the busy card
+// 2026-10-18  AWe   initial version, sd card in spi mode for the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __SD_CARD_SIM_H__
+#define __SD_CARD_SIM_H__
+
+#include <stdint.h>
+#include "SdFat/common/BlockDeviceInterface.h"
+
+// --------------------------------------------------------------------------
+// A SDHC card in spi mode, the commands which SdSpiCard of SdFat uses. The
+// sectors are stored on a block device, the card is busy as long as the
+// block device is busy.
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   uint32_t commands;
+   uint32_t sectorsRead;
+   uint32_t sectorsWritten;
+   uint32_t busyBytes;                    // bytes answered with busy
+   uint64_t waitNs;                       // ns, spent on the spi bus for these bytes
+} SdCardStats_t;
+
+class SdCardSim
+{
+private:
+   enum : uint8_t
+   {
+      Command,                            // wait for a command
+      ReadMultiple,                       // CMD18 until CMD12
+      WriteToken,                         // wait for the data token of CMD24, CMD25
+      WriteData,                          // 512 bytes and the crc
+   } state;
+
+   BlockDeviceInterface *dev;
+
+   uint8_t  cmd[ 6 ];
+   uint8_t  cmdLen;
+   bool     appCmd;                       // CMD55 before
+   bool     idle;                         // CMD0 until ACMD41
+   bool     multiple;                     // CMD25
+   bool     readPending;                  // a data block follows after the busy time
+   uint16_t pendingLen;                   // bytes of this data block
+   uint32_t sector;
+   uint32_t eraseStart;                   // CMD32
+   uint32_t eraseEnd;                     // CMD33
+
+   uint8_t  out[ 1 + 2 + 512 + 2 ];        // response, token, data, crc
+   uint16_t outLen;
+   uint16_t outPos;
+
+   uint8_t  data[ 512 + 2 ];
+   uint16_t dataLen;
+
+   void respond( const uint8_t *buf, uint16_t len );
+   void queueBlock( const uint8_t *buf, uint16_t len );
+   void execute( void );
+
+public:
+   SdCardStats_t stats;
+
+   SdCardSim( void );
+
+   void insert( BlockDeviceInterface *device );
+   void remove( void );
+   bool inserted( void ) { return dev != NULL; }
+
+   // one byte on the spi bus, selected is the level of the chip select
+   uint8_t transfer( uint8_t mosi, bool selected );
+};
+
+extern SdCardSim sdCardSim;
+
+#endif // __SD_CARD_SIM_H__
@@ -0,0 +1,813 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Simulation.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, virtual time and peripherals of the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include "Simulation.h"
+#include "Wire.h"
+
+// --------------------------------------------------------------------------
+// the interrupt service routines of the firmware, the ones which are not
+// linked are NULL
+// --------------------------------------------------------------------------
+
+extern "C"
+{
+   void PCINT2_vect( void ) __attribute__( ( weak ) );
+   void TIMER2_OVF_vect( void ) __attribute__( ( weak ) );
+   void TIMER1_COMPB_vect( void ) __attribute__( ( weak ) );
+   void TIMER1_OVF_vect( void ) __attribute__( ( weak ) );
+   void USART_RX_vect( void ) __attribute__( ( weak ) );
+   void ADC_vect( void ) __attribute__( ( weak ) );
+}
+
+#define SREG_I       0x80
+
+// 62.5 ns at 16MHz
+#define CPU_CYCLES_NS( cycles )  ( ( uint64_t )( cycles ) * 1000000000ULL / F_CPU )
+
+// before the static constructors of the firmware, which call pinMode()
+Simulation sim __attribute__( ( init_priority( 101 ) ) );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Simulation::Simulation( void )
+{
+   memset( pin, 0, sizeof( pin ) );
+   powerOn();
+
+   // the costs of an ATmega328P at 16MHz
+   cost.taskSwitch = 10000;               // save and restore 32 registers, the loop of the task
+   cost.isr        = 2000;                // push, pop and the vector
+   cost.reg        = 250;                 // a few cycles
+   cost.clock      = 1000;                // millis(), micros() of the core
+   cost.pin        = 4000;                // digitalWrite() with its pin tables
+   cost.spiByte    = 250;                 // loop around SPDR and SPIF
+   cost.analogRead = 112000;              // 13 adc cycles at 125kHz, prescaler 128
+
+   uartOutput = []( uint8_t c ) { fputc( c, stdout ); };
+   onReset = []( void ) { fflush( stdout ); exit( 0 ); };
+}
+
+// the time starts again at 0, the costs and callbacks are kept. The static
+// constructors of the firmware have already set the pin modes, so they are
+// kept, too.
+
+void Simulation::powerOn( void )
+{
+   now = 0;
+   sreg = 0;
+   events.clear();
+
+   memset( &t1, 0, sizeof( t1 ) );
+   memset( &t2, 0, sizeof( t2 ) );
+   memset( &adc, 0, sizeof( adc ) );
+   memset( &usart, 0, sizeof( usart ) );
+   usart.ucsra = ( 1 << UDRE0 );
+   usart.ucsrc = 0x06;                    // 8N1
+
+   pcicr = pcifr = pcmsk2 = 0;
+
+   for( uint8_t p = 0; p < NUM_DIGITAL_PINS; p++ )
+   {
+      pin[ p ].driven = false;
+      memset( &pin[ p ].scope, 0, sizeof( pin[ p ].scope ) );
+   }
+   memset( analog, 0, sizeof( analog ) );
+   i2cFrames.clear();
+
+   isrCount = 0;
+   isrNs = 0;
+}
+
+Simulation::~Simulation( void )
+{
+}
+
+// --------------------------------------------------------------------------
+// the time
+// --------------------------------------------------------------------------
+
+void Simulation::spend( uint64_t ns )
+{
+   runUntil( now + ns );
+}
+
+// ISRs may spend time, too, so this is called recursively. The interrupts
+// are disabled in an ISR, the events of the inner call only set their flags.
+
+void Simulation::runUntil( uint64_t target )
+{
+   for( ;; )
+   {
+      // the next event of the peripherals or of the inputs
+      uint64_t t = UINT64_MAX;
+      uint8_t which = 0;
+
+      if( t1.tccrb & 7 )
+      {
+         uint64_t tick = timer1Tick();
+         uint64_t k = ( now - t1.origin ) / tick;
+
+         uint64_t ovf = ( ( k >> 16 ) + 1 ) << 16;
+         if( t1.origin + ovf * tick < t )
+         {
+            t = t1.origin + ovf * tick;
+            which = 1;
+         }
+
+         uint64_t cmp = ( k & ~0xFFFFULL ) | t1.ocrb;
+         if( cmp <= k )
+            cmp += 0x10000;
+         if( t1.origin + cmp * tick < t )
+         {
+            t = t1.origin + cmp * tick;
+            which = 2;
+         }
+      }
+
+      if( t2.tccrb & 7 )
+      {
+         uint64_t tick = timer2Tick();
+         uint64_t k = ( now - t2.origin ) / tick;
+         uint64_t ovf = ( ( k >> 8 ) + 1 ) << 8;
+         if( t2.origin + ovf * tick < t )
+         {
+            t = t2.origin + ovf * tick;
+            which = 3;
+         }
+      }
+
+      if( adc.busy && adc.done < t )
+      {
+         t = adc.done;
+         which = 4;
+      }
+
+      if( !events.empty() && events.begin()->first < t )
+      {
+         t = events.begin()->first;
+         which = 5;
+      }
+
+      if( which == 0 || t > target )
+         break;
+
+      if( t > now )
+         now = t;
+
+      switch( which )
+      {
+         case 1:
+            t1.tifr |= ( 1 << TOV1 );
+            break;
+
+         case 2:
+            timer1Compare();
+            break;
+
+         case 3:
+            t2.tifr |= ( 1 << TOV2 );
+            break;
+
+         case 4:
+            adc.busy = false;
+            adc.result = adc.sample;
+            adc.adcsra |= ( 1 << ADIF );
+            // free running mode
+            if( ( adc.adcsra & ( 1 << ADATE ) ) && ( adc.adcsrb & 7 ) == 0 )
+               adcStart();
+            break;
+
+         case 5:
+         {
+            auto e = events.begin();
+            std::function< void( void ) > fn = e->second;
+            events.erase( e );
+            fn();
+         }
+         break;
+      }
+
+      dispatch();
+   }
+
+   if( target > now )
+      now = target;
+}
+
+void Simulation::at( uint64_t ns, std::function< void( void ) > fn )
+{
+   events.insert( std::make_pair( ns < now ? now : ns, fn ) );
+}
+
+// --------------------------------------------------------------------------
+// interrupts, in the order of the vector table
+// --------------------------------------------------------------------------
+
+void Simulation::dispatch( void )
+{
+   while( sreg & SREG_I )
+   {
+      void ( *isr )( void ) = NULL;
+
+      if( ( pcifr & ( 1 << PCIF2 ) ) && ( pcicr & ( 1 << PCIE2 ) ) )
+      {
+         pcifr &= ~( 1 << PCIF2 );
+         isr = PCINT2_vect;
+      }
+      else if( ( t2.tifr & ( 1 << TOV2 ) ) && ( t2.timsk & ( 1 << TOIE2 ) ) )
+      {
+         t2.tifr &= ~( 1 << TOV2 );
+         isr = TIMER2_OVF_vect;
+      }
+      else if( ( t1.tifr & ( 1 << OCF1B ) ) && ( t1.timsk & ( 1 << OCIE1B ) ) )
+      {
+         t1.tifr &= ~( 1 << OCF1B );
+         isr = TIMER1_COMPB_vect;
+      }
+      else if( ( t1.tifr & ( 1 << TOV1 ) ) && ( t1.timsk & ( 1 << TOIE1 ) ) )
+      {
+         t1.tifr &= ~( 1 << TOV1 );
+         isr = TIMER1_OVF_vect;
+      }
+      else if( usart.count && ( usart.ucsrb & ( 1 << RXCIE0 ) ) )
+      {
+         // the flag is cleared by reading UDR0, without the Uart class
+         // of the DataLogger the HardwareSerial reads it
+         isr = USART_RX_vect;
+         if( isr == NULL )
+         {
+            sreg &= ~SREG_I;
+            Serial.hostRxIsr();
+            sreg |= SREG_I;
+            continue;
+         }
+      }
+      else if( ( adc.adcsra & ( 1 << ADIF ) ) && ( adc.adcsra & ( 1 << ADIE ) ) )
+      {
+         adc.adcsra &= ~( 1 << ADIF );
+         isr = ADC_vect;
+      }
+      else if( !i2cFrames.empty() && Wire.hostActive() )
+      {
+         std::vector< uint8_t > frame = i2cFrames.front();
+         i2cFrames.pop_front();
+
+         uint64_t t0 = now;
+         sreg &= ~SREG_I;
+         Wire.hostReceive( frame.data(), frame.size() );
+         spend( cost.isr );
+         sreg |= SREG_I;
+         isrCount++;
+         isrNs += now - t0;
+         continue;
+      }
+      else
+      {
+         break;
+      }
+
+      if( isr )
+      {
+         uint64_t t0 = now;
+         sreg &= ~SREG_I;                 // the AVR disables the interrupts in an isr
+         isr();
+         spend( cost.isr );
+         sreg |= SREG_I;                  // reti
+         isrCount++;
+         isrNs += now - t0;
+      }
+   }
+}
+
+void Simulation::cli( void )
+{
+   sreg &= ~SREG_I;
+}
+
+void Simulation::sei( void )
+{
+   sreg |= SREG_I;
+   dispatch();
+}
+
+// --------------------------------------------------------------------------
+// timer 1, normal mode, the overflow and the compare match B, which
+// triggers the adc
+// --------------------------------------------------------------------------
+
+static const uint16_t timer1Prescaler[ 8 ] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+static const uint16_t timer2Prescaler[ 8 ] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+uint64_t Simulation::timer1Tick( void )
+{
+   uint16_t prescaler = timer1Prescaler[ t1.tccrb & 7 ];
+   return prescaler ? CPU_CYCLES_NS( prescaler ) : 1;
+}
+
+uint16_t Simulation::timer1Count( void )
+{
+   if( !( t1.tccrb & 7 ) )
+      return t1.stopped;
+
+   return ( uint16_t )( ( now - t1.origin ) / timer1Tick() );
+}
+
+void Simulation::timer1Compare( void )
+{
+   // the adc is triggered by the rising edge of the flag
+   if( !( t1.tifr & ( 1 << OCF1B ) )
+       && ( adc.adcsra & ( 1 << ADEN ) ) && ( adc.adcsra & ( 1 << ADATE ) )
+       && ( adc.adcsrb & 7 ) == 5 && !adc.busy )
+   {
+      adcStart();
+   }
+
+   t1.tifr |= ( 1 << OCF1B );
+}
+
+uint64_t Simulation::timer2Tick( void )
+{
+   return CPU_CYCLES_NS( timer2Prescaler[ t2.tccrb & 7 ] );
+}
+
+uint8_t Simulation::timer2Count( void )
+{
+   if( !( t2.tccrb & 7 ) )
+      return t2.stopped;
+
+   return ( uint8_t )( ( now - t2.origin ) / timer2Tick() );
+}
+
+// --------------------------------------------------------------------------
+// adc, 13 cycles of the adc clock for a conversion
+// --------------------------------------------------------------------------
+
+uint64_t Simulation::adcConversionTime( void )
+{
+   uint8_t ps = adc.adcsra & 7;
+   return CPU_CYCLES_NS( 13 * ( ps ? 1 << ps : 2 ) );
+}
+
+uint16_t Simulation::analogValue( uint8_t channel )
+{
+   uint16_t value;
+
+   if( channel >= 8 )
+      return channel == 14 ? 225 : 0;    // 1.1V reference, GND
+
+   if( analogSource )
+      value = analogSource( channel, now );
+   else
+      value = analog[ channel ];
+
+   return value > 1023 ? 1023 : value;
+}
+
+void Simulation::adcStart( void )
+{
+   adc.busy = true;
+   adc.sample = analogValue( adc.admux & 0x0F );
+   adc.done = now + adcConversionTime();
+}
+
+void Simulation::setAnalog( uint8_t channel, uint16_t value )
+{
+   if( channel < 8 )
+      analog[ channel ] = value;
+}
+
+int Simulation::analogRead( uint8_t p )
+{
+   uint8_t channel = p >= A0 ? p - A0 : p;
+   spend( cost.analogRead );
+   return analogValue( channel );
+}
+
+// --------------------------------------------------------------------------
+// usart
+// --------------------------------------------------------------------------
+
+uint64_t Simulation::uartByteTime( void )
+{
+   uint32_t divider = ( usart.ucsra & ( 1 << U2X0 ) ) ? 8 : 16;
+   uint32_t bits = 1 + 5 + ( ( usart.ucsrc >> UCSZ00 ) & 3 )
+                   + ( ( usart.ucsrc & ( 1 << UPM01 ) ) ? 1 : 0 )
+                   + ( ( usart.ucsrc & ( 1 << USBS0 ) ) ? 2 : 1 );
+
+   return CPU_CYCLES_NS( ( uint64_t )bits * divider * ( usart.ubrr + 1 ) );
+}
+
+// a byte is received completely, the stop bit is in
+void Simulation::uartReceive( uint8_t c )
+{
+   if( !( usart.ucsrb & ( 1 << RXEN0 ) ) )
+      return;
+
+   if( usart.count == sizeof( usart.fifo ) )
+   {
+      usart.overrun = true;               // the byte in the shift register is lost
+      return;
+   }
+
+   usart.fifo[ usart.count++ ] = c;
+}
+
+// the bytes follow each other without a gap at the baud rate of the usart,
+// returns the time when the last one is received
+uint64_t Simulation::uartSend( const uint8_t *data, size_t len )
+{
+   uint64_t byte_time = uartByteTime();
+   uint64_t t = usart.rxFree > now ? usart.rxFree : now;
+
+   for( size_t i = 0; i < len; i++ )
+   {
+      uint8_t c = data[ i ];
+      t += byte_time;
+      at( t, [ this, c ]( void ) { uartReceive( c ); } );
+   }
+
+   usart.rxFree = t;
+   return t;
+}
+
+// --------------------------------------------------------------------------
+// twi slave, the frame of a master
+// --------------------------------------------------------------------------
+
+void Simulation::i2cReceive( const uint8_t *data, uint8_t len )
+{
+   i2cFrames.push_back( std::vector< uint8_t >( data, data + len ) );
+   dispatch();
+}
+
+// --------------------------------------------------------------------------
+// pins
+// --------------------------------------------------------------------------
+
+uint8_t Simulation::level( uint8_t p )
+{
+   if( p >= NUM_DIGITAL_PINS )
+      return LOW;
+
+   if( pin[ p ].driven )
+      return pin[ p ].ext;
+   if( pin[ p ].mode == OUTPUT )
+      return pin[ p ].out;
+   if( pin[ p ].mode == INPUT_PULLUP )
+      return HIGH;
+   return LOW;
+}
+
+void Simulation::outputEdge( uint8_t p, uint8_t value )
+{
+   SimScope_t *s = &pin[ p ].scope;
+
+   if( value )
+   {
+      s->risingNs = now;
+   }
+   else
+   {
+      uint64_t high = now - s->risingNs;
+      s->pulses++;
+      s->highNs += high;
+      if( high > s->maxHighNs )
+         s->maxHighNs = high;
+   }
+}
+
+void Simulation::inputEdge( uint8_t p, uint8_t old_level )
+{
+   // pin change interrupt 2 for D0 .. D7
+   if( p < 8 && level( p ) != old_level && ( pcmsk2 & ( 1 << p ) ) )
+      pcifr |= ( 1 << PCIF2 );
+}
+
+void Simulation::setPin( uint8_t p, uint8_t value )
+{
+   if( p >= NUM_DIGITAL_PINS )
+      return;
+
+   uint8_t old_level = level( p );
+   pin[ p ].driven = true;
+   pin[ p ].ext = value ? HIGH : LOW;
+   inputEdge( p, old_level );
+   dispatch();
+}
+
+void Simulation::releasePin( uint8_t p )
+{
+   if( p >= NUM_DIGITAL_PINS )
+      return;
+
+   uint8_t old_level = level( p );
+   pin[ p ].driven = false;
+   inputEdge( p, old_level );
+   dispatch();
+}
+
+// a button to GND, it is released after duration
+void Simulation::press( uint8_t p, uint64_t ns, uint64_t duration )
+{
+   at( ns, [ this, p ]( void ) { setPin( p, LOW ); } );
+   at( ns + duration, [ this, p ]( void ) { releasePin( p ); } );
+}
+
+void Simulation::pinMode( uint8_t p, uint8_t mode )
+{
+   spend( cost.pin );
+   if( p < NUM_DIGITAL_PINS )
+      pin[ p ].mode = mode;
+}
+
+void Simulation::digitalWrite( uint8_t p, uint8_t value )
+{
+   spend( cost.pin );
+   if( p >= NUM_DIGITAL_PINS )
+      return;
+
+   value = value ? HIGH : LOW;
+   if( pin[ p ].mode == OUTPUT && pin[ p ].out != value )
+      outputEdge( p, value );
+   pin[ p ].out = value;
+}
+
+int Simulation::digitalRead( uint8_t p )
+{
+   spend( cost.pin );
+   return level( p );
+}
+
+const SimScope_t *Simulation::scope( uint8_t p )
+{
+   return p < NUM_DIGITAL_PINS ? &pin[ p ].scope : NULL;
+}
+
+void Simulation::printScope( FILE *out )
+{
+   for( uint8_t p = 0; p < NUM_DIGITAL_PINS; p++ )
+   {
+      SimScope_t *s = &pin[ p ].scope;
+      if( s->pulses == 0 )
+         continue;
+
+      fprintf( out, "pin %2d: %8lu pulses, high %6.2f%%, mean %8.1f us, max %8.1f us\n",
+               p, ( unsigned long )s->pulses,
+               now ? 100.0 * s->highNs / now : 0.0,
+               s->highNs / 1000.0 / s->pulses,
+               s->maxHighNs / 1000.0 );
+   }
+}
+
+// --------------------------------------------------------------------------
+// registers
+// --------------------------------------------------------------------------
+
+uint16_t Simulation::read( uint8_t reg )
+{
+   spend( cost.reg );
+
+   switch( reg )
+   {
+      case REG_SREG:    return sreg;
+
+      case REG_TCCR1A:  return t1.tccra;
+      case REG_TCCR1B:  return t1.tccrb;
+      case REG_TCNT1:   return timer1Count();
+      case REG_OCR1B:   return t1.ocrb;
+      case REG_TIMSK1:  return t1.timsk;
+      case REG_TIFR1:   return t1.tifr;
+
+      case REG_TCCR2A:  return t2.tccra;
+      case REG_TCCR2B:  return t2.tccrb;
+      case REG_TCNT2:   return timer2Count();
+      case REG_TIMSK2:  return t2.timsk;
+      case REG_TIFR2:   return t2.tifr;
+
+      case REG_ADMUX:   return adc.admux;
+      case REG_ADCSRA:  return adc.adcsra | ( adc.busy ? ( 1 << ADSC ) : 0 );
+      case REG_ADCSRB:  return adc.adcsrb;
+      case REG_ADC:     return adc.result;
+      case REG_DIDR0:   return adc.didr;
+
+      case REG_UCSR0A:
+      {
+         uint64_t byte_time = uartByteTime();
+         uint8_t flags = usart.ucsra & ( 1 << U2X0 );
+
+         if( usart.count )
+            flags |= ( 1 << RXC0 );
+         if( usart.overrun )
+            flags |= ( 1 << DOR0 );
+         if( now + byte_time >= usart.txDone )
+            flags |= ( 1 << UDRE0 );      // at most one byte in the shift register
+         if( now >= usart.txDone )
+            flags |= ( 1 << TXC0 );
+         return flags;
+      }
+      case REG_UCSR0B:  return usart.ucsrb;
+      case REG_UCSR0C:  return usart.ucsrc;
+      case REG_UBRR0:   return usart.ubrr;
+      case REG_UDR0:
+      {
+         if( usart.count == 0 )
+            return 0;
+
+         uint8_t c = usart.fifo[ 0 ];
+         usart.fifo[ 0 ] = usart.fifo[ 1 ];
+         usart.count--;
+         usart.overrun = false;
+         return c;
+      }
+
+      case REG_PIND:
+      {
+         uint8_t value = 0;
+         for( uint8_t p = 0; p < 8; p++ )
+            value |= level( p ) << p;
+         return value;
+      }
+      case REG_PCICR:   return pcicr;
+      case REG_PCIFR:   return pcifr;
+      case REG_PCMSK2:  return pcmsk2;
+   }
+
+   return 0;
+}
+
+void Simulation::write( uint8_t reg, uint16_t value )
+{
+   spend( cost.reg );
+
+   switch( reg )
+   {
+      case REG_SREG:
+         sreg = value;
+         dispatch();
+         break;
+
+      case REG_TCCR1A:
+         t1.tccra = value;
+         break;
+
+      case REG_TCCR1B:
+      {
+         uint16_t count = timer1Count();
+         t1.tccrb = value;
+         t1.stopped = count;
+         t1.origin = ( int64_t )now - ( int64_t )count * timer1Tick();
+      }
+      break;
+
+      case REG_TCNT1:
+         t1.stopped = value;
+         t1.origin = ( int64_t )now - ( int64_t )value * timer1Tick();
+         break;
+
+      case REG_OCR1B:   t1.ocrb = value; break;
+      case REG_TIMSK1:  t1.timsk = value; dispatch(); break;
+      case REG_TIFR1:   t1.tifr &= ~value; break;        // a one clears the flag
+
+      case REG_TCCR2A:
+         t2.tccra = value;
+         break;
+
+      case REG_TCCR2B:
+      {
+         uint8_t count = timer2Count();
+         t2.tccrb = value;
+         t2.stopped = count;
+         t2.origin = ( int64_t )now - ( int64_t )count * timer2Tick();
+      }
+      break;
+
+      case REG_TCNT2:
+         t2.stopped = value;
+         t2.origin = ( int64_t )now - ( int64_t )value * timer2Tick();
+         break;
+
+      case REG_TIMSK2:  t2.timsk = value; dispatch(); break;
+      case REG_TIFR2:   t2.tifr &= ~value; break;
+
+      case REG_ADMUX:   adc.admux = value; break;
+      case REG_ADCSRA:
+      {
+         uint8_t flag = adc.adcsra & ( 1 << ADIF );
+         if( value & ( 1 << ADIF ) )
+            flag = 0;                     // a one clears the flag
+
+         adc.adcsra = ( value & ~( ( 1 << ADIF ) | ( 1 << ADSC ) ) ) | flag;
+
+         if( ( value & ( 1 << ADSC ) ) && ( value & ( 1 << ADEN ) ) && !adc.busy )
+            adcStart();
+         dispatch();
+      }
+      break;
+      case REG_ADCSRB:  adc.adcsrb = value; break;
+      case REG_DIDR0:   adc.didr = value; break;
+
+      case REG_UCSR0A:
+         usart.ucsra = value & ( 1 << U2X0 );
+         break;
+      case REG_UCSR0B:
+         usart.ucsrb = value;
+         if( !( value & ( 1 << RXEN0 ) ) )
+         {
+            usart.count = 0;
+            usart.overrun = false;
+         }
+         dispatch();
+         break;
+      case REG_UCSR0C:  usart.ucsrc = value; break;
+      case REG_UBRR0:   usart.ubrr = value & 0x0FFF; break;
+      case REG_UDR0:
+         if( usart.ucsrb & ( 1 << TXEN0 ) )
+         {
+            uint64_t byte_time = uartByteTime();
+            usart.txDone = ( usart.txDone > now ? usart.txDone : now ) + byte_time;
+            if( uartOutput )
+               uartOutput( value );
+         }
+         break;
+
+      case REG_PIND:
+         break;
+      case REG_PCICR:   pcicr = value; dispatch(); break;
+      case REG_PCIFR:   pcifr &= ~value; break;
+      case REG_PCMSK2:  pcmsk2 = value; break;
+   }
+}
+
+void Simulation::reset( void )
+{
+   if( onReset )
+      onReset();
+}
+
+// --------------------------------------------------------------------------
+// the entries for WArduino.h and picoOS
+// --------------------------------------------------------------------------
+
+uint16_t hostRegRead( uint8_t reg )
+{
+   return sim.read( reg );
+}
+
+void hostRegWrite( uint8_t reg, uint16_t value )
+{
+   sim.write( reg, value );
+}
+
+extern "C" void cli( void )
+{
+   sim.cli();
+}
+
+extern "C" void sei( void )
+{
+   sim.sei();
+}
+
+extern "C" void posHostTaskSwitch( void )
+{
+   sim.spend( sim.cost.taskSwitch );
+}
@@ -0,0 +1,217 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, virtual time and peripherals of the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __SIMULATION_H__
+#define __SIMULATION_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "WArduino.h"
+
+// --------------------------------------------------------------------------
+// The simulation of the ATmega328P for the host build.
+//
+// The time is a virtual time in ns, it only advances when the firmware
+// spends it: a task switch, a register access, an Arduino call, a byte on
+// the spi bus, ... each has a fixed cost, see SimCost_t. So a run is
+// deterministic, the same inputs give the same records at the same times.
+//
+// While the time advances, the peripherals run: timer 1 with its overflow
+// and compare match B, timer 2, the adc with its auto trigger, the usart,
+// the pin change interrupts and the twi slave. Their interrupt service
+// routines are called, when the interrupts are enabled, in the order of the
+// vector table of the AVR.
+//
+// The inputs are scheduled with at(), or sent with uartSend(), ...
+// --------------------------------------------------------------------------
+
+#define SIM_NS_PER_US         1000ULL
+#define SIM_NS_PER_MS         1000000ULL
+#define SIM_NS_PER_S          1000000000ULL
+
+typedef struct
+{
+   uint32_t taskSwitch;       // ns, picoOS task switch
+   uint32_t isr;              // ns, entry and exit of an interrupt service routine
+   uint32_t reg;              // ns, one register access, polling loops advance with it
+   uint32_t clock;            // ns, millis(), micros()
+   uint32_t pin;              // ns, pinMode(), digitalRead(), digitalWrite()
+   uint32_t spiByte;          // ns, software overhead of a byte on the spi bus
+   uint32_t analogRead;       // ns, analogRead() of the Arduino core
+} SimCost_t;
+
+typedef struct
+{
+   uint32_t pulses;           // number of high pulses of an output pin
+   uint64_t highNs;           // sum of the high times
+   uint64_t maxHighNs;        // longest high pulse
+   uint64_t risingNs;         // time of the last rising edge
+} SimScope_t;
+
+class Simulation
+{
+private:
+   uint64_t now;                          // ns since power on
+   std::multimap< uint64_t, std::function< void( void ) > > events;
+
+   uint8_t  sreg;
+
+   struct
+   {
+      uint8_t  tccra, tccrb, timsk, tifr;
+      uint16_t ocrb;
+      uint16_t stopped;                   // count while the timer is stopped
+      int64_t  origin;                    // ns, when the count was 0
+   } t1;
+
+   struct
+   {
+      uint8_t  tccra, tccrb, timsk, tifr;
+      uint8_t  stopped;
+      int64_t  origin;
+   } t2;
+
+   struct
+   {
+      uint8_t  admux, adcsra, adcsrb, didr;
+      uint16_t result;
+      uint16_t sample;                    // sampled at the start of the conversion
+      bool     busy;
+      uint64_t done;                      // ns, end of the conversion
+   } adc;
+
+   struct
+   {
+      uint8_t  ucsra, ucsrb, ucsrc;
+      uint16_t ubrr;
+      uint8_t  fifo[ 2 ];                 // receive buffer of the usart
+      uint8_t  count;
+      bool     overrun;
+      uint64_t txDone;                    // ns, the last transmitted byte is out
+      uint64_t rxFree;                    // ns, end of the bytes sent with uartSend()
+   } usart;
+
+   uint8_t  pcicr, pcifr, pcmsk2;
+
+   struct
+   {
+      uint8_t  mode;                      // INPUT, OUTPUT, INPUT_PULLUP
+      uint8_t  out;                       // level written by the firmware
+      uint8_t  ext;                       // level of the external driver
+      bool     driven;                    // an external driver is connected
+      SimScope_t scope;
+   } pin[ NUM_DIGITAL_PINS ];
+
+   uint16_t analog[ 8 ];
+
+   std::deque< std::vector< uint8_t > > i2cFrames;
+
+   uint64_t timer1Tick( void );
+   uint64_t timer2Tick( void );
+   uint16_t timer1Count( void );
+   uint8_t  timer2Count( void );
+   uint64_t adcConversionTime( void );
+   uint64_t uartByteTime( void );
+   uint16_t analogValue( uint8_t channel );
+
+   void adcStart( void );
+   void timer1Compare( void );
+   void outputEdge( uint8_t p, uint8_t value );
+   void inputEdge( uint8_t p, uint8_t old_level );
+   void dispatch( void );
+
+public:
+   SimCost_t cost;
+
+   // input of the adc, instead of the constant values of setAnalog()
+   std::function< uint16_t( uint8_t channel, uint64_t ns ) > analogSource;
+
+   // the bytes which the firmware transmits on the usart, default is stdout
+   std::function< void( uint8_t c ) > uartOutput;
+
+   // a watchdog reset, default is to end the program
+   std::function< void( void ) > onReset;
+
+   uint64_t isrCount;                     // interrupt service routines called
+   uint64_t isrNs;                        // ns, spent in them
+
+   Simulation( void );
+   ~Simulation( void );
+
+   uint64_t nanos( void ) { return now; }
+
+   // the reset state of the ATmega328P
+   void powerOn( void );
+
+   // the cpu is busy for ns, the peripherals run, the isrs are called
+   void spend( uint64_t ns );
+   void runUntil( uint64_t ns );
+
+   // call fn at the time ns, as a hardware event
+   void at( uint64_t ns, std::function< void( void ) > fn );
+
+   // the inputs
+   void setPin( uint8_t p, uint8_t value );
+   void releasePin( uint8_t p );
+   uint8_t level( uint8_t p );
+   void press( uint8_t p, uint64_t ns, uint64_t duration );
+   void setAnalog( uint8_t channel, uint16_t value );
+   void uartReceive( uint8_t c );
+   uint64_t uartSend( const uint8_t *data, size_t len );
+   void i2cReceive( const uint8_t *data, uint8_t len );
+
+   // the firmware side
+   uint16_t read( uint8_t reg );
+   void write( uint8_t reg, uint16_t value );
+   void cli( void );
+   void sei( void );
+   void pinMode( uint8_t p, uint8_t mode );
+   void digitalWrite( uint8_t p, uint8_t value );
+   int  digitalRead( uint8_t p );
+   int  analogRead( uint8_t p );
+   void reset( void );
+
+   // high times of the output pins, like an oscilloscope on the OSZI_* pins
+   const SimScope_t *scope( uint8_t p );
+   void printScope( FILE *out );
+};
+
+extern Simulation sim;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __SIMULATION_H__
@@ -0,0 +1,317 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          WArduino.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, Arduino core on the simulation
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include "WArduino.h"
+#include "Simulation.h"
+
+// --------------------------------------------------------------------------
+// time
+// --------------------------------------------------------------------------
+
+extern "C" unsigned long millis( void )
+{
+   sim.spend( sim.cost.clock );
+   return ( unsigned long )( uint32_t )( sim.nanos() / SIM_NS_PER_MS );
+}
+
+extern "C" unsigned long micros( void )
+{
+   sim.spend( sim.cost.clock );
+   return ( unsigned long )( uint32_t )( sim.nanos() / SIM_NS_PER_US );
+}
+
+// like the core, the other tasks run while waiting
+extern "C" void delay( unsigned long ms )
+{
+   uint64_t end = sim.nanos() + ms * SIM_NS_PER_MS;
+
+   while( sim.nanos() < end )
+      yield();
+}
+
+extern "C" void delayMicroseconds( unsigned int us )
+{
+   sim.spend( us * SIM_NS_PER_US );
+}
+
+// --------------------------------------------------------------------------
+// pins
+// --------------------------------------------------------------------------
+
+extern "C" void pinMode( uint8_t pin, uint8_t mode )
+{
+   sim.pinMode( pin, mode );
+}
+
+extern "C" void digitalWrite( uint8_t pin, uint8_t val )
+{
+   sim.digitalWrite( pin, val );
+}
+
+extern "C" int digitalRead( uint8_t pin )
+{
+   return sim.digitalRead( pin );
+}
+
+extern "C" int analogRead( uint8_t pin )
+{
+   return sim.analogRead( pin );
+}
+
+// --------------------------------------------------------------------------
+// watchdog
+// --------------------------------------------------------------------------
+
+// the firmware enables the watchdog and waits for the reset
+void wdt_enable( uint8_t timeout )
+{
+   ( void )timeout;
+   sim.spend( 15 * SIM_NS_PER_MS );
+   sim.reset();
+}
+
+// --------------------------------------------------------------------------
+// avr-libc
+// --------------------------------------------------------------------------
+
+extern "C" char *ultoa( unsigned long value, char *buf, int radix )
+{
+   char tmp[ 8 * sizeof( value ) + 1 ];
+   char *p = &tmp[ sizeof( tmp ) - 1 ];
+
+   *p = '\0';
+   do
+   {
+      uint8_t digit = value % radix;
+      *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+      value /= radix;
+   } while( value );
+
+   return strcpy( buf, p );
+}
+
+extern "C" char *utoa( unsigned int value, char *buf, int radix )
+{
+   return ultoa( value, buf, radix );
+}
+
+extern "C" char *ltoa( long value, char *buf, int radix )
+{
+   if( value < 0 && radix == 10 )
+   {
+      buf[ 0 ] = '-';
+      ultoa( -( unsigned long )value, &buf[ 1 ], radix );
+      return buf;
+   }
+
+   return ultoa( ( unsigned long )value, buf, radix );
+}
+
+extern "C" char *itoa( int value, char *buf, int radix )
+{
+   if( value < 0 && radix == 10 )
+      return ltoa( value, buf, radix );
+
+   return ultoa( ( unsigned int )value, buf, radix );
+}
+
+// --------------------------------------------------------------------------
+// String
+// --------------------------------------------------------------------------
+
+String::String( const char *str )
+{
+   buffer = strdup( str ? str : "" );
+}
+
+String::String( const String &str )
+{
+   buffer = strdup( str.buffer );
+}
+
+String::~String( void )
+{
+   free( buffer );
+}
+
+String &String::operator=( const String &str )
+{
+   if( this != &str )
+   {
+      free( buffer );
+      buffer = strdup( str.buffer );
+   }
+   return *this;
+}
+
+// --------------------------------------------------------------------------
+// Print, Stream
+// --------------------------------------------------------------------------
+
+size_t Print::write( const uint8_t *buffer, size_t size )
+{
+   size_t n = 0;
+
+   while( size-- )
+   {
+      if( write( *buffer++ ) == 0 )
+         break;
+      n++;
+   }
+   return n;
+}
+
+size_t Print::print( long value, int base )
+{
+   char buf[ 8 * sizeof( long ) + 2 ];
+
+   if( base == DEC )
+      return write( ltoa( value, buf, base ) );
+
+   return write( ultoa( ( unsigned long )value, buf, base ) );
+}
+
+size_t Print::print( unsigned long value, int base )
+{
+   char buf[ 8 * sizeof( long ) + 1 ];
+
+   return write( ultoa( value, buf, base ) );
+}
+
+size_t Print::print( double value, int digits )
+{
+   char buf[ 32 ];
+
+   snprintf( buf, sizeof( buf ), "%.*f", digits, value );
+   return write( buf );
+}
+
+size_t Stream::readBytes( char *buffer, size_t length )
+{
+   size_t n = 0;
+   unsigned long start = millis();
+
+   while( n < length )
+   {
+      int c = read();
+      if( c < 0 )
+      {
+         if( millis() - start >= timeout )
+            break;
+         yield();
+         continue;
+      }
+      buffer[ n++ ] = ( char )c;
+   }
+   return n;
+}
+
+// --------------------------------------------------------------------------
+// HardwareSerial on the usart, like the core with interrupts
+// --------------------------------------------------------------------------
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin( unsigned long baud, uint8_t config )
+{
+   uint16_t baud_setting = ( F_CPU / 4 / baud - 1 ) / 2;
+
+   rxHead = rxTail = 0;
+   UCSR0A = ( 1 << U2X0 );
+   UBRR0 = baud_setting;
+   UCSR0C = config;
+   UCSR0B = ( 1 << RXEN0 ) | ( 1 << TXEN0 ) | ( 1 << RXCIE0 );
+}
+
+void HardwareSerial::end( void )
+{
+   flush();
+   UCSR0B = 0;
+   rxHead = rxTail = 0;
+}
+
+int HardwareSerial::available( void )
+{
+   return ( uint8_t )( rxHead - rxTail ) % sizeof( rxBuf );
+}
+
+int HardwareSerial::peek( void )
+{
+   if( rxHead == rxTail )
+      return -1;
+   return rxBuf[ rxTail ];
+}
+
+int HardwareSerial::read( void )
+{
+   if( rxHead == rxTail )
+      return -1;
+
+   uint8_t c = rxBuf[ rxTail ];
+   rxTail = ( rxTail + 1 ) % sizeof( rxBuf );
+   return c;
+}
+
+size_t HardwareSerial::write( uint8_t c )
+{
+   while( !( UCSR0A & ( 1 << UDRE0 ) ) )
+      ;
+   UDR0 = c;
+   return 1;
+}
+
+void HardwareSerial::flush( void )
+{
+   while( !( UCSR0A & ( 1 << TXC0 ) ) && ( UCSR0B & ( 1 << TXEN0 ) ) )
+      ;
+}
+
+// USART_RX_vect of the core
+void HardwareSerial::hostRxIsr( void )
+{
+   uint8_t c = UDR0;
+   uint8_t next = ( rxHead + 1 ) % sizeof( rxBuf );
+
+   if( next != rxTail )
+   {
+      rxBuf[ rxHead ] = c;
+      rxHead = next;
+   }
+}
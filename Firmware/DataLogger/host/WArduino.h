@@ -0,0 +1,407 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, Arduino api of the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __WARDUINO_H__
+#define __WARDUINO_H__
+
+// --------------------------------------------------------------------------
+// the part of the Arduino api and of the ATmega328P registers which the
+// DataLogger uses, for the build on a Linux host. The sources include this
+// file in their #else branch of #ifdef ARDUINO. The time is a virtual time
+// of the simulation, see Simulation.h, the registers are served by the
+// simulated peripherals.
+// --------------------------------------------------------------------------
+
+#ifndef WARDUINO
+   #define WARDUINO
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+
+#ifndef F_CPU
+   #define F_CPU              16000000UL
+#endif
+
+#define __AVR_LIBC_VERSION_STRING__    "host"
+
+typedef bool      boolean;
+typedef uint8_t   byte;
+typedef uint16_t  word;
+
+#define HIGH               0x1
+#define LOW                0x0
+
+#define INPUT              0x0
+#define OUTPUT             0x1
+#define INPUT_PULLUP       0x2
+
+#define DEC                10
+#define HEX                16
+#define OCT                8
+#define BIN                2
+
+// pins of the Arduino Uno
+#define NUM_DIGITAL_PINS   20
+#define NUM_ANALOG_INPUTS  6
+
+#define LED_BUILTIN        13
+#define SS                 10
+#define MOSI               11
+#define MISO               12
+#define SCK                13
+
+#define A0                 14
+#define A1                 15
+#define A2                 16
+#define A3                 17
+#define A4                 18
+#define A5                 19
+
+#define _BV( bit )         ( 1 << ( bit ) )
+
+// --------------------------------------------------------------------------
+// program memory, the host has only one address space
+// --------------------------------------------------------------------------
+
+#define PROGMEM
+#define PGM_P              const char *
+#define PSTR( s )          ( s )
+
+class __FlashStringHelper;
+#define F( string_literal )   ( reinterpret_cast< const __FlashStringHelper * >( PSTR( string_literal ) ) )
+
+#define pgm_read_byte( addr )    ( *( const uint8_t * )( addr ) )
+#define pgm_read_word( addr )    ( *( const uint16_t * )( addr ) )
+#define pgm_read_dword( addr )   ( *( const uint32_t * )( addr ) )
+// like avr-libc pgm_read_ptr() yields a void *, callers cast to the pointer type
+#define pgm_read_ptr( addr )     ( *( void * const * )( addr ) )
+
+#define strcpy_P           strcpy
+#define strncpy_P          strncpy
+#define strlen_P           strlen
+#define strcmp_P           strcmp
+#define strncmp_P          strncmp
+#define strcasecmp_P       strcasecmp
+#define strncasecmp_P      strncasecmp
+#define memcpy_P           memcpy
+#define sprintf_P          sprintf
+#define snprintf_P         snprintf
+#define vsnprintf_P        vsnprintf
+#define printf_P           printf
+
+// --------------------------------------------------------------------------
+// the functions of the Arduino core
+// --------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned long millis( void );
+unsigned long micros( void );
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+
+void pinMode( uint8_t pin, uint8_t mode );
+void digitalWrite( uint8_t pin, uint8_t val );
+int digitalRead( uint8_t pin );
+int analogRead( uint8_t pin );
+
+void cli( void );
+void sei( void );
+
+// avr-libc, not in the c library of the host
+char *itoa( int value, char *buf, int radix );
+char *ltoa( long value, char *buf, int radix );
+char *utoa( unsigned int value, char *buf, int radix );
+char *ultoa( unsigned long value, char *buf, int radix );
+
+#ifdef __cplusplus
+}
+#endif
+
+// the sketch
+void setup( void );
+void loop( void );
+
+#define noInterrupts()     cli()
+#define interrupts()       sei()
+
+// the vectors are functions, which the simulation calls
+#define ISR( vector, ... ) extern "C" void vector( void ); extern "C" void vector( void )
+
+// --------------------------------------------------------------------------
+// registers of the ATmega328P, each access is a call into the simulation
+// --------------------------------------------------------------------------
+
+enum HostRegister_t : uint8_t
+{
+   REG_SREG,
+   REG_TCCR1A, REG_TCCR1B, REG_TCNT1, REG_OCR1B, REG_TIMSK1, REG_TIFR1,
+   REG_TCCR2A, REG_TCCR2B, REG_TCNT2, REG_TIMSK2, REG_TIFR2,
+   REG_ADMUX, REG_ADCSRA, REG_ADCSRB, REG_ADC, REG_DIDR0,
+   REG_UCSR0A, REG_UCSR0B, REG_UCSR0C, REG_UBRR0, REG_UDR0,
+   REG_PIND, REG_PCICR, REG_PCIFR, REG_PCMSK2,
+   REG_NUM
+};
+
+uint16_t hostRegRead( uint8_t reg );
+void hostRegWrite( uint8_t reg, uint16_t value );
+
+template< typename T, uint8_t REG >
+class HostRegister
+{
+public:
+   operator T() const { return ( T )hostRegRead( REG ); }
+   HostRegister &operator=( T value ) { hostRegWrite( REG, value ); return *this; }
+   HostRegister &operator|=( T value ) { hostRegWrite( REG, ( T )( *this | value ) ); return *this; }
+   HostRegister &operator&=( T value ) { hostRegWrite( REG, ( T )( *this & value ) ); return *this; }
+   HostRegister &operator^=( T value ) { hostRegWrite( REG, ( T )( *this ^ value ) ); return *this; }
+   HostRegister &operator+=( T value ) { hostRegWrite( REG, ( T )( *this + value ) ); return *this; }
+   HostRegister &operator-=( T value ) { hostRegWrite( REG, ( T )( *this - value ) ); return *this; }
+};
+
+#define SREG      ( HostRegister< uint8_t, REG_SREG   >{} )
+#define TCCR1A    ( HostRegister< uint8_t, REG_TCCR1A >{} )
+#define TCCR1B    ( HostRegister< uint8_t, REG_TCCR1B >{} )
+#define TCNT1     ( HostRegister< uint16_t, REG_TCNT1  >{} )
+#define OCR1B     ( HostRegister< uint16_t, REG_OCR1B  >{} )
+#define TIMSK1    ( HostRegister< uint8_t, REG_TIMSK1 >{} )
+#define TIFR1     ( HostRegister< uint8_t, REG_TIFR1  >{} )
+#define TCCR2A    ( HostRegister< uint8_t, REG_TCCR2A >{} )
+#define TCCR2B    ( HostRegister< uint8_t, REG_TCCR2B >{} )
+#define TCNT2     ( HostRegister< uint8_t, REG_TCNT2  >{} )
+#define TIMSK2    ( HostRegister< uint8_t, REG_TIMSK2 >{} )
+#define TIFR2     ( HostRegister< uint8_t, REG_TIFR2  >{} )
+#define ADMUX     ( HostRegister< uint8_t, REG_ADMUX  >{} )
+#define ADCSRA    ( HostRegister< uint8_t, REG_ADCSRA >{} )
+#define ADCSRB    ( HostRegister< uint8_t, REG_ADCSRB >{} )
+#define ADC       ( HostRegister< uint16_t, REG_ADC    >{} )
+#define DIDR0     ( HostRegister< uint8_t, REG_DIDR0  >{} )
+#define UCSR0A    ( HostRegister< uint8_t, REG_UCSR0A >{} )
+#define UCSR0B    ( HostRegister< uint8_t, REG_UCSR0B >{} )
+#define UCSR0C    ( HostRegister< uint8_t, REG_UCSR0C >{} )
+#define UBRR0     ( HostRegister< uint16_t, REG_UBRR0  >{} )
+#define UDR0      ( HostRegister< uint8_t, REG_UDR0   >{} )
+#define PIND      ( HostRegister< uint8_t, REG_PIND   >{} )
+#define PCICR     ( HostRegister< uint8_t, REG_PCICR  >{} )
+#define PCIFR     ( HostRegister< uint8_t, REG_PCIFR  >{} )
+#define PCMSK2    ( HostRegister< uint8_t, REG_PCMSK2 >{} )
+
+// the stack pointer is only printed, the lower 16 bit of the host stack
+#define SP        ( ( uint16_t )( uintptr_t )__builtin_frame_address( 0 ) )
+
+// bits of the registers
+#define CS10      0
+#define CS11      1
+#define CS12      2
+#define TOIE1     0
+#define OCIE1B    2
+#define TOV1      0
+#define OCF1B     2
+#define TOIE2     0
+#define TOV2      0
+
+#define REFS0     6
+#define ADEN      7
+#define ADSC      6
+#define ADATE     5
+#define ADIF      4
+#define ADIE      3
+#define ADPS2     2
+#define ADPS1     1
+#define ADPS0     0
+#define ADTS2     2
+#define ADTS1     1
+#define ADTS0     0
+
+#define RXC0      7
+#define TXC0      6
+#define UDRE0     5
+#define FE0       4
+#define DOR0      3
+#define UPE0      2
+#define U2X0      1
+#define RXCIE0    7
+#define TXCIE0    6
+#define UDRIE0    5
+#define RXEN0     4
+#define TXEN0     3
+#define UPM01     5
+#define UPM00     4
+#define USBS0     3
+#define UCSZ01    2
+#define UCSZ00    1
+
+#define PCIE2     2
+#define PCIF2     2
+
+#define PD0       0
+#define PD1       1
+#define PD2       2
+#define PD3       3
+#define PD4       4
+#define PD5       5
+#define PD6       6
+#define PD7       7
+
+// --------------------------------------------------------------------------
+// watchdog, a reset ends the host program
+// --------------------------------------------------------------------------
+
+#define WDTO_15MS    0
+
+void wdt_enable( uint8_t timeout );
+#define wdt_reset()
+#define wdt_disable()
+
+// --------------------------------------------------------------------------
+// Print, Stream and a small String, enough for SdFat and the logs
+// --------------------------------------------------------------------------
+
+class String
+{
+private:
+   char *buffer;
+
+public:
+   String( const char *str = "" );
+   String( const String &str );
+   ~String( void );
+
+   String &operator=( const String &str );
+   const char *c_str( void ) const { return buffer; }
+   unsigned int length( void ) const { return strlen( buffer ); }
+};
+
+class Print
+{
+private:
+   int writeError = 0;
+
+public:
+   virtual ~Print( void ) {}
+
+   int getWriteError( void ) { return writeError; }
+   void clearWriteError( void ) { writeError = 0; }
+
+   virtual size_t write( uint8_t c ) = 0;
+   virtual size_t write( const uint8_t *buffer, size_t size );
+   size_t write( const char *str ) { return str ? write( ( const uint8_t * )str, strlen( str ) ) : 0; }
+   size_t write( const char *buffer, size_t size ) { return write( ( const uint8_t * )buffer, size ); }
+   virtual int availableForWrite( void ) { return 0; }
+   virtual void flush( void ) {}
+
+protected:
+   void setWriteError( int err = 1 ) { writeError = err; }
+
+public:
+   size_t print( const __FlashStringHelper *str ) { return write( ( const char * )str ); }
+   size_t print( const String &str ) { return write( str.c_str() ); }
+   size_t print( const char *str ) { return write( str ); }
+   size_t print( char c ) { return write( ( uint8_t )c ); }
+   size_t print( unsigned char value, int base = DEC ) { return print( ( unsigned long )value, base ); }
+   size_t print( int value, int base = DEC ) { return print( ( long )value, base ); }
+   size_t print( unsigned int value, int base = DEC ) { return print( ( unsigned long )value, base ); }
+   size_t print( long value, int base = DEC );
+   size_t print( unsigned long value, int base = DEC );
+   size_t print( long long value, int base = DEC ) { return print( ( long )value, base ); }
+   size_t print( unsigned long long value, int base = DEC ) { return print( ( unsigned long )value, base ); }
+   size_t print( double value, int digits = 2 );
+
+   size_t println( void ) { return write( "\r\n" ); }
+   template< typename T > size_t println( T value ) { size_t n = print( value ); return n + println(); }
+   template< typename T > size_t println( T value, int base ) { size_t n = print( value, base ); return n + println(); }
+};
+
+class Stream : public Print
+{
+protected:
+   unsigned long timeout = 1000;          // ms, of readBytes()
+
+public:
+   virtual int available( void ) = 0;
+   virtual int read( void ) = 0;
+   virtual int peek( void ) = 0;
+
+   void setTimeout( unsigned long ms ) { timeout = ms; }
+   size_t readBytes( char *buffer, size_t length );
+   size_t readBytes( uint8_t *buffer, size_t length ) { return readBytes( ( char * )buffer, length ); }
+};
+
+// --------------------------------------------------------------------------
+// the usart of the Arduino core, the DataLogger uses its own Uart class
+// with USE_UART_ISR, both work on the simulated usart
+// --------------------------------------------------------------------------
+
+#define SERIAL_8N1   0x06
+
+class HardwareSerial : public Stream
+{
+private:
+   uint8_t rxBuf[ 64 ];
+   volatile uint8_t rxHead;
+   volatile uint8_t rxTail;
+
+public:
+   void begin( unsigned long baud, uint8_t config = SERIAL_8N1 );
+   void end( void );
+
+   virtual int available( void );
+   virtual int read( void );
+   virtual int peek( void );
+   virtual size_t write( uint8_t c );
+   using Print::write;
+   virtual void flush( void );
+   operator bool() { return true; }
+
+   void hostRxIsr( void );
+};
+
+extern HardwareSerial Serial;
+
+// --------------------------------------------------------------------------
+// picoOS runs with its host port
+// --------------------------------------------------------------------------
+
+#include "picoOS/picoOS.h"
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __WARDUINO_H__
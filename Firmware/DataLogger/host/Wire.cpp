@@ -0,0 +1,125 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Wire.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, twi slave of the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+TwoWire::TwoWire( void )
+{
+   rxIndex = 0;
+   rxLength = 0;
+   address = 0;
+   onReceiveHandler = NULL;
+}
+
+void TwoWire::begin( void )
+{
+   address = 0;                           // master, nothing is received
+}
+
+void TwoWire::begin( uint8_t slave_address )
+{
+   address = slave_address;
+   rxIndex = 0;
+   rxLength = 0;
+}
+
+void TwoWire::end( void )
+{
+   address = 0;
+}
+
+void TwoWire::onReceive( void ( *handler )( int ) )
+{
+   onReceiveHandler = handler;
+}
+
+int TwoWire::available( void )
+{
+   return rxLength - rxIndex;
+}
+
+int TwoWire::read( void )
+{
+   if( rxIndex >= rxLength )
+      return -1;
+   return rxBuf[ rxIndex++ ];
+}
+
+int TwoWire::peek( void )
+{
+   if( rxIndex >= rxLength )
+      return -1;
+   return rxBuf[ rxIndex ];
+}
+
+size_t TwoWire::write( uint8_t c )
+{
+   ( void )c;                             // no master transmissions
+   return 0;
+}
+
+// --------------------------------------------------------------------------
+// like twi.c, the frame is copied into the buffer, then the handler runs
+// in the interrupt
+// --------------------------------------------------------------------------
+
+bool TwoWire::hostActive( void )
+{
+   return address != 0;
+}
+
+void TwoWire::hostReceive( const uint8_t *data, size_t len )
+{
+   if( len > BUFFER_LENGTH )
+      len = BUFFER_LENGTH;
+
+   memcpy( rxBuf, data, len );
+   rxIndex = 0;
+   rxLength = len;
+
+   if( onReceiveHandler )
+      onReceiveHandler( len );
+}
@@ -0,0 +1,74 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, twi slave of the host build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __HOST_WIRE_H__
+#define __HOST_WIRE_H__
+
+#include "WArduino.h"
+
+// --------------------------------------------------------------------------
+// the slave part of the Wire library, the frames of the master come from
+// Simulation::i2cReceive()
+// --------------------------------------------------------------------------
+
+#define BUFFER_LENGTH      32
+
+class TwoWire : public Stream
+{
+private:
+   uint8_t rxBuf[ BUFFER_LENGTH ];
+   uint8_t rxIndex;
+   uint8_t rxLength;
+   uint8_t address;                       // own slave address, 0 if not a slave
+   void ( *onReceiveHandler )( int );
+
+public:
+   TwoWire( void );
+
+   void begin( void );
+   void begin( uint8_t address );
+   void end( void );
+   void onReceive( void ( *handler )( int ) );
+
+   virtual int available( void );
+   virtual int read( void );
+   virtual int peek( void );
+   virtual size_t write( uint8_t c );
+   using Print::write;
+
+   // called by the simulation in the twi interrupt
+   bool hostActive( void );
+   void hostReceive( const uint8_t *data, size_t len );
+};
+
+extern TwoWire Wire;
+
+#endif // __HOST_WIRE_H__
@@ -0,0 +1,770 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          bench.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   lost pin changes from the trailer
+// 2026-10-18  AWe   dropped samples of the firmware, also of the full ring buffer
+// 2026-10-18  AWe   the capture up to the start with HostCapture.cpp
+// 2026-10-18  AWe   initial version, capture throughput benchmark
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <unistd.h>
+#include <getopt.h>
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "WArduino.h"
+#include "Simulation.h"
+#include "SdCardSim.h"
+#include "ImageBlockDevice.h"
+#include "HostCard.h"
+#include "HostCapture.h"
+
+#include "DataLogger_config.h"
+#include "DataLogger.h"                // flags
+#include "Capture.h"
+#include "Record.h"
+
+extern Capture capture;
+
+// --------------------------------------------------------------------------
+// Throughput of the capture, end to end.
+//
+// Each run of the sweep drives Capture::setup(), start(), run() and stop()
+// like the SdCardTask does, on a new image with the latency of a card
+// profile, and with inputs at the sampling rate. After the run the capture
+// file is read back from the image and decoded, so the numbers are those of
+// the file and not those of the firmware.
+//
+// A run is a child process, so it starts with the static state of the
+// firmware after the power on. The results are written as JSON.
+//
+// The cluster size isn't a setting of the SdFat formatter, it follows the
+// capacity of the card. So the sweep selects the image size of a cluster
+// size, see clusterImageMb().
+// --------------------------------------------------------------------------
+
+#define BENCH_SIO_LINE_LEN    16       // bytes of a serial line, "$BENCH,000000*\r\n"
+#define BENCH_I2C_FRAME_LEN   8        // bytes of an i2c frame
+#define BENCH_MAX_FILE_MB     64       // preallocated size of the capture file
+
+enum
+{
+   MIX_ADC = 1,
+   MIX_DIG = 2,
+   MIX_SIO = 4,
+   MIX_I2C = 8
+};
+
+typedef struct
+{
+   const char *name;
+   uint8_t     mix;
+   const char *captureSource;          // for config.txt
+} BenchMix_t;
+
+static const BenchMix_t benchMixes[] =
+{
+   { "ADC", MIX_ADC, "A0 A1" },
+   { "DIG", MIX_DIG, "D6 D7" },
+   { "SIO", MIX_SIO, "SIO" },
+   { "I2C", MIX_I2C, "I2C" },
+   { "ALL", MIX_ADC | MIX_DIG | MIX_SIO | MIX_I2C, "SIO, I2C, A0 A1, D6 D7" },
+};
+
+typedef struct
+{
+   uint32_t rate;                      // Hz, sampling rate and rate of the inputs
+   const BenchMix_t *mix;
+   bool     binary;                    // FileType BIN, else TXT
+   uint32_t clusterKb;
+   const SdLatency_t *latency;
+} BenchRun_t;
+
+typedef struct
+{
+   bool     ok;
+   char     error[ 64 ];
+
+   double   seconds;                   // virtual time of the capture
+   uint64_t samples;                   // records, adc scans and pin changes in the file
+   uint64_t bytes;                     // size of the capture file
+   uint64_t droppedSamples;            // lost at the sources and with the records of droppedBytes
+   uint64_t droppedBytes;              // ring buffer full
+   uint64_t sioOverflow;               // serial bytes lost
+
+   uint64_t runCalls;                  // calls of Capture::run()
+   double   cpuUsPerRecord;            // virtual, see benchCapture()
+   double   hostNsPerRecord;           // cpu time of the host
+   double   stallP50Us;                // duration of a call of Capture::run()
+   double   stallP99Us;
+   double   stallMaxUs;
+
+   uint32_t gcStalls;
+   uint32_t auOpens;
+   double   cardBusyMs;
+   double   cardWaitMs;                // polling the busy card
+} BenchResult_t;
+
+static double benchSeconds = 5.0;
+static const char *imageDir = "/tmp";
+static const char *keepDir = NULL;
+
+// --------------------------------------------------------------------------
+// the image size, for which the SdFat formatter uses the cluster size
+// --------------------------------------------------------------------------
+
+static uint32_t clusterImageMb( uint32_t cluster_kb )
+{
+   switch( cluster_kb )
+   {
+      case 1:  return 16;
+      case 2:  return 32;
+      case 4:  return 64;
+      case 8:  return 128;
+      case 16: return 1024;
+      case 32: return 4096;
+      default: return 0;
+   }
+}
+
+// --------------------------------------------------------------------------
+// the inputs of a run
+// --------------------------------------------------------------------------
+
+static uint16_t benchAnalog( uint8_t channel, uint64_t ns )
+{
+   // a sine of ( channel + 1 ) Hz
+   double phase = 2.0 * M_PI * ( channel + 1 ) * ( ns % SIM_NS_PER_S ) / SIM_NS_PER_S;
+   return ( uint16_t )( 512.0 + 400.0 * sin( phase ) );
+}
+
+static void scheduleInputs( const BenchRun_t *run, uint64_t from, uint64_t to )
+{
+   uint64_t period = SIM_NS_PER_S / run->rate;
+   uint32_t n = 0;
+
+   if( run->mix->mix & MIX_ADC )
+      sim.analogSource = benchAnalog;
+
+   for( uint64_t t = from + period / 2; t < to; t += period, n++ )
+   {
+      if( run->mix->mix & MIX_DIG )
+      {
+         // D7 toggles at the rate, D6 at the half rate
+         sim.at( t, [ n ]( void )
+         {
+            sim.setPin( 7, n & 1 );
+            if( ( n & 1 ) == 0 )
+               sim.setPin( 6, ( n >> 1 ) & 1 );
+         } );
+      }
+
+      if( run->mix->mix & MIX_SIO )
+      {
+         // a line of a gps receiver, the usart limits the rate
+         sim.at( t, [ n ]( void )
+         {
+            char line[ BENCH_SIO_LINE_LEN + 1 ];
+            snprintf( line, sizeof( line ), "$BENCH,%06u*\r\n", n % 1000000 );
+            sim.uartSend( ( const uint8_t * )line, BENCH_SIO_LINE_LEN );
+         } );
+      }
+
+      if( run->mix->mix & MIX_I2C )
+      {
+         sim.at( t, [ n ]( void )
+         {
+            uint8_t frame[ BENCH_I2C_FRAME_LEN ];
+            for( uint8_t i = 0; i < sizeof( frame ); i++ )
+               frame[ i ] = n + i;
+            sim.i2cReceive( frame, sizeof( frame ) );
+         } );
+      }
+   }
+}
+
+// --------------------------------------------------------------------------
+// decode the capture file
+// --------------------------------------------------------------------------
+
+static bool decodeBinary( const std::vector< uint8_t > &data, BenchResult_t *res )
+{
+   const uint8_t *p = data.data();
+   const uint8_t *end = p + data.size();
+
+   if( data.size() < 6 || memcmp( p, RECORD_MAGIC, 4 ) != 0 )
+      return false;
+   p += p[ 5 ];                        // FileHeader_t.headerSize
+
+   while( p + sizeof( RecordHeader_t ) <= end )
+   {
+      RecordHeader_t header;
+      memcpy( &header, p, sizeof( header ) );
+      p += sizeof( header );
+
+      Source_t source;
+      source.val = header.source;
+
+      if( header.timeDelta == RECORD_TIME_EXT )
+         p += sizeof( uint32_t );
+
+      switch( header.sync )
+      {
+         case RECORD_SYNC:
+         case RECORD_SYNC_RECOVERED:
+            if( source.val == 0 )
+            {
+               RecordTrailer_t trailer;
+               if( p + sizeof( trailer ) > end )
+                  return false;
+               memcpy( &trailer, p, sizeof( trailer ) );
+               res->droppedBytes = trailer.droppedBytes;
+               res->sioOverflow = trailer.sioOverflow;
+               res->droppedSamples += trailer.i2cLost + trailer.edgesLost + trailer.droppedSamples;
+               return true;
+            }
+            p += 2 * __builtin_popcount( source.analog );
+            if( source.digital )
+               p += 1;
+            if( source.sio && p < end )
+               p += 1 + *p;
+            if( source.i2c && p < end )
+               p += 1 + *p;
+            res->samples++;
+            break;
+
+         case RECORD_SYNC_ADC:
+         case RECORD_SYNC_ADC_DELTA:
+         {
+            AdcBlockHeader_t block;
+            if( p + sizeof( block ) > end )
+               return false;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block );
+            if( header.sync == RECORD_SYNC_ADC )
+               p += 2 * block.scans * __builtin_popcount( source.analog );
+            else
+            {
+               AdcDeltaHeader_t delta;
+               if( p + sizeof( delta ) > end )
+                  return false;
+               memcpy( &delta, p, sizeof( delta ) );
+               p += sizeof( delta ) + delta.size;
+            }
+            res->samples += block.scans;
+            res->droppedSamples += block.lost;
+            break;
+         }
+
+         case RECORD_SYNC_EDGE:
+         {
+            EdgeBlockHeader_t block;
+            if( p + sizeof( block ) > end )
+               return false;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block ) + block.count * ( sizeof( uint32_t ) + sizeof( uint8_t ) );
+            // the lost pin changes are counted with the trailer
+            res->samples += block.count;
+            break;
+         }
+
+         case RECORD_SYNC_TIME:
+            break;
+
+         default:
+            return false;
+      }
+   }
+
+   // no trailer, the capture was cut
+   return false;
+}
+
+// the counters of the trailer lines are printed with %ld, keep the 32 bit
+static uint32_t trailerValue( const char *line, const char *prefix )
+{
+   return ( uint32_t )strtoull( line + strlen( prefix ), NULL, 10 );
+}
+
+static bool decodeText( const std::vector< uint8_t > &data, BenchResult_t *res )
+{
+   std::string text( data.begin(), data.end() );
+   bool trailer = false;
+   size_t pos = 0;
+
+   while( pos < text.size() )
+   {
+      size_t eol = text.find( '\n', pos );
+      if( eol == std::string::npos )
+         eol = text.size();
+      std::string line = text.substr( pos, eol - pos );
+      pos = eol + 1;
+
+      if( line.compare( 0, 19, "Capture start time:" ) == 0 )
+         trailer = true;
+      else if( !trailer )
+      {
+         // "ADC 3 scans lost" and "DIG 2 changes lost" have no time stamp,
+         // the lost pin changes are counted with the trailer
+         unsigned long lost;
+         int n = 0;
+         if( sscanf( line.c_str(), "%*[ADCIG] %lu %*[a-z] lost%n", &lost, &n ) == 1 && n > 0 )
+         {
+            if( line[ 0 ] == 'A' )
+               res->droppedSamples += lost;
+         }
+         else if( !line.empty() && line != "\r" )
+            res->samples++;
+      }
+      else if( line.compare( 0, 9, "DIG lost " ) == 0 )
+         res->droppedSamples += trailerValue( line.c_str(), "DIG lost " );
+      else if( line.compare( 0, 9, "I2C lost " ) == 0 )
+         res->droppedSamples += trailerValue( line.c_str(), "I2C lost " );
+      else if( line.compare( 0, 13, "SIO overflow " ) == 0 )
+         res->sioOverflow = trailerValue( line.c_str(), "SIO overflow " );
+      else if( line.compare( 0, 8, "Dropped " ) == 0 )
+      {
+         // "Dropped 512 bytes, 40 samples, buffer max ..."
+         unsigned long bytes, samples;
+         if( sscanf( line.c_str(), "Dropped %lu bytes, %lu samples", &bytes, &samples ) == 2 )
+         {
+            res->droppedBytes = ( uint32_t )bytes;
+            res->droppedSamples += ( uint32_t )samples;
+         }
+      }
+   }
+   return trailer;
+}
+
+// --------------------------------------------------------------------------
+// one run, in the child process
+// --------------------------------------------------------------------------
+
+static bool benchFail( BenchResult_t *res, const char *error )
+{
+   snprintf( res->error, sizeof( res->error ), "%s", error );
+   return false;
+}
+
+static double percentile( std::vector< uint64_t > &v, double p )
+{
+   if( v.empty() )
+      return 0.0;
+   size_t i = ( size_t )( p * ( v.size() - 1 ) );
+   std::nth_element( v.begin(), v.begin() + i, v.end() );
+   return v[ i ] / ( double )SIM_NS_PER_US;
+}
+
+static bool benchCapture( const BenchRun_t *run, BenchResult_t *res )
+{
+   // the image, formatted and with config.txt, without latency
+   uint32_t image_mb = clusterImageMb( run->clusterKb );
+   if( image_mb == 0 )
+      return benchFail( res, "cluster size not supported" );
+
+   ImageBlockDevice image;
+   const char *error = hostCaptureImage( &image, imageDir, image_mb );
+   if( error != NULL )
+      return benchFail( res, error );
+
+   const char *file_name = run->binary ? "bench.bin" : "bench.txt";
+   char config[ 512 ];
+   int len = snprintf( config, sizeof( config ),
+                       "FileName         \"%s\"\n"
+                       "FileType         %s\n"
+                       "FileSize         %uM\n"
+                       "CaptureSource    %s\n"
+                       "SamplingRate     %u Hz\n"
+                       "Oversampling     1\n"
+                       "OversamplingBits 0\n"
+                       "SyncSize         64K\n"
+                       "SyncTime         10 s\n"
+                       "SyncIdle         1 s\n"
+                       "SerialBaudrate   115200\n"
+                       "SerialBits       8\n"
+                       "SerialParity     N\n"
+                       "SerialStopBits   1\n",
+                       file_name, run->binary ? "bin" : "txt",
+                       std::min( image_mb / 4, ( uint32_t )BENCH_MAX_FILE_MB ),
+                       run->mix->captureSource, run->rate );
+
+   sim.uartOutput = []( uint8_t c ) { ( void )c; };
+   error = hostCaptureStart( &image, config, len, run->latency );
+   if( error != NULL )
+      return benchFail( res, error );
+
+   // the capture
+   uint64_t from = sim.nanos();
+   uint64_t to = from + ( uint64_t )( benchSeconds * SIM_NS_PER_S );
+   uint64_t busy_from = image.stats.busyNs;
+   uint64_t wait_from = sdCardSim.stats.waitNs;
+   std::vector< uint64_t > stalls;
+   struct timespec host_from, host_to;
+
+   scheduleInputs( run, from, to );
+
+   clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &host_from );
+   uint64_t isr_from = sim.isrNs;
+   uint64_t isr_run = 0;
+   while( sim.nanos() < to && !flags.sdcard_error )
+   {
+      uint64_t t = sim.nanos();
+      uint64_t isr = sim.isrNs;
+      capture.run();
+      stalls.push_back( sim.nanos() - t );
+      isr_run += sim.isrNs - isr;
+      yield();
+   }
+   res->seconds = ( sim.nanos() - from ) / ( double )SIM_NS_PER_S;
+   uint64_t busy_ns = image.stats.busyNs - busy_from;
+   uint64_t wait_ns = sdCardSim.stats.waitNs - wait_from;
+   uint64_t isr_ns = sim.isrNs - isr_from - isr_run;
+   res->gcStalls = image.stats.gcStalls;
+   res->auOpens = image.stats.auOpens;
+   capture.stop();
+   clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &host_to );
+
+   if( flags.sdcard_error )
+      return benchFail( res, "write error of the capture file" );
+
+   // the file
+   std::vector< uint8_t > data;
+   image.setLatency( sdLatencyProfile( "none" ) );
+   if( !hostReadFile( file_name, &data ) )
+      return benchFail( res, "can't read the capture file" );
+   if( keepDir != NULL )
+   {
+      char keep[ 1024 ];
+      snprintf( keep, sizeof( keep ), "%s/%u-%s-%ukb-%s.%s", keepDir, run->rate, run->mix->name,
+                run->clusterKb, run->latency->name, run->binary ? "bin" : "txt" );
+      FILE *out = fopen( keep, "wb" );
+      if( out != NULL )
+      {
+         fwrite( data.data(), 1, data.size(), out );
+         fclose( out );
+      }
+   }
+
+   res->bytes = data.size();
+   if( !( run->binary ? decodeBinary( data, res ) : decodeText( data, res ) ) )
+      return benchFail( res, "can't decode the capture file" );
+
+   // the cpu time of the records: the time of the calls of run() above an
+   // empty call, without the time polling the busy card, and the time of
+   // the interrupts between the calls
+   res->runCalls = stalls.size();
+
+   uint64_t min_ns = stalls.empty() ? 0 : *std::min_element( stalls.begin(), stalls.end() );
+   uint64_t sum_ns = 0;
+   for( uint64_t ns : stalls )
+      sum_ns += ns - min_ns;
+   double cpu_ns = ( sum_ns > wait_ns ? ( double )( sum_ns - wait_ns ) : 0.0 ) + isr_ns;
+   double host_ns = ( host_to.tv_sec - host_from.tv_sec ) * 1e9 + ( host_to.tv_nsec - host_from.tv_nsec );
+
+   if( res->samples )
+   {
+      res->cpuUsPerRecord = cpu_ns / SIM_NS_PER_US / res->samples;
+      res->hostNsPerRecord = host_ns / res->samples;
+   }
+   res->stallMaxUs = percentile( stalls, 1.0 );
+   res->stallP99Us = percentile( stalls, 0.99 );
+   res->stallP50Us = percentile( stalls, 0.50 );
+
+   res->cardBusyMs = busy_ns / ( double )SIM_NS_PER_MS;
+   res->cardWaitMs = wait_ns / ( double )SIM_NS_PER_MS;
+
+   res->ok = true;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// the sweep
+// --------------------------------------------------------------------------
+
+static void printRun( FILE *out, const BenchRun_t *run, const BenchResult_t *res, bool last )
+{
+   fprintf( out, "    { \"rate_hz\": %u, \"sources\": \"%s\", \"file_type\": \"%s\", "
+            "\"cluster_kb\": %u, \"latency\": \"%s\", \"ok\": %s",
+            run->rate, run->mix->name, run->binary ? "bin" : "txt",
+            run->clusterKb, run->latency->name, res->ok ? "true" : "false" );
+
+   if( !res->ok )
+      fprintf( out, ", \"error\": \"%s\"", res->error );
+   else
+   {
+      fprintf( out, ",\n      \"seconds\": %.3f, \"samples\": %lu, \"samples_per_s\": %.1f, "
+               "\"bytes\": %lu, \"bytes_per_s\": %.1f,\n",
+               res->seconds, ( unsigned long )res->samples, res->samples / res->seconds,
+               ( unsigned long )res->bytes, res->bytes / res->seconds );
+      fprintf( out, "      \"dropped_samples\": %lu, \"dropped_bytes\": %lu, \"sio_overflow_bytes\": %lu,\n",
+               ( unsigned long )res->droppedSamples, ( unsigned long )res->droppedBytes,
+               ( unsigned long )res->sioOverflow );
+      fprintf( out, "      \"run_calls\": %lu, \"cpu_us_per_record\": %.2f, \"host_ns_per_record\": %.1f,\n",
+               ( unsigned long )res->runCalls, res->cpuUsPerRecord, res->hostNsPerRecord );
+      fprintf( out, "      \"stall_us\": { \"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f },\n",
+               res->stallP50Us, res->stallP99Us, res->stallMaxUs );
+      fprintf( out, "      \"card\": { \"busy_ms\": %.3f, \"wait_ms\": %.3f, \"gc_stalls\": %u, \"au_opens\": %u }",
+               res->cardBusyMs, res->cardWaitMs, res->gcStalls, res->auOpens );
+   }
+   fprintf( out, " }%s\n", last ? "" : "," );
+}
+
+// run the runs in child processes, jobs at the same time
+static void runSweep( const std::vector< BenchRun_t > &runs, std::vector< BenchResult_t > *results, int jobs )
+{
+   std::map< pid_t, std::pair< size_t, int > > active;   // pid, index and pipe
+   size_t next = 0;
+
+   results->assign( runs.size(), BenchResult_t() );
+
+   while( next < runs.size() || !active.empty() )
+   {
+      while( next < runs.size() && ( int )active.size() < jobs )
+      {
+         int fds[ 2 ];
+         if( pipe( fds ) != 0 )
+         {
+            snprintf( ( *results )[ next ].error, sizeof( BenchResult_t::error ), "pipe() failed" );
+            next++;
+            continue;
+         }
+
+         pid_t pid = fork();
+         if( pid == 0 )
+         {
+            BenchResult_t res = BenchResult_t();
+            close( fds[ 0 ] );
+            benchCapture( &runs[ next ], &res );
+            ssize_t n = write( fds[ 1 ], &res, sizeof( res ) );
+            _exit( n == sizeof( res ) ? 0 : 1 );
+         }
+
+         close( fds[ 1 ] );
+         if( pid < 0 )
+         {
+            close( fds[ 0 ] );
+            snprintf( ( *results )[ next ].error, sizeof( BenchResult_t::error ), "fork() failed" );
+         }
+         else
+            active[ pid ] = std::make_pair( next, fds[ 0 ] );
+         next++;
+      }
+
+      int status;
+      pid_t pid = wait( &status );
+      if( pid < 0 )
+         break;
+
+      auto it = active.find( pid );
+      if( it == active.end() )
+         continue;
+
+      BenchResult_t *res = &( *results )[ it->second.first ];
+      if( read( it->second.second, res, sizeof( *res ) ) != sizeof( *res ) )
+      {
+         *res = BenchResult_t();
+         snprintf( res->error, sizeof( res->error ), "run ended with status %d", status );
+      }
+      close( it->second.second );
+      fprintf( stderr, "." );
+      active.erase( it );
+   }
+   fprintf( stderr, "\n" );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static std::vector< std::string > splitList( const char *list )
+{
+   std::vector< std::string > items;
+   std::string s( list );
+   size_t pos = 0;
+
+   while( pos <= s.size() )
+   {
+      size_t comma = s.find( ',', pos );
+      if( comma == std::string::npos )
+         comma = s.size();
+      if( comma > pos )
+         items.push_back( s.substr( pos, comma - pos ) );
+      pos = comma + 1;
+   }
+   return items;
+}
+
+static void usage( const char *name )
+{
+   fprintf( stderr,
+            "usage: %s [options]\n"
+            "  -r list     sampling rates in Hz, default 10,100,1000\n"
+            "  -s list     sources: ADC, DIG, SIO, I2C, ALL, default all of them\n"
+            "  -f list     file types: txt, bin, default txt,bin\n"
+            "  -c list     cluster sizes in KB: 1, 2, 4, 8, 16, 32, default 4,32\n"
+            "  -l list     latency of the card: none, fast, typical, slow, default none,typical,slow\n"
+            "  -t s        virtual capture time of a run, default 5\n"
+            "  -j n        runs at the same time, default 1\n"
+            "  -d dir      directory of the temporary images, default /tmp\n"
+            "  -k dir      keep the capture files in dir\n"
+            "  -o file     write the JSON to file, default stdout\n",
+            name );
+}
+
+int main( int argc, char *argv[] )
+{
+   const char *rates = "10,100,1000";
+   const char *mixes = "ADC,DIG,SIO,I2C,ALL";
+   const char *types = "txt,bin";
+   const char *clusters = "4,32";
+   const char *latencies = "none,typical,slow";
+   const char *out_path = NULL;
+   int jobs = 1;
+   int opt;
+
+   while( ( opt = getopt( argc, argv, "r:s:f:c:l:t:j:d:k:o:h" ) ) != -1 )
+   {
+      switch( opt )
+      {
+         case 'r': rates = optarg; break;
+         case 's': mixes = optarg; break;
+         case 'f': types = optarg; break;
+         case 'c': clusters = optarg; break;
+         case 'l': latencies = optarg; break;
+         case 't': benchSeconds = atof( optarg ); break;
+         case 'j': jobs = std::max( 1, atoi( optarg ) ); break;
+         case 'd': imageDir = optarg; break;
+         case 'k': keepDir = optarg; mkdir( keepDir, 0755 ); break;
+         case 'o': out_path = optarg; break;
+         default:
+            usage( argv[ 0 ] );
+            return 1;
+      }
+   }
+
+   // the sweep, rate is the innermost loop
+   std::vector< BenchRun_t > runs;
+   for( const std::string &l : splitList( latencies ) )
+   {
+      BenchRun_t run;
+      run.latency = sdLatencyProfile( l.c_str() );
+      if( run.latency == NULL )
+      {
+         fprintf( stderr, "unknown latency profile <%s>\n", l.c_str() );
+         return 1;
+      }
+      for( const std::string &c : splitList( clusters ) )
+      {
+         run.clusterKb = strtoul( c.c_str(), NULL, 0 );
+         if( clusterImageMb( run.clusterKb ) == 0 )
+         {
+            fprintf( stderr, "cluster size <%s> not supported\n", c.c_str() );
+            return 1;
+         }
+         for( const std::string &f : splitList( types ) )
+         {
+            if( f != "txt" && f != "bin" )
+            {
+               fprintf( stderr, "unknown file type <%s>\n", f.c_str() );
+               return 1;
+            }
+            run.binary = f == "bin";
+            for( const std::string &m : splitList( mixes ) )
+            {
+               run.mix = NULL;
+               for( const BenchMix_t &mix : benchMixes )
+                  if( m == mix.name )
+                     run.mix = &mix;
+               if( run.mix == NULL )
+               {
+                  fprintf( stderr, "unknown sources <%s>\n", m.c_str() );
+                  return 1;
+               }
+               for( const std::string &r : splitList( rates ) )
+               {
+                  run.rate = strtoul( r.c_str(), NULL, 0 );
+                  if( run.rate == 0 )
+                  {
+                     fprintf( stderr, "invalid rate <%s>\n", r.c_str() );
+                     return 1;
+                  }
+                  runs.push_back( run );
+               }
+            }
+         }
+      }
+   }
+
+   FILE *out = out_path ? fopen( out_path, "w" ) : stdout;
+   if( out == NULL )
+   {
+      fprintf( stderr, "can't create <%s>\n", out_path );
+      return 1;
+   }
+
+   fprintf( stderr, "%lu runs of %.1f s\n", ( unsigned long )runs.size(), benchSeconds );
+   std::vector< BenchResult_t > results;
+   fflush( out );
+   runSweep( runs, &results, jobs );
+
+   int failed = 0;
+   fprintf( out, "{\n  \"benchmark\": \"capture\",\n  \"seconds_per_run\": %.3f,\n  \"runs\": [\n", benchSeconds );
+   for( size_t i = 0; i < runs.size(); i++ )
+   {
+      printRun( out, &runs[ i ], &results[ i ], i + 1 == runs.size() );
+      if( !results[ i ].ok )
+         failed++;
+   }
+   fprintf( out, "  ]\n}\n" );
+
+   if( out != stdout )
+      fclose( out );
+   if( failed )
+      fprintf( stderr, "%d of %lu runs failed\n", failed, ( unsigned long )runs.size() );
+   return failed ? 1 : 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
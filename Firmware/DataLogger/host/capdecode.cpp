@@ -0,0 +1,1633 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          capdecode.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   analog pins of a text file from the config.txt next to it
+// 2026-10-18  AWe   lost pin changes of a binary file from the trailer
+// 2026-10-18  AWe   initial version, decode the capture files on the host
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && !defined( NO_SIMD )
+   #include <immintrin.h>
+   #define HAVE_SSE2
+#endif
+
+#include "Record.h"
+
+// --------------------------------------------------------------------------
+// Decode a capture file, TXT or BIN, into one column per channel.
+//
+// The file is mapped into the memory and split into chunks, which are
+// decoded by the cores in two passes:
+//
+//    pass 1   finds the first record of each chunk and walks the chunk up
+//             to the first record of the next one. A chunk which didn't
+//             start on a record boundary is walked again from the end of
+//             the previous chunk. The walk gives the number of rows of each
+//             column and how the chunk changes the state of the decoder:
+//             the record time, which is a delta to the previous record, and
+//             the previous values of the delta encoded adc blocks.
+//    pass 2   decodes the chunks with the state at their start. The binary
+//             columns are written at their final position, the CSV text is
+//             written in the order of the chunks.
+//
+// The columns are A0 .. A5, DIG the sampled digital pins, EDGE the state of
+// the digital pins after a pin change, SIO the serial bursts and I2C the
+// i2c frames. For each column with rows there is a prefix.<column>.csv and
+// a prefix.<column>.col, see ColumnHeader_t.
+//
+// The time of a row is in us, the ms of the text file times 1000. When the
+// software rtc was set (SystemTime), the time is the us since 1970-01-01.
+//
+// The text file doesn't tell the analog pins of the ADC values. They are the
+// pins given with -a, else the analog pins of CaptureSource in the config.txt
+// next to the file. Without both they are A0, A1, ... in the order of the
+// line, with a warning.
+// --------------------------------------------------------------------------
+
+enum
+{
+   COL_A0,
+   COL_A1,
+   COL_A2,
+   COL_A3,
+   COL_A4,
+   COL_A5,
+   COL_DIG,
+   COL_EDGE,
+   COL_SIO,
+   COL_I2C,
+   NUM_COLUMNS
+};
+
+static const char *const columnName[ NUM_COLUMNS ] =
+{
+   "A0", "A1", "A2", "A3", "A4", "A5", "DIG", "EDGE", "SIO", "I2C"
+};
+
+// bytes of a value in the binary column, the value of SIO and I2C is the
+// length of the bytes of the row
+static const uint8_t columnValueSize[ NUM_COLUMNS ] = { 2, 2, 2, 2, 2, 2, 1, 1, 1, 1 };
+
+static bool columnHasBytes( int col )
+{
+   return col == COL_SIO || col == COL_I2C;
+}
+
+// --------------------------------------------------------------------------
+// the dense binary column, prefix.<column>.col
+//
+// column  := ColumnHeader_t
+//            int64_t  time[ rows ]        us
+//            value    value[ rows ]       valueSize bytes each, little endian
+//            uint8_t  bytes[ bytes ]      with hasBytes, value is the length
+//                                         of the bytes of a row
+// --------------------------------------------------------------------------
+
+#define COLUMN_MAGIC          "DCOL"
+#define COLUMN_VERSION        1
+
+typedef struct __attribute__( ( packed ) )
+{
+   char     magic[ 4 ];       // COLUMN_MAGIC, not zero terminated
+   uint8_t  version;          // COLUMN_VERSION
+   uint8_t  valueSize;        // 1 or 2
+   uint8_t  hasBytes;         // 1: SIO, I2C
+   uint8_t  reserved;
+   char     name[ 8 ];        // "A0", "DIG", ..., zero padded
+   uint64_t rows;
+   uint64_t bytes;            // size of the bytes at the end
+} ColumnHeader_t;
+
+// --------------------------------------------------------------------------
+// the rows of a chunk
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   uint64_t rows[ NUM_COLUMNS ];
+   uint64_t bytes[ NUM_COLUMNS ];
+} Counts_t;
+
+class Columns
+{
+public:
+   std::vector< int64_t >  time[ NUM_COLUMNS ];
+   std::vector< uint16_t > value[ NUM_COLUMNS ];
+   std::vector< uint8_t >  bytes[ NUM_COLUMNS ];
+
+   void row( int col, int64_t t, uint16_t v )
+   {
+      time[ col ].push_back( t );
+      value[ col ].push_back( v );
+   }
+
+   void data( int col, int64_t t, const uint8_t *p, uint8_t len )
+   {
+      time[ col ].push_back( t );
+      value[ col ].push_back( len );
+      bytes[ col ].insert( bytes[ col ].end(), p, p + len );
+   }
+};
+
+// --------------------------------------------------------------------------
+// SIMD helpers, with a scalar version for the other cpus
+// --------------------------------------------------------------------------
+
+static bool haveSsse3 = false;
+
+#ifdef HAVE_SSE2
+// the value of n <= 16 decimal digits at p, 16 bytes at p are readable
+__attribute__( ( target( "ssse3" ) ) )
+static uint64_t parseDigitsSsse3( const char *p, int n )
+{
+   // shift the digits to the end of the register, zeros in front
+   static const struct ShiftTable
+   {
+      int8_t mask[ 17 ][ 16 ];
+      ShiftTable( void )
+      {
+         for( int len = 0; len <= 16; len++ )
+            for( int i = 0; i < 16; i++ )
+               mask[ len ][ i ] = i < 16 - len ? -1 : i - ( 16 - len );
+      }
+   } shift;
+
+   __m128i v = _mm_loadu_si128( ( const __m128i * )p );
+   v = _mm_sub_epi8( v, _mm_set1_epi8( '0' ) );
+   v = _mm_shuffle_epi8( v, _mm_loadu_si128( ( const __m128i * )shift.mask[ n ] ) );
+
+   // 2, 4, 8 digits in each lane
+   v = _mm_maddubs_epi16( v, _mm_setr_epi8( 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1 ) );
+   v = _mm_madd_epi16( v, _mm_setr_epi16( 100, 1, 100, 1, 100, 1, 100, 1 ) );
+   v = _mm_packs_epi32( v, v );
+   v = _mm_madd_epi16( v, _mm_setr_epi16( 10000, 1, 10000, 1, 10000, 1, 10000, 1 ) );
+
+   uint32_t hi = _mm_cvtsi128_si32( v );
+   uint32_t lo = _mm_cvtsi128_si32( _mm_srli_si128( v, 4 ) );
+   return ( uint64_t )hi * 100000000ULL + lo;
+}
+
+// number of digits at the start of the 16 bytes at p
+static int countDigitsSse2( const char *p )
+{
+   __m128i v = _mm_loadu_si128( ( const __m128i * )p );
+   __m128i lt = _mm_cmplt_epi8( v, _mm_set1_epi8( '0' ) );
+   __m128i gt = _mm_cmpgt_epi8( v, _mm_set1_epi8( '9' ) );
+   uint32_t other = _mm_movemask_epi8( _mm_or_si128( lt, gt ) ) | 0x10000;
+   return __builtin_ctz( other );
+}
+#endif
+
+// parse an unsigned decimal number at p, returns the end of the digits
+static const char *parseNumber( const char *p, const char *end, uint64_t *value )
+{
+#ifdef HAVE_SSE2
+   if( haveSsse3 && end - p >= 16 )
+   {
+      int n = countDigitsSse2( p );
+      if( n < 16 )
+      {
+         *value = parseDigitsSsse3( p, n );
+         return p + n;
+      }
+   }
+#endif
+   uint64_t v = 0;
+   while( p < end && *p >= '0' && *p <= '9' )
+      v = v * 10 + ( *p++ - '0' );
+   *value = v;
+   return p;
+}
+
+// the channel values of an adc block, scan by scan, into the columns
+static void deinterleave( const uint8_t *p, uint8_t scans, uint8_t channels, uint16_t *out[ 6 ] )
+{
+   uint16_t i = 0;
+
+#ifdef HAVE_SSE2
+   if( channels == 2 )
+   {
+      // 4 scans of 2 channels, a0 b0 a1 b1 .. to a0 a1 a2 a3 b0 b1 b2 b3
+      for( ; i + 4 <= scans; i += 4 )
+      {
+         __m128i v = _mm_loadu_si128( ( const __m128i * )( p + i * 4 ) );
+         v = _mm_shufflelo_epi16( v, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+         v = _mm_shufflehi_epi16( v, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+         v = _mm_shuffle_epi32( v, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+         _mm_storel_epi64( ( __m128i * )( out[ 0 ] + i ), v );
+         _mm_storel_epi64( ( __m128i * )( out[ 1 ] + i ), _mm_srli_si128( v, 8 ) );
+      }
+   }
+#endif
+   for( ; i < scans; i++ )
+   {
+      for( uint8_t ch = 0; ch < channels; ch++ )
+      {
+         uint16_t v;
+         memcpy( &v, p + ( i * channels + ch ) * 2, 2 );
+         out[ ch ][ i ] = v;
+      }
+   }
+}
+
+// the varints of an adcd block, added to the previous values of the
+// channels, out may be NULL
+static bool decodeDeltas( const uint8_t *p, uint8_t size, uint8_t scans, uint8_t channels,
+                          uint16_t prev[ 6 ], uint16_t *out[ 6 ] )
+{
+   const uint8_t *end = p + size;
+   uint16_t n = scans * channels;
+   uint16_t k = 0;
+   uint8_t ch = 0;
+
+   while( k < n )
+   {
+#ifdef HAVE_SSE2
+      // 16 varints of one byte, the usual case of a slow signal
+      if( end - p >= 16 && n - k >= 16 )
+      {
+         __m128i v = _mm_loadu_si128( ( const __m128i * )p );
+         if( _mm_movemask_epi8( v ) == 0 )
+         {
+            // zigzag: ( u >> 1 ) ^ -( u & 1 )
+            __m128i zero = _mm_setzero_si128();
+            __m128i one = _mm_set1_epi16( 1 );
+            __m128i lo = _mm_unpacklo_epi8( v, zero );
+            __m128i hi = _mm_unpackhi_epi8( v, zero );
+            lo = _mm_xor_si128( _mm_srli_epi16( lo, 1 ), _mm_sub_epi16( zero, _mm_and_si128( lo, one ) ) );
+            hi = _mm_xor_si128( _mm_srli_epi16( hi, 1 ), _mm_sub_epi16( zero, _mm_and_si128( hi, one ) ) );
+
+            uint16_t d[ 16 ];
+            _mm_storeu_si128( ( __m128i * )d, lo );
+            _mm_storeu_si128( ( __m128i * )( d + 8 ), hi );
+
+            for( int i = 0; i < 16; i++ )
+            {
+               prev[ ch ] += d[ i ];
+               if( out )
+                  out[ ch ][ k / channels ] = prev[ ch ];
+               k++;
+               if( ++ch == channels )
+                  ch = 0;
+            }
+            p += 16;
+            continue;
+         }
+      }
+#endif
+      uint32_t u = 0;
+      uint8_t shift = 0;
+      uint8_t b;
+      do
+      {
+         if( p >= end || shift > 14 )
+            return false;
+         b = *p++;
+         u |= ( uint32_t )( b & 0x7F ) << shift;
+         shift += 7;
+      }
+      while( b & 0x80 );
+
+      prev[ ch ] += ( uint16_t )( ( u >> 1 ) ^ -( u & 1 ) );
+      if( out )
+         out[ ch ][ k / channels ] = prev[ ch ];
+      k++;
+      if( ++ch == channels )
+         ch = 0;
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// the state of the decoder between two chunks
+// --------------------------------------------------------------------------
+
+// the 32 bit us next to the time of the previous record
+static int64_t unwrap( int64_t prev, uint32_t us )
+{
+   return prev + ( int32_t )( us - ( uint32_t )prev );
+}
+
+typedef struct
+{
+   int64_t  time;             // us of the timebase of the previous record, unwrapped
+   uint16_t adc[ 6 ];         // previous values of the adcd blocks
+} DecoderState_t;
+
+// how a chunk changes the state, found by pass 1 without knowing the state
+// at the start of the chunk
+class StateChange
+{
+public:
+   bool     absolute;         // a record with an absolute time was found
+   int64_t  rel;              // sum of the deltas before it
+   uint32_t first;            // the first absolute time
+   int64_t  local;            // time of the last record, unwrapped from first
+   uint8_t  adcReset;         // channels with a keyframe in the chunk
+   uint16_t adc[ 6 ];         // the values since the keyframe, or the sum of the deltas
+
+   StateChange( void ) : absolute( false ), rel( 0 ), first( 0 ), local( 0 ), adcReset( 0 ), adc() {}
+
+   void delta( uint16_t us )
+   {
+      if( absolute )
+         local += us;
+      else
+         rel += us;
+   }
+
+   void ext( uint32_t us )
+   {
+      if( absolute )
+         local = unwrap( local, us );
+      else
+      {
+         absolute = true;
+         first = us;
+         local = us;
+      }
+   }
+
+   void apply( DecoderState_t *state ) const
+   {
+      if( absolute )
+         state->time = unwrap( state->time + rel, first ) + ( local - first );
+      else
+         state->time += rel;
+
+      for( int ch = 0; ch < 6; ch++ )
+         state->adc[ ch ] = ( adcReset & ( 1 << ch ) ) ? adc[ ch ] : state->adc[ ch ] + adc[ ch ];
+   }
+};
+
+// --------------------------------------------------------------------------
+// a chunk of the file
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   size_t   start;            // nominal start, a multiple of the chunk size
+   size_t   begin;            // first record
+   size_t   end;              // behind the last record
+   bool     last;             // the end of the records, the trailer or the end of the file
+   uint64_t skipped;          // bytes between records, which weren't records
+   uint64_t lost;             // adc scans, pin changes lost by the firmware
+   Counts_t counts;
+   StateChange change;
+   DecoderState_t state;      // at begin, for pass 2
+} Chunk_t;
+
+// --------------------------------------------------------------------------
+// the binary file
+// --------------------------------------------------------------------------
+
+class BinaryDecoder
+{
+private:
+   const uint8_t *base;
+   size_t size;
+
+   static uint8_t countBits( uint8_t v ) { return __builtin_popcount( v ); }
+
+public:
+   FileHeader_t header;
+   RecordTrailer_t trailer;
+   bool hasTrailer;
+
+   BinaryDecoder( const uint8_t *data, size_t len ) : base( data ), size( len ), hasTrailer( false )
+   {
+      memset( &header, 0, sizeof( header ) );
+      memset( &trailer, 0, sizeof( trailer ) );
+      memcpy( &header, data, std::min( len, sizeof( header ) ) );
+   }
+
+   bool valid( void )
+   {
+      return size >= 6 && memcmp( header.magic, RECORD_MAGIC, 4 ) == 0
+             && header.headerSize >= 6 && header.headerSize <= size;
+   }
+
+   size_t dataStart( void ) { return header.headerSize; }
+
+   // the time of the rows: the ms of the text file or the clock time, in us
+   int64_t rowTime( int64_t us )
+   {
+      int64_t origin = header.clockTime ? header.clockTime * 1000000LL + header.clockMs * 1000LL
+                                        : header.partTime * 1000LL;
+      return origin + ( us - ( int64_t )header.partMicros );
+   }
+
+   DecoderState_t initialState( void )
+   {
+      DecoderState_t state;
+      memset( &state, 0, sizeof( state ) );
+      state.time = header.partMicros;
+      return state;
+   }
+
+   // length of the record at pos, 0 when it isn't a valid record, like
+   // nextRecord() of Recovery.cpp; trailer is set for the trailer
+   size_t recordLength( size_t pos, bool *trailer )
+   {
+      const uint8_t *p = base + pos;
+      size_t left = size - pos;
+      RecordHeader_t h;
+
+      *trailer = false;
+      if( left < sizeof( h ) )
+         return 0;
+      memcpy( &h, p, sizeof( h ) );
+
+      uint8_t analog = h.source & 0x3F;
+      uint8_t digital = h.source >> 8;
+      bool ext = h.timeDelta == RECORD_TIME_EXT;
+      size_t len = sizeof( h ) + ( ext ? sizeof( uint32_t ) : 0 );
+
+      switch( h.sync )
+      {
+         case RECORD_SYNC:
+         case RECORD_SYNC_RECOVERED:
+            if( h.source == 0 )
+            {
+               if( h.timeDelta != 0 )
+                  return 0;
+               *trailer = true;
+               len = sizeof( h ) + sizeof( RecordTrailer_t );
+               break;
+            }
+            if( h.sync == RECORD_SYNC_RECOVERED )
+               return 0;
+            len += countBits( analog ) * 2 + ( digital ? 1 : 0 );
+            if( h.source & 0x40 )
+            {
+               if( len >= left )
+                  return 0;
+               len += 1 + p[ len ];
+            }
+            if( h.source & 0x80 )
+            {
+               if( len >= left )
+                  return 0;
+               len += 1 + p[ len ];
+            }
+            break;
+
+         case RECORD_SYNC_ADC:
+         case RECORD_SYNC_ADC_DELTA:
+         {
+            AdcBlockHeader_t adc;
+            if( !ext || analog == 0 || h.source != analog || left < len + sizeof( adc ) )
+               return 0;
+            memcpy( &adc, p + len, sizeof( adc ) );
+            if( adc.scans == 0 )
+               return 0;
+            len += sizeof( adc );
+            if( h.sync == RECORD_SYNC_ADC )
+               len += adc.scans * countBits( analog ) * 2;
+            else
+            {
+               AdcDeltaHeader_t delta;
+               if( left < len + sizeof( delta ) )
+                  return 0;
+               memcpy( &delta, p + len, sizeof( delta ) );
+               if( delta.keyframe > 1 )
+                  return 0;
+               len += sizeof( delta ) + delta.size;
+            }
+            break;
+         }
+
+         case RECORD_SYNC_EDGE:
+         {
+            EdgeBlockHeader_t edges;
+            if( !ext || digital == 0 || h.source != ( digital << 8 ) || left < len + sizeof( edges ) )
+               return 0;
+            memcpy( &edges, p + len, sizeof( edges ) );
+            if( edges.count == 0 )
+               return 0;
+            len += sizeof( edges ) + edges.count * ( sizeof( uint32_t ) + sizeof( uint8_t ) );
+            break;
+         }
+
+         case RECORD_SYNC_TIME:
+            if( !ext || h.source != 0 )
+               return 0;
+            break;
+
+         default:
+            return 0;
+      }
+
+      return len <= left ? len : 0;
+   }
+
+   // a record boundary at pos: a chain of valid records, up to the trailer
+   // or the end of the file
+   bool isBoundary( size_t pos )
+   {
+      for( int i = 0; i < 16 && pos < size; i++ )
+      {
+         bool trailer;
+         size_t len = recordLength( pos, &trailer );
+         if( len == 0 )
+            return false;
+         if( trailer )
+            return true;
+         pos += len;
+      }
+      return true;
+   }
+
+   size_t findBoundary( size_t pos )
+   {
+      while( pos < size && !isBoundary( pos ) )
+         pos++;
+      return pos;
+   }
+
+   // walk the chunk from c->begin up to the first record at or behind stop,
+   // with out pass 2 and the rows go into out
+   void walk( Chunk_t *c, size_t stop, Columns *out );
+};
+
+void BinaryDecoder::walk( Chunk_t *c, size_t stop, Columns *out )
+{
+   size_t pos = c->begin;
+   DecoderState_t state = c->state;
+   StateChange change;
+
+   memset( &c->counts, 0, sizeof( c->counts ) );
+   c->skipped = 0;
+   c->lost = 0;
+   c->last = false;
+
+   while( pos < stop )
+   {
+      bool trailer;
+      size_t len = recordLength( pos, &trailer );
+
+      if( len == 0 )
+      {
+         // not a record, a power loss or a damaged sector
+         size_t next = findBoundary( pos + 1 );
+         c->skipped += next - pos;
+         pos = next;
+         if( pos >= size )
+            c->last = true;
+         continue;
+      }
+
+      const uint8_t *p = base + pos;
+      RecordHeader_t h;
+      memcpy( &h, p, sizeof( h ) );
+      p += sizeof( h );
+
+      if( trailer )
+      {
+         memcpy( &this->trailer, p, sizeof( RecordTrailer_t ) );
+         hasTrailer = true;
+         c->last = true;
+         pos += len;
+         break;
+      }
+
+      if( h.timeDelta == RECORD_TIME_EXT )
+      {
+         uint32_t us;
+         memcpy( &us, p, sizeof( us ) );
+         p += sizeof( us );
+         change.ext( us );
+         state.time = unwrap( state.time, us );
+      }
+      else
+      {
+         change.delta( h.timeDelta );
+         state.time += h.timeDelta;
+      }
+
+      uint8_t analog = h.source & 0x3F;
+      uint8_t digital = h.source >> 8;
+      int64_t t = out ? rowTime( state.time ) : 0;
+
+      switch( h.sync )
+      {
+         case RECORD_SYNC:
+            for( int ch = 0; ch < 6; ch++ )
+            {
+               if( analog & ( 1 << ch ) )
+               {
+                  uint16_t v;
+                  memcpy( &v, p, sizeof( v ) );
+                  p += sizeof( v );
+                  c->counts.rows[ COL_A0 + ch ]++;
+                  if( out )
+                     out->row( COL_A0 + ch, t, v );
+               }
+            }
+            if( digital )
+            {
+               c->counts.rows[ COL_DIG ]++;
+               if( out )
+                  out->row( COL_DIG, t, *p );
+               p++;
+            }
+            for( int col = COL_SIO; col <= COL_I2C; col++ )
+            {
+               if( h.source & ( col == COL_SIO ? 0x40 : 0x80 ) )
+               {
+                  c->counts.rows[ col ]++;
+                  c->counts.bytes[ col ] += *p;
+                  if( out )
+                     out->data( col, t, p + 1, *p );
+                  p += 1 + *p;
+               }
+            }
+            break;
+
+         case RECORD_SYNC_ADC:
+         case RECORD_SYNC_ADC_DELTA:
+         {
+            AdcBlockHeader_t block;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block );
+
+            uint8_t channels = countBits( analog );
+            uint8_t pins[ 6 ];
+            for( int ch = 0, n = 0; ch < 6; ch++ )
+               if( analog & ( 1 << ch ) )
+                  pins[ n++ ] = ch;
+
+            // the scans of the block, at the end of the columns
+            uint16_t *values[ 6 ] = { NULL };
+            if( out )
+            {
+               for( uint8_t k = 0; k < channels; k++ )
+               {
+                  std::vector< uint16_t > &v = out->value[ COL_A0 + pins[ k ] ];
+                  v.resize( v.size() + block.scans );
+                  values[ k ] = v.data() + v.size() - block.scans;
+
+                  std::vector< int64_t > &tv = out->time[ COL_A0 + pins[ k ] ];
+                  for( uint8_t i = 0; i < block.scans; i++ )
+                     tv.push_back( t + ( int64_t )i * block.period );
+               }
+            }
+
+            if( h.sync == RECORD_SYNC_ADC )
+            {
+               if( out )
+                  deinterleave( p, block.scans, channels, values );
+            }
+            else
+            {
+               AdcDeltaHeader_t delta;
+               memcpy( &delta, p, sizeof( delta ) );
+               p += sizeof( delta );
+
+               // the previous values in the order of the block
+               uint16_t prev[ 6 ];
+               uint16_t *sum[ 6 ];
+               for( uint8_t k = 0; k < channels; k++ )
+               {
+                  if( delta.keyframe )
+                  {
+                     change.adcReset |= 1 << pins[ k ];
+                     change.adc[ pins[ k ] ] = 0;
+                     state.adc[ pins[ k ] ] = 0;
+                  }
+                  prev[ k ] = state.adc[ pins[ k ] ];
+                  sum[ k ] = &change.adc[ pins[ k ] ];
+               }
+
+               uint16_t before[ 6 ];
+               memcpy( before, prev, sizeof( before ) );
+               if( !decodeDeltas( p, delta.size, block.scans, channels, prev, out ? values : NULL ) )
+                  c->skipped += delta.size;
+
+               for( uint8_t k = 0; k < channels; k++ )
+               {
+                  *sum[ k ] += prev[ k ] - before[ k ];
+                  state.adc[ pins[ k ] ] = prev[ k ];
+               }
+            }
+
+            for( uint8_t k = 0; k < channels; k++ )
+               c->counts.rows[ COL_A0 + pins[ k ] ] += block.scans;
+            c->lost += block.lost;
+            break;
+         }
+
+         case RECORD_SYNC_EDGE:
+         {
+            EdgeBlockHeader_t block;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block );
+
+            // the lost pin changes are counted with the trailer
+            c->counts.rows[ COL_EDGE ] += block.count;
+            if( out )
+            {
+               for( uint8_t i = 0; i < block.count; i++, p += 5 )
+               {
+                  uint32_t us;
+                  memcpy( &us, p, sizeof( us ) );
+                  out->row( COL_EDGE, rowTime( unwrap( state.time, us ) ), p[ 4 ] );
+               }
+            }
+            break;
+         }
+
+         default:                      // RECORD_SYNC_TIME
+            break;
+      }
+
+      pos += len;
+   }
+
+   c->end = pos;
+   if( pos >= size )
+      c->last = true;
+   if( !out )
+      c->change = change;
+}
+
+// --------------------------------------------------------------------------
+// the text file
+// --------------------------------------------------------------------------
+
+class TextDecoder
+{
+private:
+   const char *base;
+   size_t size;
+
+   static bool isDigit( char c ) { return c >= '0' && c <= '9'; }
+   bool startsWith( size_t pos, const char *s, size_t n )
+   {
+      return size - pos >= n && memcmp( base + pos, s, n ) == 0;
+   }
+
+public:
+   uint8_t analogPin[ 6 ];    // the pins of the values of an ADC line
+   bool hasTrailer;
+
+   TextDecoder( const char *data, size_t len ) : base( data ), size( len ), hasTrailer( false )
+   {
+      for( int i = 0; i < 6; i++ )
+         analogPin[ i ] = i;
+   }
+
+   // a line which is a record, a lost line or the trailer
+   bool isLineStart( size_t pos )
+   {
+      const char *p = base + pos;
+      size_t left = size - pos;
+
+      if( left == 0 )
+         return true;
+      if( startsWith( pos, "ADC ", 4 ) || startsWith( pos, "DIG ", 4 ) || startsWith( pos, "Capture ", 8 ) )
+         return true;
+
+      // h:mm:ss.mmm or yyyy-mm-dd hh:mm:ss.mmm
+      size_t n = 0;
+      while( n < left && n < 5 && isDigit( p[ n ] ) )
+         n++;
+      return n > 0 && n < left && ( p[ n ] == ':' || p[ n ] == '-' );
+   }
+
+   size_t findBoundary( size_t pos )
+   {
+      // the line starts behind a '\n', the one in front of pos included
+      if( pos == 0 )
+         return 0;
+      for( pos--; pos < size; pos++ )
+      {
+         const char *nl = ( const char * )memchr( base + pos, '\n', size - pos );
+         if( nl == NULL )
+            return size;
+         pos = nl - base;
+         if( isLineStart( pos + 1 ) )
+            return pos + 1;
+      }
+      return size;
+   }
+
+   void walk( Chunk_t *c, size_t stop, Columns *out );
+
+private:
+   const char *parseStamp( const char *p, const char *end, int64_t *us );
+   const char *parseHex( const char *p, const char *end, uint8_t *v );
+};
+
+// days since 1970-01-01 of a date of the gregorian calendar
+static int64_t daysFromCivil( int64_t y, unsigned m, unsigned d )
+{
+   y -= m <= 2;
+   int64_t era = ( y >= 0 ? y : y - 399 ) / 400;
+   unsigned yoe = ( unsigned )( y - era * 400 );
+   unsigned doy = ( 153 * ( m + ( m > 2 ? -3 : 9 ) ) + 2 ) / 5 + d - 1;
+   unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+   return era * 146097 + ( int64_t )doe - 719468;
+}
+
+const char *TextDecoder::parseStamp( const char *p, const char *end, int64_t *us )
+{
+   uint64_t a, b, c, ms;
+
+   p = parseNumber( p, end, &a );
+   if( p < end && *p == '-' )
+   {
+      // yyyy-mm-dd hh:mm:ss.mmm, TextRecord::clock()
+      uint64_t month, day;
+      if( end - p < 20 )
+         return NULL;
+      p = parseNumber( p + 1, end, &month );
+      p = parseNumber( p + 1, end, &day );
+      p = parseNumber( p + 1, end, &b );
+      p = parseNumber( p + 1, end, &c );
+      uint64_t s;
+      p = parseNumber( p + 1, end, &s );
+      p = parseNumber( p + 1, end, &ms );
+      *us = ( ( daysFromCivil( a, month, day ) * 86400 + b * 3600 + c * 60 + s ) * 1000 + ms ) * 1000;
+      return p;
+   }
+
+   // h:mm:ss.mmm, TextRecord::time()
+   if( end - p < 10 || *p != ':' )
+      return NULL;
+   p = parseNumber( p + 1, end, &b );
+   if( *p != ':' )
+      return NULL;
+   p = parseNumber( p + 1, end, &c );
+   if( *p != '.' )
+      return NULL;
+   p = parseNumber( p + 1, end, &ms );
+   *us = ( ( a * 3600 + b * 60 + c ) * 1000 + ms ) * 1000;
+   return p;
+}
+
+const char *TextDecoder::parseHex( const char *p, const char *end, uint8_t *v )
+{
+   // " 0x1f"
+   if( end - p < 5 || p[ 0 ] != ' ' || p[ 1 ] != '0' || p[ 2 ] != 'x' )
+      return NULL;
+
+   uint8_t n = 0;
+   for( int i = 3; i < 5; i++ )
+   {
+      char ch = p[ i ];
+      n <<= 4;
+      if( isDigit( ch ) )
+         n |= ch - '0';
+      else if( ch >= 'a' && ch <= 'f' )
+         n |= ch - 'a' + 10;
+      else
+         return NULL;
+   }
+   *v = n;
+   return p + 5;
+}
+
+void TextDecoder::walk( Chunk_t *c, size_t stop, Columns *out )
+{
+   const char *p = base + c->begin;
+   const char *end = base + size;
+
+   memset( &c->counts, 0, sizeof( c->counts ) );
+   c->skipped = 0;
+   c->lost = 0;
+   c->last = false;
+
+   while( p < end && ( size_t )( p - base ) < stop )
+   {
+      const char *line = p;
+      size_t pos = p - base;
+
+      if( startsWith( pos, "Capture start time:", 19 ) )
+      {
+         hasTrailer = true;
+         c->last = true;
+         break;
+      }
+
+      if( startsWith( pos, "ADC ", 4 ) || startsWith( pos, "DIG ", 4 ) )
+      {
+         // "ADC 12 scans lost", "DIG 3 changes lost"
+         uint64_t n;
+         parseNumber( p + 4, end, &n );
+         c->lost += n;
+      }
+      else if( !startsWith( pos, "Capture ", 8 ) )
+      {
+         int64_t t;
+         p = parseStamp( p, end, &t );
+
+         while( p != NULL && p < end && *p == ' ' )
+         {
+            if( end - p >= 4 && memcmp( p, " ADC", 4 ) == 0 )
+            {
+               p += 4;
+               for( int k = 0; end - p >= 2 && p[ 0 ] == ' ' && isDigit( p[ 1 ] ); k++ )
+               {
+                  uint64_t v;
+                  p = parseNumber( p + 1, end, &v );
+                  if( k < 6 )
+                  {
+                     int col = COL_A0 + analogPin[ k ];
+                     c->counts.rows[ col ]++;
+                     if( out )
+                        out->row( col, t, v );
+                  }
+               }
+            }
+            else if( end - p >= 4 && memcmp( p, " DIG", 4 ) == 0 )
+            {
+               uint8_t v;
+               p = parseHex( p + 4, end, &v );
+               if( p == NULL )
+                  break;
+
+               // a pin change has the us of the timebase behind
+               int col = COL_DIG;
+               if( end - p >= 2 && p[ 0 ] == ' ' && isDigit( p[ 1 ] ) )
+               {
+                  uint64_t us;
+                  p = parseNumber( p + 1, end, &us );
+                  if( end - p >= 3 && memcmp( p, " us", 3 ) == 0 )
+                     p += 3;
+                  col = COL_EDGE;
+               }
+               c->counts.rows[ col ]++;
+               if( out )
+                  out->row( col, t, v );
+            }
+            else if( end - p >= 4 && memcmp( p, " I2C", 4 ) == 0 )
+            {
+               uint8_t frame[ 255 ];
+               uint8_t len = 0;
+               const char *q;
+               p += 4;
+               while( len < sizeof( frame ) && ( q = parseHex( p, end, &frame[ len ] ) ) != NULL )
+               {
+                  p = q;
+                  len++;
+               }
+               c->counts.rows[ COL_I2C ]++;
+               c->counts.bytes[ COL_I2C ] += len;
+               if( out )
+                  out->data( COL_I2C, t, frame, len );
+            }
+            else if( end - p >= 6 && memcmp( p, " SIO \"", 6 ) == 0 )
+            {
+               // the bytes as they are, up to the quote at the end of the
+               // line or in front of the next field
+               const char *data = p + 6;
+               const char *q = data;
+               const char *limit = std::min( end, data + 255 );
+               while( q < limit )
+               {
+                  q = ( const char * )memchr( q, '"', limit - q );
+                  if( q == NULL )
+                  {
+                     q = limit;
+                     break;
+                  }
+                  if( end - q >= 3 && q[ 1 ] == '\r' && q[ 2 ] == '\n' )
+                     break;
+                  if( end - q >= 5 && ( memcmp( q + 1, " ADC", 4 ) == 0 || memcmp( q + 1, " DIG", 4 ) == 0 ) )
+                     break;
+                  q++;
+               }
+               uint8_t len = q - data;
+               c->counts.rows[ COL_SIO ]++;
+               c->counts.bytes[ COL_SIO ] += len;
+               if( out )
+                  out->data( COL_SIO, t, ( const uint8_t * )data, len );
+               p = q < end ? q + 1 : q;
+            }
+            else
+               break;
+         }
+
+         if( p == NULL )
+         {
+            c->skipped += 1;
+            p = line;
+         }
+      }
+
+      // the end of the line
+      const char *nl = ( const char * )memchr( p, '\n', end - p );
+      p = nl ? nl + 1 : end;
+   }
+
+   c->end = p - base;
+   if( p >= end )
+      c->last = true;
+}
+
+// --------------------------------------------------------------------------
+// the output
+// --------------------------------------------------------------------------
+
+static char *formatInt( char *s, int64_t v )
+{
+   char tmp[ 24 ];
+   char *t = tmp + sizeof( tmp );
+   uint64_t u = v < 0 ? -( uint64_t )v : v;
+
+   do
+   {
+      *--t = '0' + u % 10;
+      u /= 10;
+   }
+   while( u );
+   if( v < 0 )
+      *--t = '-';
+
+   size_t n = tmp + sizeof( tmp ) - t;
+   memcpy( s, t, n );
+   return s + n;
+}
+
+static void formatCsv( const Columns &cols, int col, std::string *text )
+{
+   static const char hex[] = "0123456789abcdef";
+   const std::vector< int64_t > &time = cols.time[ col ];
+   const std::vector< uint16_t > &value = cols.value[ col ];
+   const uint8_t *bytes = cols.bytes[ col ].data();
+
+   text->clear();
+   text->reserve( time.size() * 16 + cols.bytes[ col ].size() * 2 );
+
+   char line[ 48 + 2 * 255 ];
+   for( size_t i = 0; i < time.size(); i++ )
+   {
+      char *s = formatInt( line, time[ i ] );
+      *s++ = ',';
+      s = formatInt( s, value[ i ] );
+      if( columnHasBytes( col ) )
+      {
+         *s++ = ',';
+         for( uint16_t k = 0; k < value[ i ]; k++ )
+         {
+            *s++ = hex[ bytes[ k ] >> 4 ];
+            *s++ = hex[ bytes[ k ] & 15 ];
+         }
+         bytes += value[ i ];
+      }
+      *s++ = '\n';
+      text->append( line, s - line );
+   }
+}
+
+class Output
+{
+private:
+   int csv[ NUM_COLUMNS ];
+   int col[ NUM_COLUMNS ];
+   uint64_t rows[ NUM_COLUMNS ];
+
+public:
+   bool writeCsv;
+   bool writeCol;
+
+   Output( void ) : writeCsv( true ), writeCol( true )
+   {
+      for( int i = 0; i < NUM_COLUMNS; i++ )
+         csv[ i ] = col[ i ] = -1;
+   }
+
+   ~Output( void )
+   {
+      for( int i = 0; i < NUM_COLUMNS; i++ )
+      {
+         if( csv[ i ] >= 0 )
+            close( csv[ i ] );
+         if( col[ i ] >= 0 )
+            close( col[ i ] );
+      }
+   }
+
+   bool create( const char *prefix, const Counts_t *total );
+   bool writeChunk( const Columns &cols, const Counts_t *start, std::string text[ NUM_COLUMNS ] );
+   bool appendCsv( std::string text[ NUM_COLUMNS ] );
+};
+
+static bool writeAll( int fd, const void *data, size_t len, off_t offset )
+{
+   const char *p = ( const char * )data;
+
+   while( len )
+   {
+      ssize_t n = offset < 0 ? write( fd, p, len ) : pwrite( fd, p, len, offset );
+      if( n <= 0 )
+         return false;
+      p += n;
+      len -= n;
+      if( offset >= 0 )
+         offset += n;
+   }
+   return true;
+}
+
+bool Output::create( const char *prefix, const Counts_t *total )
+{
+   for( int i = 0; i < NUM_COLUMNS; i++ )
+   {
+      rows[ i ] = total->rows[ i ];
+      if( rows[ i ] == 0 )
+         continue;
+
+      std::string path = std::string( prefix ) + "." + columnName[ i ];
+      if( writeCsv )
+      {
+         csv[ i ] = open( ( path + ".csv" ).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+         std::string head = std::string( "time_us," ) + ( columnHasBytes( i ) ? "len,data" : columnName[ i ] ) + "\n";
+         if( csv[ i ] < 0 || !writeAll( csv[ i ], head.data(), head.size(), -1 ) )
+            return false;
+      }
+
+      if( writeCol )
+      {
+         ColumnHeader_t h;
+         memset( &h, 0, sizeof( h ) );
+         memcpy( h.magic, COLUMN_MAGIC, sizeof( h.magic ) );
+         h.version = COLUMN_VERSION;
+         h.valueSize = columnValueSize[ i ];
+         h.hasBytes = columnHasBytes( i );
+         memcpy( h.name, columnName[ i ], strlen( columnName[ i ] ) );
+         h.rows = total->rows[ i ];
+         h.bytes = total->bytes[ i ];
+
+         off_t len = sizeof( h ) + h.rows * ( sizeof( int64_t ) + h.valueSize ) + h.bytes;
+         col[ i ] = open( ( path + ".col" ).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+         if( col[ i ] < 0 || ftruncate( col[ i ], len ) != 0 || !writeAll( col[ i ], &h, sizeof( h ), 0 ) )
+            return false;
+      }
+   }
+   return true;
+}
+
+// the binary columns at the rows of the chunk, from any thread
+bool Output::writeChunk( const Columns &cols, const Counts_t *start, std::string text[ NUM_COLUMNS ] )
+{
+   bool ok = true;
+
+   for( int i = 0; i < NUM_COLUMNS; i++ )
+   {
+      size_t n = cols.time[ i ].size();
+      if( n == 0 )
+         continue;
+
+      if( col[ i ] >= 0 )
+      {
+         uint8_t vs = columnValueSize[ i ];
+         off_t time_at = sizeof( ColumnHeader_t ) + start->rows[ i ] * sizeof( int64_t );
+         off_t value_at = sizeof( ColumnHeader_t ) + rows[ i ] * sizeof( int64_t ) + start->rows[ i ] * vs;
+         off_t bytes_at = sizeof( ColumnHeader_t ) + rows[ i ] * ( sizeof( int64_t ) + vs ) + start->bytes[ i ];
+
+         ok = ok && writeAll( col[ i ], cols.time[ i ].data(), n * sizeof( int64_t ), time_at );
+         if( vs == 2 )
+            ok = ok && writeAll( col[ i ], cols.value[ i ].data(), n * 2, value_at );
+         else
+         {
+            std::vector< uint8_t > v( cols.value[ i ].begin(), cols.value[ i ].end() );
+            ok = ok && writeAll( col[ i ], v.data(), n, value_at );
+         }
+         if( !cols.bytes[ i ].empty() )
+            ok = ok && writeAll( col[ i ], cols.bytes[ i ].data(), cols.bytes[ i ].size(), bytes_at );
+      }
+
+      if( csv[ i ] >= 0 )
+         formatCsv( cols, i, &text[ i ] );
+   }
+   return ok;
+}
+
+// the CSV text of a chunk, in the order of the chunks
+bool Output::appendCsv( std::string text[ NUM_COLUMNS ] )
+{
+   for( int i = 0; i < NUM_COLUMNS; i++ )
+   {
+      if( csv[ i ] >= 0 && !text[ i ].empty() && !writeAll( csv[ i ], text[ i ].data(), text[ i ].size(), -1 ) )
+         return false;
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// the two passes
+// --------------------------------------------------------------------------
+
+// run fn( i ) for i = 0 .. n - 1 on threads
+template< class Fn > static void parallel( size_t n, int threads, Fn fn )
+{
+   std::vector< std::thread > pool;
+   std::atomic< size_t > next( 0 );
+
+   for( int t = 0; t < threads && ( size_t )t < n; t++ )
+   {
+      pool.emplace_back( [ & ]( void )
+      {
+         size_t i;
+         while( ( i = next++ ) < n )
+            fn( i );
+      } );
+   }
+   for( std::thread &th : pool )
+      th.join();
+}
+
+template< class Decoder >
+static bool decode( Decoder *dec, size_t data_start, size_t size, DecoderState_t initial,
+                    size_t chunk_size, int threads, Output *out, const char *prefix, Counts_t *total,
+                    uint64_t *lost, uint64_t *skipped )
+{
+   // pass 1, the chunks in parallel
+   size_t num = ( size - data_start + chunk_size - 1 ) / chunk_size;
+   if( num == 0 )
+      num = 1;
+
+   std::vector< Chunk_t > chunks( num );
+   for( size_t i = 0; i < num; i++ )
+   {
+      chunks[ i ].start = data_start + i * chunk_size;
+      memset( &chunks[ i ].state, 0, sizeof( chunks[ i ].state ) );
+   }
+   chunks[ 0 ].state = initial;
+
+   parallel( num, threads, [ & ]( size_t i )
+   {
+      Chunk_t *c = &chunks[ i ];
+      c->begin = i == 0 ? data_start : dec->findBoundary( c->start );
+      dec->walk( c, i + 1 < num ? chunks[ i + 1 ].start : size, NULL );
+   } );
+
+   // the chunks which didn't start at the end of the previous one are
+   // walked again, the chunks behind the end of the records are empty
+   bool finished = false;
+   for( size_t i = 0; i < num; i++ )
+   {
+      Chunk_t *c = &chunks[ i ];
+      if( i > 0 )
+      {
+         Chunk_t *prev = &chunks[ i - 1 ];
+         if( finished )
+         {
+            c->begin = c->end = prev->end;
+            memset( &c->counts, 0, sizeof( c->counts ) );
+            c->change = StateChange();
+            c->lost = c->skipped = 0;
+            c->last = true;
+         }
+         else if( c->begin != prev->end )
+         {
+            c->begin = prev->end;
+            dec->walk( c, std::max( c->begin, i + 1 < num ? chunks[ i + 1 ].start : size ), NULL );
+         }
+      }
+      finished = finished || c->last;
+   }
+
+   // the state at the start of each chunk, and the first rows
+   std::vector< Counts_t > start( num );
+   memset( total, 0, sizeof( *total ) );
+   *lost = *skipped = 0;
+   for( size_t i = 0; i < num; i++ )
+   {
+      start[ i ] = *total;
+      for( int col = 0; col < NUM_COLUMNS; col++ )
+      {
+         total->rows[ col ] += chunks[ i ].counts.rows[ col ];
+         total->bytes[ col ] += chunks[ i ].counts.bytes[ col ];
+      }
+      *lost += chunks[ i ].lost;
+      *skipped += chunks[ i ].skipped;
+
+      if( i + 1 < num )
+      {
+         chunks[ i + 1 ].state = chunks[ i ].state;
+         chunks[ i ].change.apply( &chunks[ i + 1 ].state );
+      }
+   }
+
+   if( !out->create( prefix, total ) )
+      return false;
+
+   // pass 2, in batches of the threads, the CSV in the order of the chunks
+   bool ok = true;
+   for( size_t first = 0; first < num && ok; first += threads )
+   {
+      size_t n = std::min( num - first, ( size_t )threads );
+      std::vector< std::vector< std::string > > text( n, std::vector< std::string >( NUM_COLUMNS ) );
+      std::vector< char > done( n, 1 );
+
+      parallel( n, threads, [ & ]( size_t k )
+      {
+         Chunk_t c = chunks[ first + k ];
+         Columns cols;
+         dec->walk( &c, chunks[ first + k ].end, &cols );
+         done[ k ] = out->writeChunk( cols, &start[ first + k ], text[ k ].data() );
+      } );
+
+      for( size_t k = 0; k < n && ok; k++ )
+         ok = done[ k ] && out->appendCsv( text[ k ].data() );
+   }
+   return ok;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static int configAnalog( const char *path )
+{
+   // the analog pins of CaptureSource in the config.txt in the directory of
+   // the capture file, a mask like Source_t.analog, -1 without this setting.
+   // As in setCaptureSource() of Config.cpp, I2C takes the pins A4 and A5.
+
+   std::string dir( path );
+   size_t slash = dir.rfind( '/' );
+   dir.erase( slash == std::string::npos ? 0 : slash + 1 );
+
+   FILE *f = fopen( ( dir + "config.txt" ).c_str(), "r" );
+   if( f == NULL )
+      f = fopen( ( dir + "CONFIG.TXT" ).c_str(), "r" );
+   if( f == NULL )
+      return -1;
+
+   int analog = -1;
+   bool i2c = false;
+   char line[ 256 ];
+   while( fgets( line, sizeof( line ), f ) )
+   {
+      if( strncasecmp( line, "CaptureSource", 13 ) != 0 || ( line[ 13 ] != ' ' && line[ 13 ] != '\t' ) )
+         continue;
+
+      char *comment = strchr( line, '#' );
+      if( comment )
+         *comment = '\0';
+
+      analog = 0;
+      i2c = false;
+      for( char *tok = strtok( line + 13, " \t,\r\n" ); tok; tok = strtok( NULL, " \t,\r\n" ) )
+      {
+         if( strcasecmp( tok, "I2C" ) == 0 )
+            i2c = true;
+         else if( ( tok[ 0 ] == 'A' || tok[ 0 ] == 'a' ) && tok[ 1 ] >= '0' && tok[ 1 ] <= '5' && tok[ 2 ] == '\0' )
+            analog |= 1 << ( tok[ 1 ] - '0' );
+      }
+   }
+   fclose( f );
+
+   if( i2c && analog > 0 )
+      analog &= ~0x30;
+   return analog;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static void usage( const char *name )
+{
+   fprintf( stderr,
+            "usage: %s [options] file\n"
+            "  -o prefix   of the output files, default the file without extension\n"
+            "  -f format   csv, col or both, default both\n"
+            "  -j n        threads, default the number of cores\n"
+            "  -b MB       size of a chunk, default 8\n"
+            "  -a pins     analog pins of the values of a text file, default those of\n"
+            "              CaptureSource in the config.txt next to the file\n"
+            "  -q          no statistics\n",
+            name );
+}
+
+int main( int argc, char *argv[] )
+{
+   const char *prefix = NULL;
+   const char *pins = NULL;
+   int threads = std::thread::hardware_concurrency();
+   size_t chunk_size = 8 << 20;
+   bool quiet = false;
+   Output out;
+   int opt;
+
+   while( ( opt = getopt( argc, argv, "o:f:j:b:a:qh" ) ) != -1 )
+   {
+      switch( opt )
+      {
+         case 'o': prefix = optarg; break;
+         case 'f':
+            out.writeCsv = strcmp( optarg, "col" ) != 0;
+            out.writeCol = strcmp( optarg, "csv" ) != 0;
+            break;
+         case 'j': threads = atoi( optarg ); break;
+         case 'b': chunk_size = ( size_t )( atof( optarg ) * ( 1 << 20 ) ); break;
+         case 'a': pins = optarg; break;
+         case 'q': quiet = true; break;
+         default:
+            usage( argv[ 0 ] );
+            return 1;
+      }
+   }
+
+   if( optind != argc - 1 )
+   {
+      usage( argv[ 0 ] );
+      return 1;
+   }
+   if( threads < 1 )
+      threads = 1;
+   if( chunk_size < 4096 )
+      chunk_size = 4096;
+
+#ifdef HAVE_SSE2
+   haveSsse3 = __builtin_cpu_supports( "ssse3" );
+#endif
+
+   const char *path = argv[ optind ];
+   std::string name = prefix ? prefix : path;
+   if( !prefix )
+   {
+      size_t dot = name.rfind( '.' );
+      if( dot != std::string::npos && name.find( '/', dot ) == std::string::npos )
+         name.erase( dot );
+   }
+
+   int fd = open( path, O_RDONLY );
+   struct stat st;
+   if( fd < 0 || fstat( fd, &st ) != 0 )
+   {
+      fprintf( stderr, "can't open <%s>\n", path );
+      return 1;
+   }
+   size_t size = st.st_size;
+   if( size == 0 )
+   {
+      fprintf( stderr, "<%s> is empty\n", path );
+      return 1;
+   }
+
+   const char *data = ( const char * )mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+   if( data == MAP_FAILED )
+   {
+      fprintf( stderr, "can't map <%s>\n", path );
+      return 1;
+   }
+   madvise( ( void * )data, size, MADV_WILLNEED );
+
+   struct timespec from, to;
+   clock_gettime( CLOCK_MONOTONIC, &from );
+
+   Counts_t total;
+   uint64_t lost, skipped;
+   bool ok, binary, trailer;
+   bool positional = false;
+
+   BinaryDecoder bin( ( const uint8_t * )data, size );
+   if( bin.valid() )
+   {
+      binary = true;
+      ok = decode( &bin, bin.dataStart(), size, bin.initialState(), chunk_size, threads,
+                   &out, name.c_str(), &total, &lost, &skipped );
+      trailer = bin.hasTrailer;
+      if( trailer )
+      {
+         lost += bin.trailer.i2cLost + bin.trailer.edgesLost;
+      }
+   }
+   else
+   {
+      TextDecoder text( data, size );
+      int analog = pins ? -1 : configAnalog( path );
+      if( analog > 0 )
+      {
+         // the values of a line are in the order of the pins
+         int k = 0;
+         for( int pin = 0; pin < 6; pin++ )
+         {
+            if( analog & ( 1 << pin ) )
+               text.analogPin[ k++ ] = pin;
+         }
+      }
+      else if( pins == NULL )
+         positional = true;
+
+      for( int k = 0; pins && *pins && k < 6; k++ )
+      {
+         // A3 or 3
+         if( *pins == 'A' || *pins == 'a' )
+            pins++;
+         int pin = strtol( pins, ( char ** )&pins, 10 );
+         text.analogPin[ k ] = pin >= 0 && pin < 6 ? pin : k;
+         if( *pins == ',' )
+            pins++;
+      }
+
+      DecoderState_t initial;
+      memset( &initial, 0, sizeof( initial ) );
+      binary = false;
+      ok = decode( &text, 0, size, initial, chunk_size, threads,
+                   &out, name.c_str(), &total, &lost, &skipped );
+      trailer = text.hasTrailer;
+   }
+
+   clock_gettime( CLOCK_MONOTONIC, &to );
+   munmap( ( void * )data, size );
+
+   if( !ok )
+   {
+      fprintf( stderr, "can't write the output <%s.*>\n", name.c_str() );
+      return 1;
+   }
+
+   if( positional )
+   {
+      for( int i = COL_A0; i <= COL_A5; i++ )
+      {
+         if( total.rows[ i ] )
+         {
+            fprintf( stderr, "no CaptureSource in a config.txt next to <%s>, the ADC columns are\n"
+                             "A0, A1, .. in the order of the values, see -a\n", path );
+            break;
+         }
+      }
+   }
+
+   if( !quiet )
+   {
+      double s = ( to.tv_sec - from.tv_sec ) + ( to.tv_nsec - from.tv_nsec ) * 1e-9;
+      fprintf( stderr, "%s, %s, %lu bytes, %d threads, %.3f s, %.1f MB/s\n",
+               path, binary ? "binary" : "text", ( unsigned long )size, threads, s, size / s / 1e6 );
+      for( int i = 0; i < NUM_COLUMNS; i++ )
+      {
+         if( total.rows[ i ] )
+            fprintf( stderr, "%-6s %12lu rows\n", columnName[ i ], ( unsigned long )total.rows[ i ] );
+      }
+      if( lost )
+         fprintf( stderr, "lost   %12lu samples\n", ( unsigned long )lost );
+      if( skipped )
+         fprintf( stderr, "skipped %11lu bytes, not a record\n", ( unsigned long )skipped );
+      if( !trailer )
+         fprintf( stderr, "no trailer, the capture wasn't stopped\n" );
+   }
+   return 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          main.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   files of the image with HostCard.cpp
+// 2026-10-18  AWe   latency profile and mmap of the image
+// 2026-10-18  AWe   initial version, run the firmware on the host
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <unistd.h>
+#include <getopt.h>
+
+#include "WArduino.h"
+#include "Simulation.h"
+#include "SdCardSim.h"
+#include "ImageBlockDevice.h"
+#include "HostCard.h"
+
+#include "DataLogger_config.h"         // BTN_Pin
+
+// --------------------------------------------------------------------------
+// The DataLogger on the host.
+//
+// The sd card is an image file, which can be mounted on the host. A new
+// image is formatted with SdFat like the SdFormatter example does it. The
+// button starts and stops the capture, the output of the usart is stdout.
+// --------------------------------------------------------------------------
+
+#define BUTTON_PRESS_MS    100
+
+static void usage( const char *name )
+{
+   fprintf( stderr,
+            "usage: %s [options]\n"
+            "  -i image    image of the sd card, default sdcard.img\n"
+            "  -n MB       create and format a new image of this size\n"
+            "  -m          map the image into the memory\n"
+            "  -l profile  latency of the card: none, fast, typical, slow, default none\n"
+            "  -c file     copy the file to config.txt of the image\n"
+            "  -t s        virtual run time, default 10\n"
+            "  -s s        press the button to start the capture, default 3\n"
+            "  -e s        press the button to stop the capture, default run time - 1\n"
+            "  -x dir      copy the files of the image to dir after the run\n"
+            "  -p          print the high times of the output pins\n"
+            "  -q          no output of the usart\n",
+            name );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+int main( int argc, char *argv[] )
+{
+   const char *image_path = "sdcard.img";
+   const char *config_path = NULL;
+   const char *extract_dir = NULL;
+   uint32_t image_mb = 0;
+   double run_time = 10.0;
+   double start_time = 3.0;
+   double stop_time = -1.0;
+   bool print_scope = false;
+   bool mapped = false;
+   const SdLatency_t *latency = sdLatencyProfile( "none" );
+   int opt;
+
+   while( ( opt = getopt( argc, argv, "i:n:ml:c:t:s:e:x:pqh" ) ) != -1 )
+   {
+      switch( opt )
+      {
+         case 'i': image_path = optarg; break;
+         case 'n': image_mb = strtoul( optarg, NULL, 0 ); break;
+         case 'm': mapped = true; break;
+         case 'l':
+            latency = sdLatencyProfile( optarg );
+            if( latency == NULL )
+            {
+               fprintf( stderr, "unknown latency profile <%s>\n", optarg );
+               return 1;
+            }
+            break;
+         case 'c': config_path = optarg; break;
+         case 't': run_time = atof( optarg ); break;
+         case 's': start_time = atof( optarg ); break;
+         case 'e': stop_time = atof( optarg ); break;
+         case 'x': extract_dir = optarg; break;
+         case 'p': print_scope = true; break;
+         case 'q': sim.uartOutput = []( uint8_t c ) { ( void )c; }; break;
+         default:
+            usage( argv[ 0 ] );
+            return 1;
+      }
+   }
+
+   if( stop_time < 0 )
+      stop_time = run_time - 1.0;
+
+   ImageBlockDevice image;
+   if( !image.open( image_path, ( uint64_t )image_mb << 20, mapped ) )
+   {
+      fprintf( stderr, "can't open image <%s>\n", image_path );
+      return 1;
+   }
+   sdCardSim.insert( &image );
+
+   if( image_mb && !hostFormatCard() )
+   {
+      fprintf( stderr, "can't format image <%s>\n", image_path );
+      return 1;
+   }
+
+   if( config_path && !hostCopyFile( config_path, "config.txt" ) )
+   {
+      fprintf( stderr, "can't copy <%s> to the image\n", config_path );
+      return 1;
+   }
+
+   // the firmware starts at time 0 with a fresh card, the preparation
+   // of the image was done without latency
+   sim.powerOn();
+   image.setLatency( latency );
+   memset( &sdCardSim.stats, 0, sizeof( sdCardSim.stats ) );
+
+   if( start_time >= 0 )
+      sim.press( BTN_Pin, start_time * SIM_NS_PER_S, BUTTON_PRESS_MS * SIM_NS_PER_MS );
+   if( stop_time > start_time )
+      sim.press( BTN_Pin, stop_time * SIM_NS_PER_S, BUTTON_PRESS_MS * SIM_NS_PER_MS );
+
+   uint64_t end = run_time * SIM_NS_PER_S;
+
+   setup();
+   while( sim.nanos() < end )
+      loop();
+
+   fflush( stdout );
+   fprintf( stderr, "\n" );
+   fprintf( stderr, "virtual time   %10.3f s\n", sim.nanos() / ( double )SIM_NS_PER_S );
+   fprintf( stderr, "isr            %10lu calls, %6.2f%% of the cpu\n",
+            ( unsigned long )sim.isrCount, 100.0 * sim.isrNs / sim.nanos() );
+   fprintf( stderr, "sd commands    %10lu\n", ( unsigned long )sdCardSim.stats.commands );
+   fprintf( stderr, "sectors read   %10lu\n", ( unsigned long )sdCardSim.stats.sectorsRead );
+   fprintf( stderr, "sectors write  %10lu\n", ( unsigned long )sdCardSim.stats.sectorsWritten );
+   fprintf( stderr, "busy bytes     %10lu, %.3f ms\n", ( unsigned long )sdCardSim.stats.busyBytes,
+            sdCardSim.stats.waitNs / ( double )SIM_NS_PER_MS );
+   fprintf( stderr, "card latency   %10s\n", latency->name );
+   fprintf( stderr, "card commands  %10lu\n", ( unsigned long )image.stats.commands );
+   fprintf( stderr, "AU opens       %10lu\n", ( unsigned long )image.stats.auOpens );
+   fprintf( stderr, "gc stalls      %10lu\n", ( unsigned long )image.stats.gcStalls );
+   fprintf( stderr, "card busy      %10.3f ms, max %.3f ms\n",
+            image.stats.busyNs / ( double )SIM_NS_PER_MS, image.stats.maxBusyNs / ( double )SIM_NS_PER_MS );
+
+   if( print_scope )
+      sim.printScope( stderr );
+
+   if( extract_dir && !hostExtractFiles( extract_dir, true ) )
+   {
+      fprintf( stderr, "can't read the files of the image\n" );
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,1291 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          replay.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   read the dropped samples line of the text file
+// 2026-10-18  AWe   lost pin changes from the trailer
+// 2026-10-18  AWe   initial version, replay of input traces into the capture
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "WArduino.h"
+#include "Simulation.h"
+#include "SdCardSim.h"
+#include "ImageBlockDevice.h"
+#include "HostCard.h"
+#include "HostCapture.h"
+
+#include "DataLogger_config.h"
+#include "DataLogger.h"                // flags
+#include "Config.h"                    // settings
+#include "Capture.h"
+#include "Record.h"
+
+extern Capture capture;
+
+// --------------------------------------------------------------------------
+// Replay of an input trace into the capture.
+//
+// A trace holds the inputs of the data logger with their times: the bytes
+// of the serial port, the i2c frames, the values of the analog inputs and
+// the levels of the digital pins. The inputs are fed into the simulation
+// of the ATmega328P at these times, while the firmware captures them like
+// on the board. So an overload seen in the field, e.g. a serial burst while
+// the card stalls for a garbage collection, happens again with the same
+// timing, as often as needed, and two settings of the capture can be
+// compared on the same input.
+//
+// The trace is a text file, one event per line, the times in us since the
+// start of the capture, in ascending order:
+//
+//    # a comment
+//    config SyncSize 4K          a line of config.txt for the replay
+//    0        adc A0 512         value of an analog input, held until the next one
+//    1000     pin D7 1           level of a digital pin
+//    2000     uart "$GPGGA,1*\r\n"  bytes on the serial port, at the baud rate,
+//    2500     uart 24 47 0d 0a     as a C string or as hex bytes
+//    3000     i2c 00 01 02       a frame of the i2c master
+//    3000     stall 40000        the card is busy for 40000 us
+//    10000000 end                end of the replay, else 1 s after the last event
+//
+// A trace is recorded by the data logger itself: a binary capture file of
+// the inputs is converted into a trace with -r. The times of a serial burst
+// are those of its record, when the burst was complete.
+//
+// Each run replays the whole trace into a new image, with the settings of
+// config.txt: the defaults below, the config lines of the trace and of the
+// file given with -c. Several -c files and latency profiles give several
+// runs, each one in a child process, like the runs of capturebench. For a
+// comparison of compile time settings, e.g. CAPTURE_BUFFER_SIZE, build a
+// second tracereplay, see the Makefile.
+//
+// The replay runs as fast as possible, or with -x at a speed relative to
+// the real time, 1 is the real time.
+// --------------------------------------------------------------------------
+
+#define REPLAY_LOOKAHEAD_NS   ( 10 * SIM_NS_PER_MS )    // events scheduled ahead of the time
+#define REPLAY_TAIL_US        1000000ULL                // us after the last event
+#define REPLAY_IMAGE_MB       256
+#define REPLAY_FILE_MB        64
+
+enum
+{
+   EVENT_UART,
+   EVENT_I2C,
+   EVENT_ADC,
+   EVENT_PIN,
+   EVENT_STALL,
+   EVENT_END
+};
+
+typedef struct
+{
+   uint64_t us;
+   uint8_t  kind;
+   uint8_t  pin;                       // digital pin of EVENT_PIN, channel of EVENT_ADC
+   uint32_t value;                     // level, adc value, us of a stall
+   std::vector< uint8_t > data;        // bytes of EVENT_UART, EVENT_I2C
+} TraceEvent_t;
+
+typedef struct
+{
+   const char *config;                 // -c file, NULL for the trace alone
+   const SdLatency_t *latency;
+} ReplayRun_t;
+
+typedef struct
+{
+   bool     ok;
+   char     error[ 96 ];
+
+   double   seconds;                   // virtual time of the capture
+   double   hostSeconds;               // wall time of the replay
+   uint64_t events;
+   uint64_t bytes;                     // size of the capture file
+   uint64_t samples;                   // records, lines of a text file
+   uint64_t droppedBytes;              // ring buffer full
+   uint32_t highWater;                 // max bytes in the ring buffer
+   uint64_t sioOverflow;
+   uint64_t i2cLost;
+   uint64_t adcLost;                   // adc scans
+   uint64_t edgesLost;                 // pin changes
+   uint32_t syncCount;
+   uint32_t maxAtRisk;
+   double   runMaxUs;                  // longest call of Capture::run()
+   double   cardBusyMs;
+   uint32_t gcStalls;                  // of the latency model and of the trace
+} ReplayResult_t;
+
+static const char *tracePath;
+static std::vector< std::string > traceConfig;
+static std::string traceSources;
+static uint64_t traceEndUs;
+static bool binaryFile = true;
+static double replaySpeed = 0.0;
+static bool verbose = false;
+static const char *imageDir = "/tmp";
+static const char *keepDir = NULL;
+
+// --------------------------------------------------------------------------
+// the trace
+// --------------------------------------------------------------------------
+
+class TraceReader
+{
+private:
+   FILE    *file;
+   char    *buf;
+   size_t   size;
+   unsigned line;
+   uint64_t last;
+
+   bool fail( const char *what );
+   bool parseBytes( const char *p, std::vector< uint8_t > *data );
+
+public:
+   std::string error;
+   std::vector< std::string > config;  // the config lines up to here
+
+   TraceReader( void ) : file( NULL ), buf( NULL ), size( 0 ), line( 0 ), last( 0 ) {}
+   ~TraceReader( void ) { if( file ) fclose( file ); free( buf ); }
+
+   bool open( const char *path );
+   bool next( TraceEvent_t *ev );
+};
+
+bool TraceReader::open( const char *path )
+{
+   file = fopen( path, "r" );
+   if( file == NULL )
+      error = std::string( "can't open " ) + path;
+   return file != NULL;
+}
+
+bool TraceReader::fail( const char *what )
+{
+   char buf[ 128 ];
+   snprintf( buf, sizeof( buf ), "line %u: %s", line, what );
+   error = buf;
+   return false;
+}
+
+// "text" with the escapes of C, or hex bytes
+bool TraceReader::parseBytes( const char *p, std::vector< uint8_t > *data )
+{
+   data->clear();
+   while( *p == ' ' || *p == '\t' )
+      p++;
+
+   if( *p == '"' )
+   {
+      for( p++; *p && *p != '"'; p++ )
+      {
+         if( *p != '\\' )
+         {
+            data->push_back( *p );
+            continue;
+         }
+         switch( *++p )
+         {
+            case 'r':  data->push_back( '\r' ); break;
+            case 'n':  data->push_back( '\n' ); break;
+            case 't':  data->push_back( '\t' ); break;
+            case '0':  data->push_back( 0 ); break;
+            case 'x':
+            {
+               char *end;
+               char hex[ 3 ] = { p[ 1 ], p[ 1 ] ? p[ 2 ] : '\0', '\0' };
+               data->push_back( strtoul( hex, &end, 16 ) );
+               if( end == hex )
+                  return fail( "\\x without hex digits" );
+               p += end - hex;
+               break;
+            }
+            case 0:    return fail( "\\ at the end of the line" );
+            default:   data->push_back( *p ); break;
+         }
+      }
+      return *p == '"' ? true : fail( "missing \"" );
+   }
+
+   while( *p )
+   {
+      char *end;
+      unsigned long v = strtoul( p, &end, 16 );
+      if( end == p || v > 0xFF )
+         return fail( "not a hex byte" );
+      data->push_back( v );
+      for( p = end; *p == ' ' || *p == '\t'; p++ )
+         ;
+   }
+   return true;
+}
+
+bool TraceReader::next( TraceEvent_t *ev )
+{
+   // a continuous serial stream is one long line
+   while( getline( &buf, &size, file ) >= 0 )
+   {
+      line++;
+      buf[ strcspn( buf, "\r\n" ) ] = '\0';
+
+      char *p = buf;
+      while( *p == ' ' || *p == '\t' )
+         p++;
+      if( *p == '\0' || *p == '#' )
+         continue;
+
+      if( strncmp( p, "config ", 7 ) == 0 )
+      {
+         config.push_back( p + 7 );
+         continue;
+      }
+
+      char *end;
+      ev->us = strtoull( p, &end, 10 );
+      if( end == p )
+         return fail( "missing time" );
+      if( ev->us < last )
+         return fail( "time before the previous event" );
+      last = ev->us;
+
+      char kind[ 16 ];
+      int n = 0;
+      if( sscanf( end, " %15s %n", kind, &n ) != 1 )
+         return fail( "missing event" );
+      p = end + n;
+
+      ev->pin = 0;
+      ev->value = 0;
+      ev->data.clear();
+
+      if( strcmp( kind, "uart" ) == 0 || strcmp( kind, "i2c" ) == 0 )
+      {
+         ev->kind = kind[ 0 ] == 'u' ? EVENT_UART : EVENT_I2C;
+         if( !parseBytes( p, &ev->data ) )
+            return false;
+         if( ev->data.empty() )
+            return fail( "no bytes" );
+         if( ev->kind == EVENT_I2C && ev->data.size() > 255 )
+            return fail( "i2c frame longer than 255 bytes" );
+      }
+      else if( strcmp( kind, "adc" ) == 0 || strcmp( kind, "pin" ) == 0 )
+      {
+         char name;
+         unsigned pin, value;
+         bool adc = kind[ 0 ] == 'a';
+         if( sscanf( p, "%c%u %u", &name, &pin, &value ) != 3 || name != ( adc ? 'A' : 'D' ) )
+            return fail( adc ? "expected adc A<n> <value>" : "expected pin D<n> <level>" );
+         if( adc ? pin > 5 || value > 1023 : pin >= NUM_DIGITAL_PINS || value > 1 )
+            return fail( "pin or value out of range" );
+         ev->kind = adc ? EVENT_ADC : EVENT_PIN;
+         ev->pin = pin;
+         ev->value = value;
+      }
+      else if( strcmp( kind, "stall" ) == 0 )
+      {
+         ev->kind = EVENT_STALL;
+         ev->value = strtoul( p, &end, 10 );
+         if( end == p )
+            return fail( "expected stall <us>" );
+      }
+      else if( strcmp( kind, "end" ) == 0 )
+         ev->kind = EVENT_END;
+      else
+         return fail( "unknown event" );
+      return true;
+   }
+   return false;
+}
+
+// the config lines, the sources and the length of the trace, checks the
+// whole trace before the runs start
+static bool scanTrace( uint64_t *events )
+{
+   TraceReader reader;
+   TraceEvent_t ev;
+   uint8_t analog = 0;
+   uint8_t digital = 0;
+   bool sio = false;
+   bool i2c = false;
+   bool end = false;
+
+   *events = 0;
+   traceEndUs = 0;
+   if( !reader.open( tracePath ) )
+   {
+      fprintf( stderr, "%s\n", reader.error.c_str() );
+      return false;
+   }
+
+   while( !end && reader.next( &ev ) )
+   {
+      ( *events )++;
+      traceEndUs = ev.us;
+      switch( ev.kind )
+      {
+         case EVENT_UART: sio = true; break;
+         case EVENT_I2C:  i2c = true; break;
+         case EVENT_ADC:  analog |= 1 << ev.pin; break;
+         case EVENT_PIN:  if( ev.pin < 8 ) digital |= 1 << ev.pin; break;
+         case EVENT_END:  end = true; break;
+      }
+   }
+   if( !reader.error.empty() )
+   {
+      fprintf( stderr, "%s: %s\n", tracePath, reader.error.c_str() );
+      return false;
+   }
+   if( !end )
+      traceEndUs += REPLAY_TAIL_US;
+
+   traceConfig = reader.config;
+
+   // the pins of the usart and of the twi aren't captured as digital pins
+   traceSources.clear();
+   if( sio )
+      traceSources += "SIO, ";
+   if( i2c )
+      traceSources += "I2C, ";
+   for( int i = 0; i < 6; i++ )
+      if( analog & ( 1 << i ) )
+         traceSources += std::string( "A" ) + char( '0' + i ) + " ";
+   for( int i = 2; i < 8; i++ )
+      if( digital & ( 1 << i ) )
+         traceSources += std::string( "D" ) + char( '0' + i ) + " ";
+   while( !traceSources.empty() && ( traceSources.back() == ' ' || traceSources.back() == ',' ) )
+      traceSources.erase( traceSources.size() - 1 );
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// a binary capture file
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   uint8_t  sync;
+   uint16_t source;
+   int64_t  time;                      // us of the timebase, unwrapped
+   const uint8_t *data;                // behind the header and the time
+} CaptureRecord_t;
+
+// the records of a binary capture file in their order, up to the trailer
+class CaptureReader
+{
+private:
+   const uint8_t *p;
+   const uint8_t *end;
+   int64_t time;
+
+public:
+   FileHeader_t header;
+   RecordTrailer_t trailer;
+   bool hasTrailer;
+
+   CaptureReader( const std::vector< uint8_t > &file );
+   bool valid( void ) { return p != NULL; }
+   bool next( CaptureRecord_t *rec );
+};
+
+CaptureReader::CaptureReader( const std::vector< uint8_t > &file ) : p( NULL ), end( NULL ), time( 0 ), hasTrailer( false )
+{
+   memset( &header, 0, sizeof( header ) );
+   memset( &trailer, 0, sizeof( trailer ) );
+   memcpy( &header, file.data(), std::min( file.size(), sizeof( header ) ) );
+
+   if( file.size() >= 6 && memcmp( header.magic, RECORD_MAGIC, 4 ) == 0 && header.headerSize <= file.size() )
+   {
+      p = file.data() + header.headerSize;
+      end = file.data() + file.size();
+      time = header.partMicros;
+   }
+}
+
+bool CaptureReader::next( CaptureRecord_t *rec )
+{
+   RecordHeader_t h;
+
+   if( p == NULL || end - p < ( long )sizeof( h ) )
+      return false;
+   memcpy( &h, p, sizeof( h ) );
+   const uint8_t *q = p + sizeof( h );
+
+   if( ( h.sync == RECORD_SYNC || h.sync == RECORD_SYNC_RECOVERED ) && h.source == 0 )
+   {
+      if( end - q >= ( long )sizeof( trailer ) )
+      {
+         memcpy( &trailer, q, sizeof( trailer ) );
+         hasTrailer = true;
+      }
+      return false;
+   }
+
+   if( h.timeDelta == RECORD_TIME_EXT )
+   {
+      uint32_t us;
+      if( end - q < 4 )
+         return false;
+      memcpy( &us, q, sizeof( us ) );
+      q += sizeof( us );
+      time += ( int32_t )( us - ( uint32_t )time );
+   }
+   else
+      time += h.timeDelta;
+
+   // the length of the data
+   uint8_t channels = __builtin_popcount( h.source & 0x3F );
+   long len = 0;
+   switch( h.sync )
+   {
+      case RECORD_SYNC:
+         len = channels * 2 + ( ( h.source >> 8 ) ? 1 : 0 );
+         for( uint16_t bit = 0x40; bit <= 0x80; bit <<= 1 )
+         {
+            if( ( h.source & bit ) && len < end - q )
+               len += 1 + q[ len ];
+         }
+         break;
+
+      case RECORD_SYNC_ADC:
+      case RECORD_SYNC_ADC_DELTA:
+      {
+         AdcBlockHeader_t block;
+         if( end - q < ( long )( sizeof( block ) + sizeof( AdcDeltaHeader_t ) ) )
+            return false;
+         memcpy( &block, q, sizeof( block ) );
+         len = sizeof( block );
+         if( h.sync == RECORD_SYNC_ADC )
+            len += block.scans * channels * 2;
+         else
+            len += sizeof( AdcDeltaHeader_t ) + ( ( const AdcDeltaHeader_t * )( q + len ) )->size;
+         break;
+      }
+
+      case RECORD_SYNC_EDGE:
+         if( end - q < ( long )sizeof( EdgeBlockHeader_t ) )
+            return false;
+         len = sizeof( EdgeBlockHeader_t ) + q[ 0 ] * 5;
+         break;
+
+      case RECORD_SYNC_TIME:
+         break;
+
+      default:                         // damaged, e.g. a power loss
+         return false;
+   }
+   if( len > end - q )
+      return false;
+
+   rec->sync = h.sync;
+   rec->source = h.source;
+   rec->time = time;
+   rec->data = q;
+   p = q + len;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// a binary capture file into a trace
+// --------------------------------------------------------------------------
+
+static void addPins( std::vector< TraceEvent_t > *events, int64_t us, uint8_t mask, uint8_t state )
+{
+   for( uint8_t i = 0; i < 8; i++ )
+   {
+      if( mask & ( 1 << i ) )
+      {
+         TraceEvent_t ev;
+         ev.us = us;
+         ev.kind = EVENT_PIN;
+         ev.pin = i;
+         ev.value = ( state >> i ) & 1;
+         events->push_back( ev );
+      }
+   }
+}
+
+static void addAdc( std::vector< TraceEvent_t > *events, int64_t us, uint8_t channel, uint16_t value )
+{
+   TraceEvent_t ev;
+   ev.us = us;
+   ev.kind = EVENT_ADC;
+   ev.pin = channel;
+   ev.value = std::min( value, ( uint16_t )1023 );   // values with OversamplingBits
+   events->push_back( ev );
+}
+
+static void printBytes( FILE *out, const std::vector< uint8_t > &data, bool text )
+{
+   if( !text )
+   {
+      for( uint8_t c : data )
+         fprintf( out, " %02x", c );
+      return;
+   }
+
+   fputs( " \"", out );
+   for( uint8_t c : data )
+   {
+      switch( c )
+      {
+         case '\r': fputs( "\\r", out ); break;
+         case '\n': fputs( "\\n", out ); break;
+         case '\t': fputs( "\\t", out ); break;
+         case '"':  fputs( "\\\"", out ); break;
+         case '\\': fputs( "\\\\", out ); break;
+         default:
+            if( c >= ' ' && c < 0x7F )
+               fputc( c, out );
+            else
+               fprintf( out, "\\x%02x", c );
+      }
+   }
+   fputc( '"', out );
+}
+
+static bool recordTrace( const char *path, FILE *out )
+{
+   std::vector< uint8_t > file;
+   FILE *in = fopen( path, "rb" );
+   if( in == NULL )
+   {
+      fprintf( stderr, "can't open <%s>\n", path );
+      return false;
+   }
+   uint8_t buf[ 65536 ];
+   size_t n;
+   while( ( n = fread( buf, 1, sizeof( buf ), in ) ) > 0 )
+      file.insert( file.end(), buf, buf + n );
+   fclose( in );
+
+   CaptureReader reader( file );
+   if( !reader.valid() )
+   {
+      fprintf( stderr, "<%s> isn't a binary capture file\n", path );
+      return false;
+   }
+
+   // the events of the records, the blocks are older than the records
+   // around them, so the events are sorted afterwards
+   std::vector< TraceEvent_t > events;
+   uint16_t adc[ 6 ] = { 0 };
+   CaptureRecord_t rec;
+
+   while( reader.next( &rec ) )
+   {
+      const uint8_t *p = rec.data;
+      uint8_t analog = rec.source & 0x3F;
+      uint8_t digital = rec.source >> 8;
+      uint8_t pins[ 6 ];
+      uint8_t channels = 0;
+
+      for( uint8_t i = 0; i < 6; i++ )
+         if( analog & ( 1 << i ) )
+            pins[ channels++ ] = i;
+
+      switch( rec.sync )
+      {
+         case RECORD_SYNC:
+            for( uint8_t k = 0; k < channels; k++, p += 2 )
+               addAdc( &events, rec.time, pins[ k ], p[ 0 ] | ( p[ 1 ] << 8 ) );
+            if( digital )
+               addPins( &events, rec.time, digital, *p++ );
+            for( uint16_t bit = 0x40; bit <= 0x80; bit <<= 1 )
+            {
+               if( rec.source & bit )
+               {
+                  TraceEvent_t ev;
+                  ev.us = rec.time;
+                  ev.kind = bit == 0x40 ? EVENT_UART : EVENT_I2C;
+                  ev.pin = 0;
+                  ev.value = 0;
+                  ev.data.assign( p + 1, p + 1 + *p );
+                  if( !ev.data.empty() )
+                     events.push_back( ev );
+                  p += 1 + *p;
+               }
+            }
+            break;
+
+         case RECORD_SYNC_ADC:
+         case RECORD_SYNC_ADC_DELTA:
+         {
+            AdcBlockHeader_t block;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block );
+
+            const uint8_t *end = p;
+            if( rec.sync == RECORD_SYNC_ADC_DELTA )
+            {
+               AdcDeltaHeader_t delta;
+               memcpy( &delta, p, sizeof( delta ) );
+               p += sizeof( delta );
+               end = p + delta.size;
+               if( delta.keyframe )
+                  memset( adc, 0, sizeof( adc ) );
+            }
+
+            for( uint16_t i = 0; i < block.scans; i++ )
+            {
+               for( uint8_t k = 0; k < channels; k++ )
+               {
+                  if( rec.sync == RECORD_SYNC_ADC )
+                  {
+                     adc[ pins[ k ] ] = p[ 0 ] | ( p[ 1 ] << 8 );
+                     p += 2;
+                  }
+                  else
+                  {
+                     // varint of the zigzag encoded difference
+                     uint32_t u = 0;
+                     for( uint8_t shift = 0; p < end && shift < 21; shift += 7 )
+                     {
+                        u |= ( uint32_t )( *p & 0x7F ) << shift;
+                        if( !( *p++ & 0x80 ) )
+                           break;
+                     }
+                     adc[ pins[ k ] ] += ( uint16_t )( ( u >> 1 ) ^ -( u & 1 ) );
+                  }
+                  addAdc( &events, rec.time + ( int64_t )i * block.period, pins[ k ], adc[ pins[ k ] ] );
+               }
+            }
+            break;
+         }
+
+         case RECORD_SYNC_EDGE:
+         {
+            EdgeBlockHeader_t block;
+            memcpy( &block, p, sizeof( block ) );
+            p += sizeof( block );
+            for( uint8_t i = 0; i < block.count; i++, p += 5 )
+            {
+               uint32_t us;
+               memcpy( &us, p, sizeof( us ) );
+               addPins( &events, rec.time + ( int32_t )( us - ( uint32_t )rec.time ), digital, p[ 4 ] );
+            }
+            break;
+         }
+      }
+   }
+
+   std::stable_sort( events.begin(), events.end(),
+                     []( const TraceEvent_t &a, const TraceEvent_t &b ) { return ( int64_t )a.us < ( int64_t )b.us; } );
+
+   // the times from the first event, only the changes of the inputs
+   int64_t origin = events.empty() ? 0 : ( int64_t )events.front().us;
+   int last_adc[ 6 ] = { -1, -1, -1, -1, -1, -1 };
+   int last_pin[ 8 ] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+   unsigned long written = 0;
+
+   fprintf( out, "# trace of %s\n", path );
+   fprintf( out, "config CaptureSource %s%s", ( reader.header.source & 0x40 ) ? "SIO " : "",
+            ( reader.header.source & 0x80 ) ? "I2C " : "" );
+   for( int i = 0; i < 6; i++ )
+      if( reader.header.source & ( 1 << i ) )
+         fprintf( out, "A%d ", i );
+   for( int i = 0; i < 8; i++ )
+      if( reader.header.source & ( 0x100 << i ) )
+         fprintf( out, "D%d ", i );
+   fprintf( out, "\nconfig SamplingRate %u ms\n", reader.header.samplingRate );
+
+   for( size_t i = 0; i < events.size(); i++ )
+   {
+      TraceEvent_t &ev = events[ i ];
+
+      // the serial records of one time are one burst
+      while( ev.kind == EVENT_UART && i + 1 < events.size()
+             && events[ i + 1 ].kind == EVENT_UART && events[ i + 1 ].us == ev.us )
+      {
+         i++;
+         ev.data.insert( ev.data.end(), events[ i ].data.begin(), events[ i ].data.end() );
+      }
+
+      if( ev.kind == EVENT_ADC )
+      {
+         if( last_adc[ ev.pin ] == ( int )ev.value )
+            continue;
+         last_adc[ ev.pin ] = ev.value;
+      }
+      else if( ev.kind == EVENT_PIN )
+      {
+         if( last_pin[ ev.pin ] == ( int )ev.value )
+            continue;
+         last_pin[ ev.pin ] = ev.value;
+      }
+
+      fprintf( out, "%lld ", ( long long )( ( int64_t )ev.us - origin ) );
+      switch( ev.kind )
+      {
+         case EVENT_UART:
+            fputs( "uart", out );
+            printBytes( out, ev.data, true );
+            break;
+         case EVENT_I2C:
+            fputs( "i2c", out );
+            printBytes( out, ev.data, false );
+            break;
+         case EVENT_ADC:
+            fprintf( out, "adc A%u %u", ev.pin, ev.value );
+            break;
+         case EVENT_PIN:
+            fprintf( out, "pin D%u %u", ev.pin, ev.value );
+            break;
+      }
+      fputc( '\n', out );
+      written++;
+   }
+
+   if( !reader.hasTrailer )
+      fprintf( stderr, "<%s> has no trailer, the capture wasn't stopped\n", path );
+   fprintf( stderr, "%lu events\n", written );
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// the numbers of the capture file
+// --------------------------------------------------------------------------
+
+static bool decodeBinary( const std::vector< uint8_t > &data, ReplayResult_t *res )
+{
+   CaptureReader reader( data );
+   CaptureRecord_t rec;
+
+   if( !reader.valid() )
+      return false;
+
+   while( reader.next( &rec ) )
+   {
+      if( rec.sync == RECORD_SYNC_ADC || rec.sync == RECORD_SYNC_ADC_DELTA )
+      {
+         AdcBlockHeader_t block;
+         memcpy( &block, rec.data, sizeof( block ) );
+         res->adcLost += block.lost;
+      }
+   }
+
+   const RecordTrailer_t &t = reader.trailer;
+   res->samples = t.sampleCount;
+   res->droppedBytes = t.droppedBytes;
+   res->highWater = t.highWater;
+   res->sioOverflow = t.sioOverflow;
+   res->i2cLost = t.i2cLost;
+   res->edgesLost = t.edgesLost;
+   res->syncCount = t.syncCount;
+   res->maxAtRisk = t.maxAtRisk;
+   return reader.hasTrailer;
+}
+
+static bool decodeText( const std::vector< uint8_t > &data, ReplayResult_t *res )
+{
+   std::string text( data.begin(), data.end() );
+   bool trailer = false;
+   size_t pos = 0;
+
+   while( pos < text.size() )
+   {
+      size_t eol = text.find( '\n', pos );
+      if( eol == std::string::npos )
+         eol = text.size();
+      std::string line = text.substr( pos, eol - pos );
+      const char *s = line.c_str();
+      pos = eol + 1;
+
+      unsigned long a, b;
+      if( strncmp( s, "Capture start time:", 19 ) == 0 )
+         trailer = true;
+      else if( !trailer )
+      {
+         if( sscanf( s, "ADC %lu scans lost", &a ) == 1 )
+            res->adcLost += a;
+      }
+      else if( sscanf( s, "Captured %lu samples", &a ) == 1 )
+         res->samples = ( uint32_t )a;
+      else if( sscanf( s, "I2C lost %lu frames", &a ) == 1 )
+         res->i2cLost = ( uint32_t )a;
+      else if( sscanf( s, "DIG lost %lu changes", &a ) == 1 )
+         res->edgesLost = ( uint32_t )a;
+      else if( sscanf( s, "SIO overflow %lu bytes", &a ) == 1 )
+         res->sioOverflow = ( uint32_t )a;
+      else if( sscanf( s, "Dropped %lu bytes, %*u samples, buffer max %lu", &a, &b ) == 2 )
+      {
+         res->droppedBytes = ( uint32_t )a;
+         res->highWater = b;
+      }
+      else if( sscanf( s, "Synced %lu times", &a ) == 1 )
+         res->syncCount = a;
+      else if( sscanf( s, "Max %lu bytes at risk", &a ) == 1 )
+         res->maxAtRisk = a;
+   }
+   return trailer;
+}
+
+// --------------------------------------------------------------------------
+// one run, in the child process
+// --------------------------------------------------------------------------
+
+static bool replayFail( ReplayResult_t *res, const char *error )
+{
+   snprintf( res->error, sizeof( res->error ), "%s", error );
+   return false;
+}
+
+static void schedule( const TraceEvent_t &ev, uint64_t ns, ImageBlockDevice *image )
+{
+   switch( ev.kind )
+   {
+      case EVENT_UART:
+      {
+         std::vector< uint8_t > data = ev.data;
+         sim.at( ns, [ data ]( void ) { sim.uartSend( data.data(), data.size() ); } );
+         break;
+      }
+      case EVENT_I2C:
+      {
+         std::vector< uint8_t > data = ev.data;
+         sim.at( ns, [ data ]( void ) { sim.i2cReceive( data.data(), data.size() ); } );
+         break;
+      }
+      case EVENT_ADC:
+      {
+         uint8_t channel = ev.pin;
+         uint16_t value = ev.value;
+         sim.at( ns, [ channel, value ]( void ) { sim.setAnalog( channel, value ); } );
+         break;
+      }
+      case EVENT_PIN:
+      {
+         uint8_t pin = ev.pin;
+         uint8_t level = ev.value;
+         sim.at( ns, [ pin, level ]( void ) { sim.setPin( pin, level ); } );
+         break;
+      }
+      case EVENT_STALL:
+      {
+         uint64_t stall = ( uint64_t )ev.value * SIM_NS_PER_US;
+         sim.at( ns, [ image, stall ]( void ) { image->stall( stall ); } );
+         break;
+      }
+   }
+}
+
+// with a speed, wait until the wall time catches up with the virtual time
+static void pace( uint64_t virtual_ns, const struct timespec *from )
+{
+   struct timespec now;
+   clock_gettime( CLOCK_MONOTONIC, &now );
+
+   double wall_ns = ( now.tv_sec - from->tv_sec ) * 1e9 + ( now.tv_nsec - from->tv_nsec );
+   double ahead_ns = virtual_ns / replaySpeed - wall_ns;
+   if( ahead_ns > 1e6 )
+   {
+      struct timespec wait;
+      wait.tv_sec = ( time_t )( ahead_ns / 1e9 );
+      wait.tv_nsec = ( long )( ahead_ns - wait.tv_sec * 1e9 );
+      nanosleep( &wait, NULL );
+   }
+}
+
+static bool replayCapture( const ReplayRun_t *run, ReplayResult_t *res )
+{
+   ImageBlockDevice image;
+   const char *error = hostCaptureImage( &image, imageDir, REPLAY_IMAGE_MB );
+   if( error != NULL )
+      return replayFail( res, error );
+
+   // config.txt: the defaults, the trace, the file of the run
+   char defaults[ 512 ];
+   snprintf( defaults, sizeof( defaults ),
+             "FileName         \"%s\"\n"
+             "FileType         %s\n"
+             "FileSize         %uM\n"
+             "CaptureSource    %s\n"
+             "SamplingRate     100 Hz\n"
+             "Oversampling     1\n"
+             "OversamplingBits 0\n"
+             "SyncSize         64K\n"
+             "SyncTime         10 s\n"
+             "SyncIdle         1 s\n"
+             "SerialBaudrate   115200\n"
+             "SerialBits       8\n"
+             "SerialParity     N\n"
+             "SerialStopBits   1\n",
+             binaryFile ? "replay.bin" : "replay.txt", binaryFile ? "bin" : "txt",
+             REPLAY_FILE_MB, traceSources.c_str() );
+
+   std::string config = defaults;
+   for( const std::string &line : traceConfig )
+      config += line + "\n";
+   if( run->config != NULL )
+   {
+      FILE *in = fopen( run->config, "r" );
+      if( in == NULL )
+         return replayFail( res, "can't open the config file" );
+      char line[ 256 ];
+      while( fgets( line, sizeof( line ), in ) != NULL )
+         config += line;
+      fclose( in );
+      if( config.back() != '\n' )
+         config += "\n";
+   }
+
+   if( verbose )
+      sim.uartOutput = []( uint8_t c ) { fputc( c, stderr ); };
+   else
+      sim.uartOutput = []( uint8_t c ) { ( void )c; };
+   error = hostCaptureStart( &image, config.data(), config.size(), run->latency );
+   if( error != NULL )
+      return replayFail( res, error );
+
+   // the replay, the events are scheduled a little ahead of their time
+   TraceReader reader;
+   TraceEvent_t ev;
+   if( !reader.open( tracePath ) )
+      return replayFail( res, reader.error.c_str() );
+   bool pending = reader.next( &ev );
+
+   uint64_t from = sim.nanos();
+   uint64_t to = from + traceEndUs * SIM_NS_PER_US;
+   uint64_t busy_from = image.stats.busyNs;
+   uint64_t run_max = 0;
+   struct timespec host_from, host_to;
+
+   clock_gettime( CLOCK_MONOTONIC, &host_from );
+   while( sim.nanos() < to && !flags.sdcard_error )
+   {
+      uint64_t horizon = sim.nanos() + REPLAY_LOOKAHEAD_NS;
+      while( pending && ev.kind != EVENT_END && from + ev.us * SIM_NS_PER_US < horizon )
+      {
+         schedule( ev, from + ev.us * SIM_NS_PER_US, &image );
+         res->events++;
+         pending = reader.next( &ev );
+      }
+
+      uint64_t t = sim.nanos();
+      capture.run();
+      run_max = std::max( run_max, sim.nanos() - t );
+      yield();
+
+      if( replaySpeed > 0 )
+         pace( sim.nanos() - from, &host_from );
+   }
+   clock_gettime( CLOCK_MONOTONIC, &host_to );
+
+   res->seconds = ( sim.nanos() - from ) / ( double )SIM_NS_PER_S;
+   res->hostSeconds = ( host_to.tv_sec - host_from.tv_sec ) + ( host_to.tv_nsec - host_from.tv_nsec ) * 1e-9;
+   res->runMaxUs = run_max / ( double )SIM_NS_PER_US;
+   res->cardBusyMs = ( image.stats.busyNs - busy_from ) / ( double )SIM_NS_PER_MS;
+   res->gcStalls = image.stats.gcStalls;
+   capture.stop();
+
+   if( flags.sdcard_error )
+      return replayFail( res, "write error of the capture file" );
+
+   // the file, and all files of the image for a closer look
+   std::vector< uint8_t > data;
+   image.setLatency( sdLatencyProfile( "none" ) );
+   if( !hostReadFile( settings.FileName, &data ) )
+      return replayFail( res, "can't read the capture file, RotateSize and RotateTime aren't supported" );
+   if( keepDir != NULL )
+   {
+      char dir[ 1024 ];
+      const char *name = run->config ? strrchr( run->config, '/' ) : NULL;
+      snprintf( dir, sizeof( dir ), "%s/%s-%s", keepDir,
+                name ? name + 1 : run->config ? run->config : "trace", run->latency->name );
+      hostExtractFiles( dir, false );
+   }
+
+   res->bytes = data.size();
+   bool binary = data.size() >= 4 && memcmp( data.data(), RECORD_MAGIC, 4 ) == 0;
+   if( !( binary ? decodeBinary( data, res ) : decodeText( data, res ) ) )
+      return replayFail( res, "can't decode the capture file" );
+
+   res->ok = true;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// the runs
+// --------------------------------------------------------------------------
+
+static void printRun( FILE *out, const ReplayRun_t *run, const ReplayResult_t *res, bool last )
+{
+   fprintf( out, "    { \"config\": \"%s\", \"latency\": \"%s\", \"ok\": %s",
+            run->config ? run->config : "", run->latency->name, res->ok ? "true" : "false" );
+
+   if( !res->ok )
+      fprintf( out, ", \"error\": \"%s\"", res->error );
+   else
+   {
+      fprintf( out, ",\n      \"seconds\": %.3f, \"host_seconds\": %.3f, \"events\": %lu, \"bytes\": %lu, \"samples\": %lu,\n",
+               res->seconds, res->hostSeconds, ( unsigned long )res->events,
+               ( unsigned long )res->bytes, ( unsigned long )res->samples );
+      fprintf( out, "      \"dropped_bytes\": %lu, \"buffer_high_water\": %u, \"sio_overflow_bytes\": %lu, "
+               "\"i2c_lost_frames\": %lu, \"adc_lost_scans\": %lu, \"edges_lost\": %lu,\n",
+               ( unsigned long )res->droppedBytes, res->highWater, ( unsigned long )res->sioOverflow,
+               ( unsigned long )res->i2cLost, ( unsigned long )res->adcLost, ( unsigned long )res->edgesLost );
+      fprintf( out, "      \"syncs\": %u, \"max_at_risk_bytes\": %u, \"run_max_us\": %.1f,\n",
+               res->syncCount, res->maxAtRisk, res->runMaxUs );
+      fprintf( out, "      \"card\": { \"busy_ms\": %.3f, \"gc_stalls\": %u }", res->cardBusyMs, res->gcStalls );
+   }
+   fprintf( out, " }%s\n", last ? "" : "," );
+}
+
+// the losses of the runs side by side
+static void printTable( const std::vector< ReplayRun_t > &runs, const std::vector< ReplayResult_t > &results )
+{
+   fprintf( stderr, "%-20s %-8s %10s %8s %8s %8s %8s %8s %10s\n",
+            "config", "latency", "dropped", "high", "sio", "i2c", "adc", "edges", "run max us" );
+   for( size_t i = 0; i < runs.size(); i++ )
+   {
+      const ReplayResult_t *r = &results[ i ];
+      const char *name = runs[ i ].config ? runs[ i ].config : "trace";
+      if( !r->ok )
+      {
+         fprintf( stderr, "%-20s %-8s %s\n", name, runs[ i ].latency->name, r->error );
+         continue;
+      }
+      fprintf( stderr, "%-20s %-8s %10lu %8u %8lu %8lu %8lu %8lu %10.1f\n", name, runs[ i ].latency->name,
+               ( unsigned long )r->droppedBytes, r->highWater, ( unsigned long )r->sioOverflow,
+               ( unsigned long )r->i2cLost, ( unsigned long )r->adcLost, ( unsigned long )r->edgesLost,
+               r->runMaxUs );
+   }
+}
+
+// all runs at the same time, each one in a child process
+static void runAll( const std::vector< ReplayRun_t > &runs, std::vector< ReplayResult_t > *results )
+{
+   std::map< pid_t, std::pair< size_t, int > > active;   // pid, index and pipe
+
+   results->assign( runs.size(), ReplayResult_t() );
+
+   for( size_t i = 0; i < runs.size(); i++ )
+   {
+      int fds[ 2 ];
+      if( pipe( fds ) != 0 )
+      {
+         snprintf( ( *results )[ i ].error, sizeof( ReplayResult_t::error ), "pipe() failed" );
+         continue;
+      }
+
+      fflush( stderr );
+      pid_t pid = fork();
+      if( pid == 0 )
+      {
+         ReplayResult_t res = ReplayResult_t();
+         close( fds[ 0 ] );
+         replayCapture( &runs[ i ], &res );
+         ssize_t n = write( fds[ 1 ], &res, sizeof( res ) );
+         _exit( n == sizeof( res ) ? 0 : 1 );
+      }
+
+      close( fds[ 1 ] );
+      if( pid < 0 )
+      {
+         close( fds[ 0 ] );
+         snprintf( ( *results )[ i ].error, sizeof( ReplayResult_t::error ), "fork() failed" );
+      }
+      else
+         active[ pid ] = std::make_pair( i, fds[ 0 ] );
+   }
+
+   while( !active.empty() )
+   {
+      int status;
+      pid_t pid = wait( &status );
+      if( pid < 0 )
+         break;
+
+      auto it = active.find( pid );
+      if( it == active.end() )
+         continue;
+
+      ReplayResult_t *res = &( *results )[ it->second.first ];
+      if( read( it->second.second, res, sizeof( *res ) ) != sizeof( *res ) )
+      {
+         *res = ReplayResult_t();
+         snprintf( res->error, sizeof( res->error ), "run ended with status %d", status );
+      }
+      close( it->second.second );
+      active.erase( it );
+   }
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static void usage( const char *name )
+{
+   fprintf( stderr,
+            "usage: %s [options] trace\n"
+            "       %s -r capture.bin [-o trace]\n"
+            "  -c file     lines of config.txt for a run, again for a comparison\n"
+            "  -l list     latency of the card: none, fast, typical, slow, default typical\n"
+            "  -f type     file type of the capture: txt, bin, default bin\n"
+            "  -x speed    1 real time, 10 ten times faster, default as fast as possible\n"
+            "  -d dir      directory of the temporary images, default /tmp\n"
+            "  -k dir      keep the files of the images in dir\n"
+            "  -o file     write the JSON or the trace to file, default stdout\n"
+            "  -r file     convert a binary capture file into a trace\n"
+            "  -v          the debug output of the firmware on stderr\n",
+            name, name );
+}
+
+int main( int argc, char *argv[] )
+{
+   std::vector< const char * > configs;
+   const char *latencies = "typical";
+   const char *out_path = NULL;
+   const char *record = NULL;
+   int opt;
+
+   while( ( opt = getopt( argc, argv, "c:l:f:x:d:k:o:r:vh" ) ) != -1 )
+   {
+      switch( opt )
+      {
+         case 'c': configs.push_back( optarg ); break;
+         case 'l': latencies = optarg; break;
+         case 'f':
+            if( strcmp( optarg, "txt" ) != 0 && strcmp( optarg, "bin" ) != 0 )
+            {
+               fprintf( stderr, "unknown file type <%s>\n", optarg );
+               return 1;
+            }
+            binaryFile = strcmp( optarg, "bin" ) == 0;
+            break;
+         case 'x': replaySpeed = atof( optarg ); break;
+         case 'd': imageDir = optarg; break;
+         case 'k': keepDir = optarg; mkdir( keepDir, 0755 ); break;
+         case 'o': out_path = optarg; break;
+         case 'r': record = optarg; break;
+         case 'v': verbose = true; break;
+         default:
+            usage( argv[ 0 ] );
+            return 1;
+      }
+   }
+
+   if( ( record == NULL ) == ( optind == argc ) || optind < argc - 1 )
+   {
+      usage( argv[ 0 ] );
+      return 1;
+   }
+
+   FILE *out = out_path ? fopen( out_path, "w" ) : stdout;
+   if( out == NULL )
+   {
+      fprintf( stderr, "can't create <%s>\n", out_path );
+      return 1;
+   }
+
+   if( record != NULL )
+   {
+      bool ok = recordTrace( record, out );
+      if( out != stdout )
+         fclose( out );
+      return ok ? 0 : 1;
+   }
+
+   // the runs, a config and a latency each
+   tracePath = argv[ optind ];
+   uint64_t events;
+   if( !scanTrace( &events ) )
+      return 1;
+
+   if( configs.empty() )
+      configs.push_back( NULL );
+
+   std::vector< ReplayRun_t > runs;
+   std::string list( latencies );
+   for( size_t pos = 0; pos <= list.size(); )
+   {
+      size_t comma = std::min( list.find( ',', pos ), list.size() );
+      std::string name = list.substr( pos, comma - pos );
+      pos = comma + 1;
+
+      ReplayRun_t run;
+      run.latency = sdLatencyProfile( name.c_str() );
+      if( run.latency == NULL )
+      {
+         fprintf( stderr, "unknown latency profile <%s>\n", name.c_str() );
+         return 1;
+      }
+      for( const char *config : configs )
+      {
+         run.config = config;
+         runs.push_back( run );
+      }
+   }
+
+   fprintf( stderr, "%s: %lu events, %.3f s, sources %s, %lu runs\n", tracePath, ( unsigned long )events,
+            traceEndUs / 1e6, traceSources.c_str(), ( unsigned long )runs.size() );
+   std::vector< ReplayResult_t > results;
+   fflush( out );
+   runAll( runs, &results );
+
+   int failed = 0;
+   fprintf( out, "{\n  \"replay\": \"%s\",\n  \"trace_seconds\": %.3f,\n  \"runs\": [\n", tracePath, traceEndUs / 1e6 );
+   for( size_t i = 0; i < runs.size(); i++ )
+   {
+      printRun( out, &runs[ i ], &results[ i ], i + 1 == runs.size() );
+      if( !results[ i ].ok )
+         failed++;
+   }
+   fprintf( out, "  ]\n}\n" );
+   if( out != stdout )
+      fclose( out );
+
+   printTable( runs, results );
+   return failed ? 1 : 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
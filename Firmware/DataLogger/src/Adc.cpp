@@ -0,0 +1,367 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Adc.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   only with USE_ADC_ISR
+// 2026-10-18  AWe   timer 1 belongs to the timebase, time stamps in us
+// 2026-10-18  AWe   add oversampling and decimation
+// 2026-10-18  AWe   initial version, timer triggered adc with ping-pong sample blocks
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Adc" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // noInterrupts(), interrupts(), ...
+   #include <avr/interrupt.h>       // ISR()
+#else
+   #include "WArduino.h"
+#endif
+
+#include "DataLogger_config.h"
+#include "Adc.h"
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_ADC_ISR
+
+// timer 1 runs free in normal mode as the timebase, the compare match B interrupt moves OCR1B
+// forward by the sampling period. At the compare match which ends a period the
+// auto trigger of the adc starts the conversion of the first enabled channel.
+// The adc interrupt stores the value and starts the next enabled channel, until
+// all channels of the mask are converted. So each scan starts exactly on the
+// timer, independent of the capture task and of the sdcard latency.
+//
+// With oversampling the timer runs oversampling times faster. The isr sums
+// the values of each channel over oversampling scans and stores the sum
+// shifted right by log2( oversampling ) - bit_growth. This is a boxcar
+// filter, a CIC filter of first order, followed by the decimation. The noise
+// is reduced and with bit_growth the resolution is increased by up to
+// ADC_MAX_BIT_GROWTH bits, while only one word per channel is stored.
+//
+// The scans are collected in two blocks. While the isr fills one block, the
+// capture task writes the other one to the file.
+
+Adc adc;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Adc::Adc( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Adc::~Adc( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static uint8_t firstChannel( uint8_t mask )
+{
+   uint8_t channel = 0;
+
+   while( !( mask & 1 ) )
+   {
+      mask >>= 1;
+      channel++;
+   }
+   return channel;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Adc::begin( uint8_t channel_mask, uint32_t period_us, uint8_t oversampling, uint8_t bit_growth )
+{
+   mask = channel_mask & 0x3f;
+
+   // a power of 2 up to ADC_MAX_OVERSAMPLING
+   uint8_t log2_ratio = 0;
+   while( ( 2 << log2_ratio ) <= oversampling && ( 2 << log2_ratio ) <= ADC_MAX_OVERSAMPLING )
+      log2_ratio++;
+
+   if( bit_growth > log2_ratio )
+      bit_growth = log2_ratio;
+   if( bit_growth > ADC_MAX_BIT_GROWTH )
+      bit_growth = ADC_MAX_BIT_GROWTH;
+
+   ratio = 1 << log2_ratio;
+   shift = log2_ratio - bit_growth;
+   phase = 0;
+   period_us /= ratio;
+
+   numChannels = 0;
+   for( uint8_t m = mask; m; m >>= 1 )
+   {
+      if( m & 1 )
+         numChannels++;
+   }
+
+   if( numChannels == 0 )
+      return false;
+
+   // one scan of all channels has to fit into one period
+   uint32_t min_period_us = ( numChannels + 1 ) * ADC_CONVERSION_TIME_US;
+   if( period_us < min_period_us )
+   {
+      LOGW( TAG, "sampling period %ld us too short, use %ld us", period_us, min_period_us );
+      period_us = min_period_us;
+   }
+   if( period_us > 0xFFFFFFFFUL / ADC_TIMER_TICKS_PER_US )
+      period_us = 0xFFFFFFFFUL / ADC_TIMER_TICKS_PER_US;
+
+   period = period_us * ADC_TIMER_TICKS_PER_US;
+
+   for( uint8_t i = 0; i < 2; i++ )
+   {
+      block[ i ].count = 0;
+      block[ i ].lost = 0;
+      block[ i ].full = 0;
+   }
+   fillIndex = 0;
+   drainIndex = 0;
+   dropScan = false;
+   lostScans = 0;
+   channel = firstChannel( mask );
+
+   noInterrupts();
+
+   DIDR0 |= mask;                                  // disable digital input buffers
+   ADMUX  = ( 1 << REFS0 ) | channel;              // AVcc as reference, same as analogRead()
+   ADCSRB = ( 1 << ADTS2 ) | ( 1 << ADTS0 );       // trigger source timer 1 compare match B
+   ADCSRA = ( 1 << ADEN ) | ( 1 << ADIF ) | ( 1 << ADIE ) | ADC_PRESCALER;
+
+   // timer 1 is already running for the timebase
+   OCR1B  = TCNT1;
+   ticksLeft = 0;
+   timerIsr();                                     // schedule the first trigger
+   TIFR1  = ( 1 << OCF1B );
+   TIMSK1 |= ( 1 << OCIE1B );
+
+   interrupts();
+
+   LOGI( TAG, "adc mask 0x%02x, %d channels, period %ld us, oversampling %d, %d bits",
+         mask, numChannels, period_us, ratio, 10 + bit_growth );
+   return true;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Adc::end( void )
+{
+   noInterrupts();
+
+   TIMSK1 &= ~( 1 << OCIE1B );                     // timer 1 keeps running for the timebase
+
+   // back to the settings of the arduino core, so analogRead() works again
+   ADCSRB = 0;
+   ADCSRA = ( 1 << ADEN ) | ( 1 << ADIF ) | ( 1 << ADPS2 ) | ( 1 << ADPS1 ) | ( 1 << ADPS0 );
+   DIDR0 &= ~mask;
+
+   // hand out the partly filled block, too
+   if( !dropScan && block[ fillIndex ].count )
+      block[ fillIndex ].full = 1;
+
+   interrupts();
+
+   LOGI( TAG, "adc stopped, %d scans lost", lostScans );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+AdcBlock_t *Adc::get( void )
+{
+   AdcBlock_t *b = &block[ drainIndex ];
+
+   if( b->full )
+      return b;
+
+   return NULL;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Adc::release( void )
+{
+   noInterrupts();
+   block[ drainIndex ].count = 0;
+   block[ drainIndex ].full = 0;
+   interrupts();
+
+   drainIndex ^= 1;
+}
+
+// --------------------------------------------------------------------------
+// called from the timer 1 compare match B interrupt
+// --------------------------------------------------------------------------
+
+void Adc::timerIsr( void )
+{
+   if( ticksLeft == 0 )
+      ticksLeft = period;     // this compare match started a scan, begin the next period
+
+   // the compare register has only 16 bit, so split long periods
+   uint16_t step = ticksLeft > 0xFFFFUL ? 0x8000 : ( uint16_t )ticksLeft;
+   ticksLeft -= step;
+   OCR1B += step;
+
+   // only the compare match at the end of the period triggers the adc,
+   // don't write a one to ADIF, it would clear a pending adc interrupt
+   if( ticksLeft == 0 )
+      ADCSRA = ( ADCSRA & ~( 1 << ADIF ) ) | ( 1 << ADATE );
+   else
+      ADCSRA &= ~( ( 1 << ADIF ) | ( 1 << ADATE ) );
+}
+
+// --------------------------------------------------------------------------
+// called from the adc conversion complete interrupt
+// --------------------------------------------------------------------------
+
+void Adc::conversionIsr( void )
+{
+   uint16_t value = ADC;
+   uint8_t first = firstChannel( mask );
+   AdcBlock_t *b = &block[ fillIndex ];
+
+   if( channel == first )
+   {
+      index = 0;
+
+      // start of a new scan, the first of the oversampled ones
+      if( phase == 0 )
+      {
+         dropScan = b->full;
+         if( dropScan )
+         {
+            lostScans++;
+         }
+         else if( b->count == 0 )
+         {
+            b->time = timebase.micros();
+            b->lost = lostScans;
+            lostScans = 0;
+         }
+      }
+   }
+
+   if( phase == 0 )
+      acc[ index ] = value;
+   else
+      acc[ index ] += value;
+   index++;
+
+   // look for the next enabled channel
+   uint8_t next = channel + 1;
+   while( next < 6 && !( mask & ( 1 << next ) ) )
+      next++;
+
+   if( next < 6 )
+   {
+      // convert the next channel of this scan immediately
+      channel = next;
+      ADMUX = ( 1 << REFS0 ) | channel;
+      ADCSRA = ( ADCSRA & ~( 1 << ADIF ) ) | ( 1 << ADSC );
+   }
+   else
+   {
+      // scan complete, wait for the next timer trigger
+      channel = first;
+      ADMUX = ( 1 << REFS0 ) | channel;
+
+      if( ++phase < ratio )
+         return;
+
+      // decimate, store one scan for all oversampled ones
+      phase = 0;
+      if( !dropScan )
+      {
+         for( uint8_t i = 0; i < numChannels; i++ )
+            b->data[ b->count++ ] = acc[ i ] >> shift;
+
+         if( b->count + numChannels > ADC_BLOCK_SIZE )
+         {
+            b->full = 1;
+            fillIndex ^= 1;
+         }
+      }
+   }
+}
+
+// --------------------------------------------------------------------------
+// Interrupt Service Routines
+// --------------------------------------------------------------------------
+
+ISR( TIMER1_COMPB_vect )
+{
+   adc.timerIsr();
+}
+
+ISR( ADC_vect )
+{
+   adc.conversionIsr();
+}
+
+#endif // USE_ADC_ISR
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   add oversampling and decimation
+// 2026-10-18  AWe   initial version, timer triggered adc with ping-pong sample blocks
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __ADC_H__
+#define __ADC_H__
+
+#include <stdint.h>
+#include "Timebase.h"                  // TIMEBASE_TICKS_PER_US
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef ADC_BLOCK_SIZE
+   #define ADC_BLOCK_SIZE     24          // words per sample block, multiple of 1, 2, 3, 4 and 6
+#endif
+
+// timer 1 is the timebase, see Timebase.cpp
+#define ADC_TIMER_TICKS_PER_US   TIMEBASE_TICKS_PER_US
+
+#ifndef ADC_MAX_OVERSAMPLING
+   #define ADC_MAX_OVERSAMPLING  64       // power of 2, the sum of the scans fits into 16 bit
+#endif
+#define ADC_MAX_BIT_GROWTH       5        // 15 bit values, the deltas of Record.h fit into 16 bit
+
+// adc clock prescaler 64, 250kHz at 16MHz, 13 adc clocks or 52us for one conversion
+#define ADC_PRESCALER            ( ( 1 << ADPS2 ) | ( 1 << ADPS1 ) )
+#define ADC_CONVERSION_TIME_US   52
+
+typedef struct
+{
+   uint32_t time;                         // us of the timebase, first scan in this block
+   uint16_t lost;                         // scans dropped before this block, because no block was free
+   uint8_t  count;                        // number of words in data
+   volatile uint8_t full;                 // set by the isr, cleared by release()
+   uint16_t data[ ADC_BLOCK_SIZE ];       // scans of all enabled channels, lowest channel first
+} AdcBlock_t;
+
+class Adc
+{
+private:
+   AdcBlock_t block[ 2 ];
+   uint8_t  fillIndex;                    // block filled by the isr
+   uint8_t  drainIndex;                   // block drained by the capture task
+   uint8_t  mask;                         // enabled channels A0 .. A5
+   uint8_t  numChannels;
+   uint8_t  channel;                      // channel of the running conversion
+   bool     dropScan;                     // no free block for the running scan
+   uint16_t lostScans;                    // dropped scans, not yet reported in a block
+   uint32_t period;                       // in timer ticks, of one oversampled scan
+   uint32_t ticksLeft;                    // until the next trigger
+   uint8_t  ratio;                        // oversampled scans per stored scan
+   uint8_t  phase;                        // oversampled scans in acc
+   uint8_t  shift;                        // decimation, acc >> shift is stored
+   uint8_t  index;                        // channel of the running conversion in acc
+   uint16_t acc[ 6 ];                     // sum of the oversampled scans of each channel
+
+public:
+   Adc( void );
+   ~Adc( void );
+
+   bool begin( uint8_t channel_mask, uint32_t period_us, uint8_t oversampling = 1, uint8_t bit_growth = 0 );
+   void end( void );
+
+   uint8_t channels( void )   { return numChannels; }
+   uint32_t periodUs( void )  { return period * ratio / ADC_TIMER_TICKS_PER_US; }
+
+   AdcBlock_t *get( void );               // next full block or NULL
+   void release( void );                  // give the block back to the isr
+
+   void timerIsr( void );
+   void conversionIsr( void );
+};
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __ADC_H__
@@ -0,0 +1,179 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Benchmark.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   time both paths up to the ring buffer
+// 2026-10-18  AWe   initial version, text record benchmark
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Bench" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // micros()
+   #include <avr/pgmspace.h>        // PSTR(), snprintf_P()
+#else
+   #include "WArduino.h"
+#endif
+
+#include "TextRecord.h"
+#include "Capture.h"                   // CAPTURE_BUFFER_SIZE, RingBuf
+#include "Benchmark.h"
+
+#define BENCHMARK_CHANNELS    6
+
+typedef RingBuf< SdFile, CAPTURE_BUFFER_SIZE > BenchRing_t;
+
+// --------------------------------------------------------------------------
+// the sample values change with each line, so both paths see varying widths
+
+static uint16_t sample( uint16_t line, uint8_t channel )
+{
+   return ( line * 37 + channel * 171 ) & 0x3FF;
+}
+
+// --------------------------------------------------------------------------
+// like Capture::put(), but a full ring buffer is emptied instead of written
+// to the card, so the time of the card isn't measured
+
+static void put( BenchRing_t &ring, const void *buf, size_t len )
+{
+   if( ring.bytesFree() < len )
+      ring.begin( NULL );
+
+   ring.memcpyIn( buf, len );
+}
+
+// --------------------------------------------------------------------------
+// the way the text lines were written before TextRecord, the time, the
+// values and the line end each with an own put()
+
+static uint8_t writePrintf( BenchRing_t &ring, uint32_t time, uint16_t line )
+{
+   char print_buf[ TEXT_RECORD_SIZE ];
+   uint8_t buflen = sizeof( print_buf ) - 1;
+   char *buf = print_buf;
+
+   int16_t written = _log_time2str( buf, buflen, time );
+   put( ring, print_buf, written );
+   uint8_t bytes = written;
+
+   written = snprintf_P( buf, buflen, PSTR( " ADC" ) );
+   buf += written;
+   buflen -= written;
+
+   for( uint8_t channel = 0; channel < BENCHMARK_CHANNELS; channel++ )
+   {
+      written = snprintf_P( buf, buflen, PSTR( " %d" ), sample( line, channel ) );
+      buf += written;
+      buflen -= written;
+   }
+   put( ring, print_buf, buf - print_buf );
+   bytes += buf - print_buf;
+
+   put( ring, "\r\n", 2 );
+   return bytes + 2;
+}
+
+// --------------------------------------------------------------------------
+// the line assembled in the TextRecord and written with one put()
+
+static uint8_t writeTextRecord( BenchRing_t &ring, TextRecord &rec, uint32_t time, uint16_t line )
+{
+   rec.clear();
+   rec.time( time );
+   rec.label( PSTR( " ADC" ) );
+
+   for( uint8_t channel = 0; channel < BENCHMARK_CHANNELS; channel++ )
+      rec.value( sample( line, channel ) );
+
+   rec.end();
+   put( ring, rec.data(), rec.length() );
+
+   return rec.length();
+}
+
+// --------------------------------------------------------------------------
+
+static uint32_t recordsPerSecond( uint32_t elapsed )
+{
+   if( elapsed == 0 )
+      elapsed = 1;
+
+   return ( uint32_t )BENCHMARK_RECORDS * 1000000UL / elapsed;
+}
+
+// --------------------------------------------------------------------------
+
+void benchmarkTextRecord( void )
+{
+   BenchRing_t ring;
+   TextRecord rec;
+   uint32_t time = 3723456;            // 1:02:03.456, a line of typical length
+   uint32_t bytes = 0;
+
+   ring.begin( NULL );
+   uint32_t start = micros();
+   for( uint16_t line = 0; line < BENCHMARK_RECORDS; line++ )
+      bytes += writePrintf( ring, time + line, line );
+   uint32_t elapsedPrintf = micros() - start;
+
+   ring.begin( NULL );
+   start = micros();
+   for( uint16_t line = 0; line < BENCHMARK_RECORDS; line++ )
+      bytes -= writeTextRecord( ring, rec, time + line, line );
+   uint32_t elapsedText = micros() - start;
+
+   // both paths must produce lines of the same length
+   if( bytes != 0 )
+      LOGW( TAG, "Line length differs by %ld bytes", ( int32_t )bytes );
+
+   LOGI( TAG, "snprintf_P: %lu us, %lu records/s", elapsedPrintf, recordsPerSecond( elapsedPrintf ) );
+   LOGI( TAG, "TextRecord: %lu us, %lu records/s", elapsedText, recordsPerSecond( elapsedText ) );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   time both paths up to the ring buffer
+// 2026-10-18  AWe   initial version, text record benchmark
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdint.h>
+
+#ifndef BENCHMARK_RECORDS
+   #define BENCHMARK_RECORDS  200         // lines written by each path
+#endif
+
+// Writes BENCHMARK_RECORDS typical adc lines of the text capture file into a
+// ring buffer of CAPTURE_BUFFER_SIZE, once formatted with _log_time2str() and
+// snprintf_P() and written with a put() per field as the capture did before,
+// and once with TextRecord and one put() per line. Logs the records per
+// second of both. The ring buffer isn't written to the card.
+
+void benchmarkTextRecord( void );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __BENCHMARK_H__
@@ -10,6 +10,40 @@
 // Changelog
 //
 //
+// 2026-10-18  AWe   sync a growing file once its first cluster is written
+// 2026-10-18  AWe   report the lost pin changes of the capture, in the trailer
+// 2026-10-18  AWe   read D0, D1 with SamplingRate while the serial interface is captured
+// 2026-10-18  AWe   count the lost adc scans of a dropped block or line as dropped
+// 2026-10-18  AWe   runBinary() without the stale room of the i2c length byte
+// 2026-10-18  AWe   writeHeader() without the address of a packed member
+// 2026-10-18  AWe   deadline statistics count only the deadlines which took a sample
+// 2026-10-18  AWe   count only the samples put into the ring buffer, the others as dropped
+// 2026-10-18  AWe   i2c lost frames of this capture, drop the frames queued before the start
+// 2026-10-18  AWe   no pin change events on D0, D1 while the serial interface is captured
+// 2026-10-18  AWe   keep the files of a running capture in the recovery journal
+// 2026-10-18  AWe   sync checkpoints, report bytes at risk and sync time
+// 2026-10-18  AWe   clock time of the software rtc in the files
+// 2026-10-18  AWe   binary record times in us of the timebase
+// 2026-10-18  AWe   assemble the text lines with TextRecord, one put per line
+// 2026-10-18  AWe   find a free name with one pass over the directory
+// 2026-10-18  AWe   rotate the capture file by size or time, pre-create the next part
+// 2026-10-18  AWe   oversample the adc with Oversampling, OversamplingBits
+// 2026-10-18  AWe   write the adc blocks as zigzag deltas with varints
+// 2026-10-18  AWe   record the digital pins with the pin change interrupt
+//                   read the digital pins from PIND instead of PORTC, PORTD
+// 2026-10-18  AWe   keep a pre-trigger history while ready for capture
+// 2026-10-18  AWe   start and stop the capture with StartSample, StopSample
+//                   setup the serial interface in setup()
+// 2026-10-18  AWe   queue the received i2c frames, one record per frame
+// 2026-10-18  AWe   receive serial data with the usart isr, one record per burst
+//                   apply SerialBaudrate, SerialBits, SerialParity, SerialStopBits
+// 2026-10-18  AWe   sample each source on its own deadline, without drift
+// 2026-10-18  AWe   stream the preallocated file with a multi sector write
+// 2026-10-18  AWe   preallocate the capture file with settings.FileSize
+// 2026-10-18  AWe   collect the samples in a ring buffer, write only complete
+//                   sectors to the file
+// 2026-10-18  AWe   get analog samples from the timer triggered adc
+// 2026-10-18  AWe   add binary capture file format ( FileType BIN )
 // 2020-06-16  AWe   rename capture file if exists
 //                   print some statistics to capture file
 // 2020-06-10  AWe   write captured data to file (SIO, I2C, ADC, DIG)
@@ -64,14 +98,28 @@ static const char TAG[] PROGMEM = tag( "Capture" );
 #endif
 
 #ifdef USE_TWI
-   #include <Wire.h>
+   #include "I2c.h"
 #endif
+#include "DataLogger_config.h"
 #include "Config.h"
 #include "Capture.h"
 #include "DataLogger.h"          // flags
 #include "Led.h"
+#include "Record.h"
+#include "Recovery.h"
+#include "TextRecord.h"
+#include "Timebase.h"
+#include "Rtc.h"
+#include "Uart.h"
+#ifdef USE_ADC_ISR
+   #include "Adc.h"
+#endif
+#ifdef USE_PCINT
+   #include "Pcint.h"
+#endif
 
 #include "SdFat/SdFat.h"       // SdVolume
+#include <ctype.h>               // toupper(), isdigit()
 
 // --------------------------------------------------------------------------
 //
@@ -81,14 +129,12 @@ extern Led Led_R;
 extern Led Led_G;
 extern Led Led_Debug;
 
-// --------------------------------------------------------------------------
-//
-// --------------------------------------------------------------------------
+#ifdef USE_ADC_ISR
+   extern Adc adc;
+#endif
+
+extern SdFat sd;
 
-void i2cReceiveEvent( int howMany )
-{
-   posSemaphoreGive( I2C_ReceiveEvent );
-}
 
 // --------------------------------------------------------------------------
 //
@@ -123,12 +169,23 @@ bool Capture::setup( void )
       if( captureSource.sio )
       {
          // setup serial interface ( boudrate, num bits, parity, stop bits
+         // the log output uses the same usart
+         uint8_t config = uartConfig( settings.SerialBits, settings.SerialParity, settings.SerialStopBits );
+#ifdef USE_UART_ISR
+         uart.begin( settings.SerialBaudrate, config );
+
+         startMatcher.begin( settings.StartSample );
+         stopMatcher.begin( settings.StopSample );
+#else
+         Serial.begin( settings.SerialBaudrate ? settings.SerialBaudrate : UART_DEFAULT_BAUDRATE, config );
+#endif
       }
       if( captureSource.i2c )
       {
          // setup i2c interface
-         Wire.begin( 4 );                    // join i2c bus with address #4
-         Wire.onReceive( i2cReceiveEvent );  // register event
+#ifdef USE_TWI
+         i2c.begin( 4 );                     // join i2c bus with address #4
+#endif
       }
       if( captureSource.analog )
       {
@@ -182,47 +239,44 @@ bool Capture::start( void )
    bool rc = false;
    bool createNewCaptureFile = false;
 
+   // the sources are already running, their history is in the ring buffer
+   bool history = armed;
+   armed = false;
+
    sampleCount = 0;
    startTime = millis();
    sampleTime = 0;
 
-   // check if capture file exists
-   if( captureFile.open( settings.FileName, O_READ ) )
-   {
-      // capture file exists, so rename it
-      char newFileName[ 12 + 1 ];
-      LOGD( TAG, "alloc %d byte @ 0x%04x", sizeof( newFileName ), newFileName );
-
-      char *tmp = settings.FileName;
-      uint8_t i;
-      for( i = 0; i < 8; i++ )
-      {
-         if( *tmp == '\0' || *tmp == '.' )
-            break;
-
-         newFileName[ i ] = *tmp++;
-      }
-      tmp = &newFileName[ i ];
+   schedule( SampleMain, settings.SamplingRate );
+   schedule( SampleSio, settings.SerialSamplingRate );
+   schedule( SampleI2c, settings.I2cSamplingRate );
 
-      uint16_t index = 0;
-      for( index = 0; index < 1000; index++ )
-      {
-         SdFile tmpFile;
-         LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( tmpFile ), &tmpFile );
+   // the parts of a rotated capture have the size RotateSize
+   rotating = settings.RotateSize || settings.RotateTime;
+   fileSize = settings.RotateSize ? settings.RotateSize : settings.FileSize;
+   part = 0;
+   partStartTime = startTime;
+   partStartMicros = timebase.micros();
 
-         snprintf_P( tmp, 5, PSTR( ".%03u" ), index );
-         if( !tmpFile.open( newFileName ) )
-         {
-            createNewCaptureFile = true;
-            break;
-         }
-         tmpFile.close();
-      }
+   char newFileName[ 12 + 1 ];
+   LOGD( TAG, "alloc %d byte @ 0x%04x", sizeof( newFileName ), newFileName );
+   const char *fileName = settings.FileName;
 
-      if( createNewCaptureFile )
+   if( rotating )
+   {
+      // all parts are named with a sequence number
+      createNewCaptureFile = nextName( newFileName );
+      fileName = newFileName;
+   }
+   // check if capture file exists
+   else if( captureFile.open( settings.FileName, O_READ ) )
+   {
+      // capture file exists, so rename it
+      if( nextName( newFileName ) )
       {
          LOGI( TAG, "rename <%s> to <%s>", settings.FileName, newFileName );
          captureFile.rename( newFileName );
+         createNewCaptureFile = true;
       }
       else
       {
@@ -240,28 +294,93 @@ bool Capture::start( void )
 
    if( createNewCaptureFile )
    {
-      LOGD( TAG, "captureFile.open: <%s>", settings.FileName );
-      if( !captureFile.open( settings.FileName, ( O_READ | O_WRITE | O_CREAT | O_TRUNC ) ) )
+      if( !createFile( &captureFile, fileName ) )
       {
-         LOGE( TAG, "Can't open capture file: <%s>", settings.FileName );
+         LOGE( TAG, "Can't open capture file: <%s>", fileName );
          flags.sdcard_error = true;
       }
       else
       {
+         // the history has absolute times, so has the first record behind it
+         if( history )
+            lastRecordTime = partStartMicros - RECORD_TIME_EXT;
+         else
+            lastRecordTime = partStartMicros;
+
+         // the file system isn't accessible while streaming
+         if( rotating )
+            createNext();
+
+         // a power loss leaves the journal, see Recovery.cpp
+         if( !writeJournal( &captureFile, &nextFile ) )
+            LOGW( TAG, "Can't write the journal" );
+
+#ifdef USE_RAW_WRITE
+         if( fileSize != 0 && fileSize != ( uint32_t )( -1 ) && !rawStart() )
+         {
+            LOGW( TAG, "Can't stream to card, error 0x%02x", sd.card()->errorCode() );
+         }
+#endif
+
+         if( !history )
+            ringBuf.begin( &captureFile );
+         droppedBytes = 0;
+         droppedSamples = 0;
+         syncPosition = 0;
+         syncTime = startTime;
+         syncDataTime = startTime;
+         syncDataBytes = 0;
+         syncCount = 0;
+         syncMaxUs = 0;
+         syncTotalUs = 0;
+         maxAtRisk = 0;
+         highWater = ringBuf.bytesUsed();
+#ifdef USE_ADC_DELTA
+         adcKeyCount = 0;
+#endif
+
+         // in front of the history in the ring buffer
+         writeHeader( "" );
+
          // start capture sources
          if( captureSource.val )
          {
             if( captureSource.sio )
             {
+#ifdef USE_UART_ISR
+               // without a start pattern and without a history, drop what was
+               // received before the start
+               if( !history && !startMatcher.enabled() )
+                  uart.clear();
+               sioOverflowStart = uart.overflows();
+               stopMatcher.reset();
+               sioStopped = false;
+#endif
             }
             if( captureSource.i2c )
             {
+#ifdef USE_TWI
+               // without a history, drop the frames received while waiting
+               // for the start, their time stamps are before the header
+               if( !history )
+                  i2c.clear();
+               i2cLostStart = i2c.lostFrames();
+#endif
             }
             if( captureSource.analog )
             {
+#ifdef USE_ADC_ISR
+               if( !history )
+                  adc.begin( captureSource.analog, settings.SamplingPeriodUs, settings.Oversampling, settings.OversamplingBits );
+#endif
             }
             if( captureSource.digital )
             {
+#ifdef USE_PCINT
+               if( !history )
+                  pcint.begin( edgePins() );
+               edgesLost = 0;
+#endif
             }
          }
          rc = true;
@@ -279,254 +398,1846 @@ bool Capture::start( void )
 #ifndef PRINTF_BUFFER_SIZE
    #define PRINTF_BUFFER_SIZE          64          // resulting string limited to 64 chars
 #endif
+
+#ifndef SIO_CHUNK_SIZE
+   #define SIO_CHUNK_SIZE              40          // max bytes of a burst in one record or line
+#endif
 #ifndef TIME2STR_LEN
    #define TIME2STR_LEN                16 + 1
 #endif
+#ifndef RECORD_BUFFER_SIZE
+   #define RECORD_BUFFER_SIZE          64          // one binary record, header and payload
+#endif
+#ifndef ADC_KEYFRAME_INTERVAL
+   #define ADC_KEYFRAME_INTERVAL       8           // adc delta blocks from one keyframe to the next
+#endif
 
-bool Capture::run( void )
+// Each source has its own period. The next deadline is advanced by the
+// period and not computed from the time of the sample, so a late sample
+// doesn't shift the following ones. When run() was so late that whole
+// periods are over, these deadlines are skipped and counted as missed.
+// A source calls sampled() when a due deadline took a sample or wrote data,
+// so a deadline of period 0 isn't counted with each call of run().
+
+void Capture::schedule( uint8_t id, uint32_t period )
 {
-   // get on set of data from capture sources and write them to the file
+   deadline[ id ].period = period;
+   deadline[ id ].next = startTime;
+   deadline[ id ].count = 0;
+   deadline[ id ].missed = 0;
+   deadline[ id ].maxLate = 0;
+}
 
-   bool rc = false;
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-   // make a buffer for assembling the data to log:
-   char print_buf[ PRINTF_BUFFER_SIZE ];
-   // LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( print_buf ), print_buf );
+bool Capture::due( uint8_t id )
+{
+   uint32_t late = sampleTime - deadline[ id ].next;
 
-   uint8_t buflen = sizeof( print_buf ) - 1;
-   char* buf = print_buf;               // save begin of buffer
+   // not yet, the difference wraps around
+   if( ( int32_t )late < 0 )
+      return false;
 
-   sampleTime = millis();
+   if( deadline[ id ].period == 0 )
+      return true;
 
-   // capture sources
-   if( captureSource.val )
+   if( late > deadline[ id ].maxLate )
+      deadline[ id ].maxLate = late > 0xFFFF ? 0xFFFF : late;
+
+   uint32_t periods = late / deadline[ id ].period;
+   if( periods )
    {
-      bool have_sampled_data = false;
-      bool sample_time_written = false;
+      uint32_t missed = deadline[ id ].missed + periods;
+      deadline[ id ].missed = missed > 0xFFFF ? 0xFFFF : missed;
+   }
 
-      int16_t written = _log_time2str( buf, buflen, sampleTime );
-      buf[ written ] = '\0';
+   deadline[ id ].next += ( periods + 1 ) * deadline[ id ].period;
+   return true;
+}
 
-      if( captureSource.sio && sampleTime >= nextSampleSioTime )
-      {
-         int available = Serial.available();
-         if( available > 0 )
-         {
-            if( !sample_time_written )
-            {
-               captureFile.print( print_buf );
-               sample_time_written = true;
-            }
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-            buf = print_buf;
-            buflen = sizeof( print_buf ) - 1;
-            written = snprintf_P( buf, buflen, PSTR( " SIO \"" ) );
-            buf[ written ] = '\0';
-            buf += written;
-            buflen -= written;
+// The name of the capture file with the first free extension .000 .. .999.
+// Opening each candidate would scan the directory once per existing file,
+// so the directory is read only once and the used extensions are marked in a
+// bitmap. The short names in the directory are upper case and padded with
+// blanks.
 
-            int num_bytes_read = available;
-            if( num_bytes_read > buflen - 2 )
-               num_bytes_read > buflen - 2 ;
+bool Capture::nextName( char *name )
+{
+   char *tmp = settings.FileName;
+   uint8_t i;
+   for( i = 0; i < 8; i++ )
+   {
+      if( *tmp == '\0' || *tmp == '.' )
+         break;
 
-            written = Serial.readBytes( buf, num_bytes_read );
-            buf += written;
-            buflen -= written;
-            written = snprintf_P( buf, buflen, PSTR( "\"" ) );
+      name[ i ] = *tmp++;
+   }
+   tmp = &name[ i ];
 
-            captureFile.print( print_buf );
-            have_sampled_data = true;
-         }
-          nextSampleTime = sampleTime + settings.SerialSamplingRate;
-      }
+   uint8_t used[ ( 1000 + 7 ) / 8 ];
+   LOGD( TAG, "alloc %d byte @ 0x%04x", sizeof( used ), used );
+   memset( used, 0, sizeof( used ) );
 
-      if( captureSource.i2c  && sampleTime >= nextSampleI2cTime )
+   // the files are opened relative to the root directory
+   FatFile dir;
+   DirFat_t entry;
+   int8_t n = -1;
+
+   if( dir.openRoot( sd.vol() ) )
+   {
+      while( ( n = dir.readDir( &entry ) ) > 0 )
       {
-#ifdef USE_TWI
-         if( posSemaphoreTake( I2C_ReceiveEvent ) )
+         uint8_t k;
+         for( k = 0; k < 8; k++ )
          {
-            if( !sample_time_written )
-            {
-               captureFile.print( print_buf );
-               sample_time_written = true;
-            }
+            char c = k < i ? toupper( name[ k ] ) : ' ';
+            if( entry.name[ k ] != c )
+               break;
+         }
+         if( k < 8 )
+            continue;
 
-            buf = print_buf;
-            buflen = sizeof( print_buf ) - 1;
-            written = snprintf_P( buf, buflen, PSTR( " I2C" ) );
-            buf[ written ] = '\0';
-            buf += written;
-            buflen -= written;
+         uint16_t index = 0;
+         for( k = 8; k < 11; k++ )
+         {
+            if( !isdigit( entry.name[ k ] ) )
+               break;
+            index = index * 10 + entry.name[ k ] - '0';
+         }
+         if( k == 11 )
+            used[ index >> 3 ] |= 1 << ( index & 7 );
+      }
+      dir.close();
+   }
 
-            while( Wire.available() ) // loop through all but the last
-            {
-               uint16_t val = Wire.read(); // receive byte as a integer
+   // don't overwrite a file which wasn't seen
+   if( n < 0 )
+   {
+      LOGE( TAG, "Can't read directory" );
+      return false;
+   }
 
-               written = snprintf_P( buf, buflen, PSTR( " 0x%02x" ), val );
-               buf[ written ] = '\0';
-               buf += written;
-               buflen -= written;
-               if( buflen < 5 )
-               {
-                  captureFile.print( print_buf );
-                  buf = print_buf;
-                  buflen = sizeof( print_buf ) - 1;
-               }
-            }
-            captureFile.print( print_buf );
-            have_sampled_data = true;
-         }
-#endif
-          nextSampleTime = sampleTime + settings.I2cSamplingRate;
+   for( uint16_t index = 0; index < 1000; index++ )
+   {
+      if( !( used[ index >> 3 ] & ( 1 << ( index & 7 ) ) ) )
+      {
+         snprintf_P( tmp, 5, PSTR( ".%03u" ), index );
+         return true;
       }
+   }
+   return false;
+}
 
-      if( sampleTime >= nextSampleTime )
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::createFile( SdFile *file, const char *name )
+{
+   LOGD( TAG, "open: <%s>", name );
+   if( !file->open( name, ( O_READ | O_WRITE | O_CREAT | O_TRUNC ) ) )
+      return false;
+
+   // reserve contiguous clusters for the capture file, so no FAT sector
+   // has to be read or written while capturing
+   if( fileSize != 0 && fileSize != ( uint32_t )( -1 ) )
+   {
+      LOGD( TAG, "preAllocate: %ld", fileSize );
+      if( !file->preAllocate( fileSize ) )
       {
-         if( captureSource.analog )
-         {
-            // On ATmega based boards (UNO, Nano, Mini, Mega), it takes about
-            // 100 microseconds (0.0001 s) to read an analog input, so the maximum
-            // reading rate is about 10,000 times a second.
+         // not enough contiguous space, let the file grow cluster by cluster
+         LOGW( TAG, "Can't preallocate %ld bytes", fileSize );
+      }
+   }
+   return true;
+}
 
-            if( !sample_time_written )
-            {
-               captureFile.print( print_buf );
-               sample_time_written = true;
-            }
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-            buf = print_buf;
-            buflen = sizeof( print_buf ) - 1;
-            written = snprintf_P( buf, buflen, PSTR( " ADC" ) );
-            buf[ written ] = '\0';
-            buf += written;
-            buflen -= written;
+// The file of the next part is created and preallocated while the file system
+// is accessible, at the start and at the switch to the part before. So the
+// switch only has to close the full file and start the stream to the next one.
 
-            // see also C:\Program Files (x86)\Arduino\hardware\arduino\avr\cores\arduino\wiring_analog.c
-            uint8_t mask = captureSource.analog;
-            for( uint8_t i = 0; i < 6; i++ )
-            {
-               if( mask & 1 )
-               {
-                  uint8_t pin = A0 + i;
-                  int sensor = analogRead( pin );
-                  LOGD( TAG, "%d: analog pin %d get %d", i, pin, sensor );
+bool Capture::createNext( void )
+{
+   char name[ 12 + 1 ];
 
-                  written = snprintf_P( buf, buflen, PSTR( " %d" ), sensor );
-                  buf[ written ] = '\0';
-                  buf += written;
-                  buflen -= written;
-               }
-               mask >>= 1;
-            }
-            captureFile.print( print_buf );
-            have_sampled_data = true;
-         }
-         if( captureSource.digital )
-         {
-            // read from port C
-            uint8_t port_c = PORTC;
-            // read from port D
-            uint8_t port_d = PORTD;
-            // combine both ports and maskout not selected pins
-            uint8_t digital = ( port_c & 0x3f | port_d & 0xc0 ) & captureSource.digital;
+   if( nextName( name ) && createFile( &nextFile, name ) && nextFile.sync() )
+      return true;
 
-            LOGD( TAG, "digital pins 0x%02x get 0x%02x", captureSource.digital, digital );
+   LOGW( TAG, "Can't create the next part" );
+   nextFile.close();
+   return false;
+}
 
-            if( !sample_time_written )
-            {
-               captureFile.print( print_buf );
-               sample_time_written = true;
-            }
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-            buf = print_buf;
-            buflen = sizeof( print_buf ) - 1;
-            written = snprintf_P( buf, buflen, PSTR( " DIG 0x%02x" ), digital );
-            buf[ written ] = '\0';
-            captureFile.print( print_buf );
-            have_sampled_data = true;
-         }
+uint32_t Capture::length( void )
+{
+   // bytes written to the capture file
+#ifdef USE_RAW_WRITE
+   if( rawBuf )
+      return ( ( rawSector - rawStartSector ) << 9 ) + rawCount;
+#endif
+   return captureFile.curPosition();
+}
 
-         nextSampleTime = sampleTime + settings.SamplingRate;
-      }
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-      if( have_sampled_data )
-      {
-         Led_Debug.oneshot();
-         sampleCount++;
+bool Capture::rotateDue( void )
+{
+   if( !rotating || armed )
+      return false;
 
-         captureFile.println();
-         if( captureFile.getError() )
-         {
-            flags.sdcard_error = true;
-         }
-         else
-            rc = true;
-      }
+   if( settings.RotateTime && sampleTime - partStartTime >= settings.RotateTime )
+      return true;
+
+   // keep room for the collected data and the data of the next run()
+   if( settings.RotateSize && length() + ringBuf.bytesUsed() + CAPTURE_ROTATE_RESERVE >= settings.RotateSize )
+      return true;
+
+   return false;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::rotate( void )
+{
+   char previous[ 12 + 1 ];
+
+   // write all collected data to the full file and close it
+   if( !writeOut( true ) )
+      return false;
+#ifdef USE_RAW_WRITE
+   if( rawBuf && !rawStop() )
+      return false;
+#endif
+
+   captureFile.getName( previous, sizeof( previous ) );
+   if( !captureFile.truncate() )
+      return false;
+   captureFile.close();
+
+   // switch to the next part, the ring buffer keeps the pointer to captureFile
+   if( !nextFile.isOpen() && !createNext() )
+      return false;
+
+   captureFile = nextFile;
+   nextFile = SdFile();
+   part++;
+   syncPosition = 0;
+   syncTime = sampleTime;
+   partStartTime = sampleTime;
+   partStartMicros = timebase.micros();
+
+   // the first record of a part has an absolute time
+   lastRecordTime = partStartMicros - RECORD_TIME_EXT;
+#ifdef USE_ADC_DELTA
+   adcKeyCount = 0;
+#endif
+
+   createNext();
+
+   if( !writeJournal( &captureFile, &nextFile ) )
+      LOGW( TAG, "Can't write the journal" );
+
+#ifdef USE_RAW_WRITE
+   if( fileSize != 0 && fileSize != ( uint32_t )( -1 ) && !rawStart() )
+   {
+      LOGW( TAG, "Can't stream to card, error 0x%02x", sd.card()->errorCode() );
    }
+#endif
 
-   return rc;
+   writeHeader( previous );
+
+   LOGI( TAG, "Part %u, previous <%s>", part, previous );
+   return true;
 }
 
 // --------------------------------------------------------------------------
 //
 // --------------------------------------------------------------------------
 
-bool Capture::stop( void )
+void Capture::writeHeader( const char *previous )
 {
-   // stop the capture soucre writing to file
+   // the ring buffer is empty or holds the history, the header is written
+   // in front of it
 
-   bool rc = false;
+   if( settings.FileType == BinaryFile )
+   {
+      FileHeader_t header;
+
+      memcpy( header.magic, RECORD_MAGIC, sizeof( header.magic ) );
+      header.version = RECORD_VERSION;
+      header.headerSize = sizeof( header );
+      header.source = captureSource.val;
+      header.startTime = startTime;
+      header.samplingRate = settings.SamplingRate;
+      header.part = part;
+      header.partTime = partStartTime;
+      header.partMicros = partStartMicros;
+      // no pointer to a member of the packed header
+      uint16_t clock_ms = 0;
+      header.clockTime = rtc.valid() ? rtc.at( partStartTime, &clock_ms ) : 0;
+      header.clockMs = clock_ms;
+      strncpy( header.previous, previous, sizeof( header.previous ) - 1 );
+      header.previous[ sizeof( header.previous ) - 1 ] = '\0';
+      writeDirect( &header, sizeof( header ) );
+   }
+   else if( rotating )
+   {
+      char print_buf[ PRINTF_BUFFER_SIZE ];
 
-   // stop sources
-   if( captureSource.val )
+      int16_t written = snprintf_P( print_buf, sizeof( print_buf ), PSTR( "Capture part %u, previous <%s>\r\n" ), part, previous );
+      writeDirect( print_buf, written );
+   }
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Capture::writeDirect( const void *buf, size_t len )
+{
+   // to the beginning of the file, len is less than one sector
+#ifdef USE_RAW_WRITE
+   if( rawBuf )
    {
-      if( captureSource.sio )
-      {
-      }
-      if( captureSource.i2c )
-      {
-      }
-      if( captureSource.analog )
+      memcpy( rawBuf + rawCount, buf, len );
+      rawCount += len;
+   }
+   else
+#endif
+      captureFile.write( buf, len );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::run( void )
+{
+   bool rc;
+
+   if( settings.FileType == BinaryFile )
+      rc = runBinary();
+   else
+      rc = runText();
+
+#ifdef USE_TWI
+   // the frames are queued by the twi isr, write all which are waiting
+   if( captureSource.i2c && due( SampleI2c ) )
+   {
+      bool written = false;
+      while( writeI2c() )
       {
+         written = true;
+         rc = !flags.sdcard_error;
+         if( !writeOut( false ) )
+            flags.sdcard_error = true;
       }
-      if( captureSource.digital )
+      if( written )
+         sampled( SampleI2c );
+   }
+#endif
+
+#ifdef USE_UART_ISR
+   // the usart receives by its own, write the received bursts
+   if( captureSource.sio && due( SampleSio ) )
+   {
+      bool written = false;
+      while( writeSio() )
       {
+         written = true;
+         rc = !flags.sdcard_error;
+         if( !writeOut( false ) )
+            flags.sdcard_error = true;
       }
-      rc = true;
+      if( written )
+         sampled( SampleSio );
    }
+#endif
 
-   // print some statistics
-   // sampleCount
-   // startTime
-   // sampleTime
-
-   char print_buf[ PRINTF_BUFFER_SIZE ];
-   LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( print_buf ), print_buf );
-   uint8_t buflen = sizeof( print_buf ) - 1;
-   char time2str_buf[TIME2STR_LEN ];
-   LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( time2str_buf ), time2str_buf );
+   // write the collected data to the file
+   if( !writeOut( false ) )
+      flags.sdcard_error = true;
 
-   _log_time2str( time2str_buf, TIME2STR_LEN, startTime );
-   snprintf_P( print_buf, buflen, PSTR( "Capture start time: %s" ), time2str_buf );
-   LOG( TAG, "%s", print_buf );
-   captureFile.println( print_buf );
+   // bound the data lost by a power loss
+   if( !checkpoint() )
+      flags.sdcard_error = true;
+
+   // continue with the next file
+   if( rotateDue() && !rotate() )
+   {
+      LOGE( TAG, "Can't switch to part %u", part + 1 );
+      flags.sdcard_error = true;
+   }
+
+   return rc;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The sources don't write to the file, they put their data into the ring buffer.
+// writeOut() moves the data from the ring buffer to the sector buffer of the
+// SdFat cache. Copying into the cache is cheap, the card is only accessed when
+// a sector is complete. So a complete sector is only written when the card has
+// finished the previous one. While the card is busy, the sources continue to
+// fill the ring buffer. When the ring buffer is full, new data is dropped and
+// counted.
+//
+// While ready for capture the ring buffer holds the pre-trigger history. The
+// oldest records are dropped to make room for the new ones, so the last
+// settings.PreTrigger bytes are written behind the file header at the start.
+
+bool Capture::room( size_t len )
+{
+   if( armed )
+   {
+      size_t window = settings.PreTrigger < CAPTURE_BUFFER_SIZE ? settings.PreTrigger : CAPTURE_BUFFER_SIZE;
+
+      // never drop the record which is just written
+      while( histCount > 1 && ringBuf.bytesUsed() + len > window )
+         dropOldest();
+
+      return ringBuf.bytesUsed() + len <= window;
+   }
+
+   if( ringBuf.bytesFree() >= len )
+      return true;
+
+   droppedBytes += len;
+   return false;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+size_t Capture::put( const void *buf, size_t len )
+{
+   // put all or nothing
+   if( !room( len ) )
+      return 0;
+
+   len = ringBuf.memcpyIn( buf, len );
+
+   if( armed )
+   {
+      if( histCount == 0 )
+         mark();
+      histLen[ ( histFirst + histCount - 1 ) & ( CAPTURE_HISTORY_RECORDS - 1 ) ] += len;
+   }
+
+   size_t used = ringBuf.bytesUsed();
+   if( used > highWater )
+      highWater = used;
+
+   return len;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Capture::countSamples( bool written, uint16_t samples )
+{
+   // the samples of a record are only counted when the record is in the
+   // ring buffer, the samples of a dropped record go to droppedSamples
+
+   if( written )
+      sampleCount += samples;
+   else
+      droppedSamples += samples;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The history is dropped record by record, so it always starts with a complete
+// record. mark() starts a new record, the binary records of the history have
+// absolute times. A record is shorter than 256 bytes.
+
+void Capture::mark( void )
+{
+   if( !armed )
+      return;
+
+   if( histCount )
+   {
+      // nothing was put since the last mark
+      if( histLen[ ( histFirst + histCount - 1 ) & ( CAPTURE_HISTORY_RECORDS - 1 ) ] == 0 )
+         return;
+
+      if( histCount == CAPTURE_HISTORY_RECORDS )
+         dropOldest();
+   }
+
+   histLen[ ( histFirst + histCount ) & ( CAPTURE_HISTORY_RECORDS - 1 ) ] = 0;
+   histCount++;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Capture::dropOldest( void )
+{
+   uint8_t tmp[ 16 ];
+   uint8_t len = histLen[ histFirst ];
+
+   while( len )
+   {
+      uint8_t n = len < sizeof( tmp ) ? len : sizeof( tmp );
+      ringBuf.memcpyOut( tmp, n );
+      len -= n;
+   }
+
+   histFirst = ( histFirst + 1 ) & ( CAPTURE_HISTORY_RECORDS - 1 );
+   histCount--;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::writeOut( bool all )
+{
+   // no file yet, the ring buffer holds the history
+   if( armed )
+      return true;
+
+#ifdef USE_RAW_WRITE
+   if( rawBuf )
+      return rawWriteOut( all );
+#endif
+
+   size_t used = ringBuf.bytesUsed();
+
+   if( !all )
+   {
+      // free bytes in the sector buffer of the cache
+      uint16_t sector_room = 512 - ( captureFile.curPosition() & 511 );
+      if( used >= sector_room )
+      {
+         // this will write a sector to the card, wait until the card is ready
+         if( captureFile.isBusy() )
+            return true;
+
+         used = sector_room;
+      }
+   }
+
+   if( used == 0 )
+      return true;
+
+   return ringBuf.writeOut( used ) == used;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// With settings.SyncSize, SyncTime or SyncIdle the capture file is synced
+// while capturing. sync() writes the cached sector and the directory entry
+// with the current size, so after a power loss the file holds all data up to
+// the last sync. Each sync costs a write of the current sector, which is
+// written again when it is full, and one of the directory sector. So these
+// settings trade the write amplification of the card against the data lost
+// at most. The bytes at risk are the bytes written since the last sync and
+// the bytes still waiting in the ring buffer.
+//
+// While streaming with USE_RAW_WRITE the directory entry has the size of the
+// preallocated file already and each full sector goes to the card at once,
+// only the sector buffer and the ring buffer are at risk. There is nothing
+// to sync, the stream isn't interrupted.
+
+uint32_t Capture::atRisk( void )
+{
+   uint32_t bytes = ringBuf.bytesUsed();
+
+#ifdef USE_RAW_WRITE
+   if( rawBuf )
+      return bytes + rawCount;
+#endif
+
+   return bytes + captureFile.curPosition() - syncPosition;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::checkpoint( void )
+{
+   if( armed )
+      return true;
+
+   uint32_t risk = atRisk();
+   if( risk > maxAtRisk )
+      maxAtRisk = risk;
+
+#ifdef USE_RAW_WRITE
+   if( rawBuf )
+      return true;
+#endif
+
+   // new data came in, the idle time starts again
+   if( risk != syncDataBytes )
+   {
+      syncDataBytes = risk;
+      syncDataTime = sampleTime;
+   }
+
+   if( risk == 0 )
+      return true;
+
+   // the directory entry of a growing file gets its first cluster with the
+   // first sync, after a power loss the recovery follows the chain from there
+   bool due = ( syncPosition == 0 && captureFile.curPosition() != 0 &&
+                captureFile.curPosition() == captureFile.fileSize() ) ||
+              ( settings.SyncSize && captureFile.curPosition() - syncPosition >= settings.SyncSize ) ||
+              ( settings.SyncTime && sampleTime - syncTime >= settings.SyncTime ) ||
+              ( settings.SyncIdle && sampleTime - syncDataTime >= settings.SyncIdle );
+   if( !due )
+      return true;
+
+   // the data in the ring buffer is synced, too
+   if( !writeOut( true ) )
+      return false;
+
+   uint32_t start = timebase.micros();
+   bool rc = captureFile.sync();
+   uint32_t elapsed = timebase.micros() - start;
+
+   syncCount++;
+   syncTotalUs += elapsed;
+   if( elapsed > syncMaxUs )
+      syncMaxUs = elapsed;
+
+   LOGD( TAG, "Sync %ld bytes in %ld us", risk, elapsed );
+
+   syncPosition = captureFile.curPosition();
+   syncTime = sampleTime;
+   syncDataBytes = 0;
+   return rc;
+}
+
+#ifdef USE_RAW_WRITE
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The card stays in multi sector write mode for the whole capture session,
+// so each sector costs only the data transfer and no command and no FAT
+// access. The sector buffer of the volume cache is borrowed for the data.
+// Nothing else may access the file system until rawStop() is called.
+
+bool Capture::rawStart( void )
+{
+   rawBuf = NULL;
+
+   if( !captureFile.contiguousRange( &rawStartSector, &rawEndSector ) )
+      return false;
+
+   // don't write beyond the preallocated size, seekSet() in rawStop() would fail
+   if( rawEndSector - rawStartSector > ( fileSize - 1 ) >> 9 )
+      rawEndSector = rawStartSector + ( ( fileSize - 1 ) >> 9 );
+
+   // write the directory entry and the cache, then take the cache buffer
+   if( !captureFile.sync() )
+      return false;
+
+   uint8_t *buf = sd.vol()->cacheClear();
+   if( !buf )
+      return false;
+
+   if( !sd.card()->writeStart( rawStartSector ) )
+      return false;
+
+   LOGI( TAG, "Stream to sector %ld .. %ld", rawStartSector, rawEndSector );
+   rawSector = rawStartSector;
+   rawCount = 0;
+   rawBuf = buf;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::rawWriteOut( bool all )
+{
+   for( ;; )
+   {
+      if( rawCount < 512 )
+      {
+         rawCount += ringBuf.memcpyOut( rawBuf + rawCount, 512 - rawCount );
+         if( rawCount < 512 )
+            return true;      // wait for more data
+      }
+
+      if( rawSector > rawEndSector )
+      {
+         // the file is full
+         droppedBytes += rawCount;
+         rawCount = 0;
+         continue;
+      }
+
+      // wait until the card has programmed the previous sector
+      if( !all && sd.card()->isBusy() )
+         return true;
+
+      if( !sd.card()->writeData( rawBuf ) )
+         return false;
+
+      rawSector++;
+      rawCount = 0;
+   }
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::rawStop( void )
+{
+   bool rc = true;
+   uint32_t length = ( rawSector - rawStartSector ) << 9;
+
+   // write the last partial sector
+   if( rawCount && rawSector <= rawEndSector )
+   {
+      memset( rawBuf + rawCount, 0, 512 - rawCount );
+      if( sd.card()->writeData( rawBuf ) )
+         length += rawCount;
+      else
+         rc = false;
+   }
+
+   if( !sd.card()->writeStop() )
+      rc = false;
+
+   rawBuf = NULL;
+
+   // continue with the file system behind the streamed data, truncate()
+   // updates the directory entry with the real length
+   if( !captureFile.seekSet( length ) )
+      rc = false;
+
+   LOGI( TAG, "Streamed %ld bytes", length );
+   return rc;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint8_t Capture::sampledPins( void )
+{
+   // the digital pins which are read with SamplingRate, with USE_PCINT only
+   // the pins without pin change events
+
+#ifdef USE_PCINT
+   return captureSource.digital & ~edgePins();
+#else
+   return captureSource.digital;
+#endif
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::runText( void )
+{
+   // get on set of data from capture sources and write them to the file
+
+   bool rc = false;
+
+   // assemble the line in one buffer, it is put with one call
+   TextRecord rec;
+
+   sampleTime = millis();
+
+   // capture sources
+   if( captureSource.val )
+   {
+      bool have_sampled_data = false;
+
+      rec.stamp( sampleTime );
+
+#ifndef USE_UART_ISR
+      if( captureSource.sio && due( SampleSio ) )
+      {
+         int available = Serial.available();
+         if( available > 0 )
+         {
+            char data[ SIO_CHUNK_SIZE ];
+
+            int num_bytes_read = available;
+            if( num_bytes_read > ( int )sizeof( data ) )
+               num_bytes_read = sizeof( data );
+
+            num_bytes_read = Serial.readBytes( data, num_bytes_read );
+
+            rec.label( PSTR( " SIO \"" ) );
+            rec.text( data, num_bytes_read );
+            rec.label( PSTR( "\"" ) );
+            have_sampled_data = true;
+            sampled( SampleSio );
+         }
+      }
+#endif
+
+      if( due( SampleMain ) )
+      {
+         bool main_sampled = false;
+#ifndef USE_ADC_ISR
+         if( captureSource.analog )
+         {
+            // On ATmega based boards (UNO, Nano, Mini, Mega), it takes about
+            // 100 microseconds (0.0001 s) to read an analog input, so the maximum
+            // reading rate is about 10,000 times a second.
+
+            rec.label( PSTR( " ADC" ) );
+
+            // see also C:\Program Files (x86)\Arduino\hardware\arduino\avr\cores\arduino\wiring_analog.c
+            uint8_t mask = captureSource.analog;
+            for( uint8_t i = 0; i < 6; i++ )
+            {
+               if( mask & 1 )
+               {
+                  uint8_t pin = A0 + i;
+                  int sensor = analogRead( pin );
+                  LOGD( TAG, "%d: analog pin %d get %d", i, pin, sensor );
+
+                  rec.value( sensor );
+               }
+               mask >>= 1;
+            }
+            have_sampled_data = true;
+            main_sampled = true;
+         }
+#endif
+         uint8_t pins = sampledPins();
+         if( pins )
+         {
+            // the pins D0 .. D7 are the inputs of port D, maskout not selected pins
+            uint8_t digital = PIND & pins;
+
+            LOGD( TAG, "digital pins 0x%02x get 0x%02x", pins, digital );
+
+            rec.label( PSTR( " DIG" ) );
+            rec.hex( digital );
+            have_sampled_data = true;
+            main_sampled = true;
+         }
+         if( main_sampled )
+            sampled( SampleMain );
+      }
+
+      if( have_sampled_data )
+      {
+         Led_Debug.oneshot();
+
+         rec.end();
+         mark();
+         countSamples( put( rec.data(), rec.length() ), 1 );
+         if( captureFile.getError() )
+         {
+            flags.sdcard_error = true;
+         }
+         else
+            rc = true;
+      }
+
+#ifdef USE_ADC_ISR
+      // the adc samples by its own, write one block when it is full
+      if( captureSource.analog && writeAdcBlock() )
+         rc = !flags.sdcard_error;
+#endif
+#ifdef USE_PCINT
+      // the pin changes are queued by the isr, write them as they come
+      if( captureSource.digital && writeEdges() )
+         rc = !flags.sdcard_error;
+#endif
+   }
+
+   return rc;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::runBinary( void )
+{
+   // get one set of data from capture sources and write it as one binary
+   // record to the file, for the record layout see Record.h
+
+   bool rc = false;
+
+   uint8_t rec_buf[ RECORD_BUFFER_SIZE ];
+   RecordHeader_t *header = ( RecordHeader_t * )rec_buf;
+   uint8_t *buf = rec_buf + sizeof( RecordHeader_t );
+   Source_t source = { 0 };
+
+   // the deadlines are in ms, the record time is in us
+   sampleTime = millis();
+   uint32_t now = timebase.micros();
+
+   uint32_t delta = now - lastRecordTime;
+   if( armed || delta >= RECORD_TIME_EXT )
+   {
+      header->timeDelta = RECORD_TIME_EXT;
+      memcpy( buf, &now, sizeof( now ) );
+      buf += sizeof( now );
+   }
+   else
+   {
+      header->timeDelta = ( uint16_t )delta;
+   }
+
+   if( due( SampleMain ) )
+   {
+#ifndef USE_ADC_ISR
+      if( captureSource.analog )
+      {
+         uint8_t mask = captureSource.analog;
+         for( uint8_t i = 0; i < 6; i++ )
+         {
+            if( mask & 1 )
+            {
+               uint16_t sensor = analogRead( A0 + i );
+               memcpy( buf, &sensor, sizeof( sensor ) );
+               buf += sizeof( sensor );
+            }
+            mask >>= 1;
+         }
+         source.analog = captureSource.analog;
+      }
+#endif
+      uint8_t pins = sampledPins();
+      if( pins )
+      {
+         // the pins D0 .. D7 are the inputs of port D
+         *buf++ = PIND & pins;
+         source.digital = pins;
+      }
+      if( source.val )
+         sampled( SampleMain );
+   }
+
+#ifndef USE_UART_ISR
+   if( captureSource.sio && due( SampleSio ) )
+   {
+      int available = Serial.available();
+      if( available > 0 )
+      {
+         uint8_t *buf_end = rec_buf + sizeof( rec_buf );
+         int room = buf_end - buf - 1;
+         if( available > room )
+            available = room;
+
+         *buf = Serial.readBytes( ( char * )buf + 1, available );
+         buf += 1 + *buf;
+         source.sio = 1;
+         sampled( SampleSio );
+      }
+   }
+#endif
+
+   if( source.val )
+   {
+      header->sync = RECORD_SYNC;
+      header->source = source.val;
+
+      // one write per record, the following record is relative to this one
+      mark();
+      bool written = put( rec_buf, buf - rec_buf );
+      if( written )
+         lastRecordTime = now;
+
+      Led_Debug.oneshot();
+      countSamples( written, 1 );
+
+      if( captureFile.getError() )
+      {
+         flags.sdcard_error = true;
+      }
+      else
+         rc = true;
+   }
+   else if( delta >= CAPTURE_TIME_KEEPALIVE )
+   {
+      // the absolute times wrap around after 71 minutes, a decoder can follow
+      // them only when there is no longer gap between two records
+      struct __attribute__( ( packed ) )
+      {
+         RecordHeader_t header;
+         uint32_t time;
+      } rec;
+
+      rec.header.sync = RECORD_SYNC_TIME;
+      rec.header.source = 0;
+      rec.header.timeDelta = RECORD_TIME_EXT;
+      rec.time = now;
+
+      mark();
+      if( put( &rec, sizeof( rec ) ) )
+         lastRecordTime = now;
+   }
+
+#ifdef USE_ADC_ISR
+   // the adc samples by its own, write one block when it is full
+   if( captureSource.analog && writeAdcBlock() )
+      rc = !flags.sdcard_error;
+#endif
+#ifdef USE_PCINT
+   // the pin changes are queued by the isr, write them as they come
+   if( captureSource.digital && writeEdges() )
+      rc = !flags.sdcard_error;
+#endif
+
+   return rc;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// With settings.PreTrigger the sources are sampled already while ready for
+// capture, into the ring buffer as history. start() writes the history behind
+// the file header and continues with the running sources.
+
+void Capture::arm( void )
+{
+   armed = false;
+   histFirst = 0;
+   histCount = 0;
+   ringBuf.begin( &captureFile );
+
+   if( settings.PreTrigger == 0 || captureSource.val == 0 )
+      return;
+
+   sampleCount = 0;
+   startTime = millis();
+   sampleTime = startTime;
+
+   schedule( SampleMain, settings.SamplingRate );
+   schedule( SampleSio, settings.SerialSamplingRate );
+   schedule( SampleI2c, settings.I2cSamplingRate );
+
+   // there is no file yet, a previous error must not stop the next capture
+   captureFile.clearError();
+
+#ifdef USE_UART_ISR
+   if( captureSource.sio )
+   {
+      startMatcher.reset();
+      sioStopped = false;
+   }
+#endif
+#ifdef USE_ADC_ISR
+   if( captureSource.analog )
+      adc.begin( captureSource.analog, settings.SamplingPeriodUs, settings.Oversampling, settings.OversamplingBits );
+#endif
+#ifdef USE_PCINT
+   if( captureSource.digital )
+      pcint.begin( edgePins() );
+#endif
+
+   armed = true;
+   LOGI( TAG, "Armed with %d bytes history", settings.PreTrigger );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::watch( void )
+{
+   // called while ready for capture
+   if( armed )
+   {
+      // sample into the history, writeSio() looks for the start pattern
+      run();
+      return true;
+   }
+
+#ifdef USE_UART_ISR
+   // look for the start pattern in the received serial data. The capture
+   // starts with the byte after the pattern, these bytes stay in the receive
+   // buffer.
+
+   if( !captureSource.sio || !startMatcher.enabled() )
+      return false;
+
+   uint8_t c;
+   uint32_t time;
+
+   while( uart.peekBurst( &c, 1, &time ) )
+   {
+      uart.skip( 1 );
+      if( startMatcher.feed( c ) )
+      {
+         LOGI( TAG, "Start pattern <%s> received", settings.StartSample );
+         posSemaphoreGive( StartStopCapture );
+         return true;
+      }
+   }
+#endif
+   return false;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_TWI
+
+bool Capture::writeI2c( void )
+{
+   // write one received frame with the time of the transaction, to the
+   // binary file as an own record, to the text file as an own line
+
+   I2cFrame_t *frame = i2c.get();
+   if( frame == NULL )
+      return false;
+
+   uint8_t len = frame->len;
+   bool written;
+   mark();
+
+   if( settings.FileType == BinaryFile )
+   {
+      uint8_t rec_buf[ sizeof( RecordHeader_t ) + sizeof( frame->time ) + 1 ];
+      RecordHeader_t *header = ( RecordHeader_t * )rec_buf;
+      uint8_t *buf = rec_buf + sizeof( RecordHeader_t );
+      Source_t source = { 0 };
+
+      source.i2c = 1;
+      header->sync = RECORD_SYNC;
+      header->source = source.val;
+
+      // a frame older than the previous record wraps around to a large delta
+      uint32_t delta = frame->time - lastRecordTime;
+      if( armed || delta >= RECORD_TIME_EXT )
+      {
+         header->timeDelta = RECORD_TIME_EXT;
+         memcpy( buf, &frame->time, sizeof( frame->time ) );
+         buf += sizeof( frame->time );
+      }
+      else
+      {
+         header->timeDelta = ( uint16_t )delta;
+      }
+      *buf++ = len;
+
+      written = room( buf - rec_buf + len );
+      if( written )
+      {
+         put( rec_buf, buf - rec_buf );
+         put( frame->data, len );
+         lastRecordTime = frame->time;
+      }
+   }
+   else
+   {
+      TextRecord rec;
+
+      rec.stamp( timebase.millis( frame->time ) );
+      rec.label( PSTR( " I2C" ) );
+
+      // " 0x12" for each byte and the line end, a long frame is put in pieces
+      written = room( rec.length() + len * 5 + 2 );
+      if( written )
+      {
+         for( uint8_t i = 0; i < len; i++ )
+         {
+            if( rec.room() < 5 )
+            {
+               put( rec.data(), rec.length() );
+               rec.clear();
+            }
+            rec.hex( frame->data[ i ] );
+         }
+         rec.end();
+         put( rec.data(), rec.length() );
+      }
+   }
+
+   i2c.release();
+
+   Led_Debug.oneshot();
+   countSamples( written, 1 );
+
+   if( captureFile.getError() )
+      flags.sdcard_error = true;
+
+   return true;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_UART_ISR
+
+bool Capture::writeSio( void )
+{
+   // write one chunk of a received burst with the time of the burst, to the
+   // binary file as an own record, to the text file as an own line
+
+   uint8_t data[ SIO_CHUNK_SIZE ];
+   uint32_t time;
+
+   // the bytes behind the start or stop pattern belong to the next state
+   if( sioStopped )
+      return false;
+
+   uint8_t len = uart.peekBurst( data, sizeof( data ), &time );
+   if( len == 0 )
+      return false;
+
+   // while armed look for the start pattern, the history ends with it
+   Matcher *matcher = armed ? &startMatcher : &stopMatcher;
+   if( matcher->enabled() )
+   {
+      for( uint8_t i = 0; i < len; i++ )
+      {
+         if( matcher->feed( data[ i ] ) )
+         {
+            if( armed )
+               LOGI( TAG, "Start pattern <%s> received", settings.StartSample );
+            else
+               LOGI( TAG, "Stop pattern <%s> received", settings.StopSample );
+            len = i + 1;
+            sioStopped = true;
+            posSemaphoreGive( StartStopCapture );
+            break;
+         }
+      }
+   }
+   uart.skip( len );
+   bool written;
+   mark();
+
+   if( settings.FileType == BinaryFile )
+   {
+      uint8_t rec_buf[ sizeof( RecordHeader_t ) + sizeof( time ) + 1 ];
+      RecordHeader_t *header = ( RecordHeader_t * )rec_buf;
+      uint8_t *buf = rec_buf + sizeof( RecordHeader_t );
+      Source_t source = { 0 };
+
+      source.sio = 1;
+      header->sync = RECORD_SYNC;
+      header->source = source.val;
+
+      // a burst older than the previous record wraps around to a large delta
+      uint32_t delta = time - lastRecordTime;
+      if( armed || delta >= RECORD_TIME_EXT )
+      {
+         header->timeDelta = RECORD_TIME_EXT;
+         memcpy( buf, &time, sizeof( time ) );
+         buf += sizeof( time );
+      }
+      else
+      {
+         header->timeDelta = ( uint16_t )delta;
+      }
+      *buf++ = len;
+
+      written = room( buf - rec_buf + len );
+      if( written )
+      {
+         put( rec_buf, buf - rec_buf );
+         put( data, len );
+         lastRecordTime = time;
+      }
+   }
+   else
+   {
+      TextRecord rec;
+
+      rec.stamp( timebase.millis( time ) );
+      rec.label( PSTR( " SIO \"" ) );
+      rec.text( data, len );
+      rec.label( PSTR( "\"" ) );
+      rec.end();
+      written = put( rec.data(), rec.length() );
+   }
+
+   Led_Debug.oneshot();
+   countSamples( written, 1 );
+
+   if( captureFile.getError() )
+      flags.sdcard_error = true;
+
+   return true;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_ADC_ISR
+
+bool Capture::writeAdcBlock( void )
+{
+   // write one full block of the timer triggered adc to the file,
+   // return false when no block is available
+
+   AdcBlock_t *block = adc.get();
+   if( block == NULL )
+      return false;
+
+   uint8_t channels = adc.channels();
+   uint8_t scans = block->count / channels;
+   uint32_t period_us = adc.periodUs();
+
+   if( settings.FileType == BinaryFile )
+   {
+#ifdef USE_ADC_DELTA
+      struct __attribute__( ( packed ) )
+      {
+         RecordHeader_t header;
+         uint32_t time;
+         AdcBlockHeader_t adc;
+         AdcDeltaHeader_t delta;
+      } rec;
+
+      // the history drops blocks, so each block of it is a keyframe
+      bool keyframe = armed || adcKeyCount == 0;
+      if( keyframe )
+         memset( adcPrev, 0, sizeof( adcPrev ) );
+
+      // zigzag delta to the previous scan of the channel, as varint
+      uint8_t data[ ADC_BLOCK_SIZE * 3 ];
+      uint8_t data_len = 0;
+      uint16_t *value = block->data;
+
+      for( uint8_t i = 0; i < scans; i++ )
+      {
+         for( uint8_t ch = 0; ch < channels; ch++ )
+         {
+            int16_t delta = *value - adcPrev[ ch ];
+            adcPrev[ ch ] = *value++;
+
+            uint16_t zigzag = ( ( uint16_t )delta << 1 ) ^ ( uint16_t )( delta >> 15 );
+            while( zigzag >= 0x80 )
+            {
+               data[ data_len++ ] = ( uint8_t )zigzag | 0x80;
+               zigzag >>= 7;
+            }
+            data[ data_len++ ] = ( uint8_t )zigzag;
+         }
+      }
+
+      rec.header.sync = RECORD_SYNC_ADC_DELTA;
+      rec.delta.keyframe = keyframe;
+      rec.delta.size = data_len;
+#else
+      struct __attribute__( ( packed ) )
+      {
+         RecordHeader_t header;
+         uint32_t time;
+         AdcBlockHeader_t adc;
+      } rec;
+
+      uint16_t *data = block->data;
+      uint16_t data_len = block->count * sizeof( block->data[ 0 ] );
+
+      rec.header.sync = RECORD_SYNC_ADC;
+#endif
+      rec.header.source = captureSource.analog;
+      rec.header.timeDelta = RECORD_TIME_EXT;
+      rec.time = block->time;
+      rec.adc.scans = scans;
+      rec.adc.lost = block->lost;
+      rec.adc.period = period_us;
+
+      mark();
+      // the following record is relative to this one
+      if( room( sizeof( rec ) + data_len ) )
+      {
+         put( &rec, sizeof( rec ) );
+         put( data, data_len );
+         lastRecordTime = block->time;
+         sampleCount += scans;
+#ifdef USE_ADC_DELTA
+         if( ++adcKeyCount >= ADC_KEYFRAME_INTERVAL )
+            adcKeyCount = 0;
+#endif
+      }
+      else
+      {
+         droppedSamples += scans + block->lost;
+#ifdef USE_ADC_DELTA
+         // the deltas of the next block would refer to the dropped one
+         adcKeyCount = 0;
+#endif
+      }
+   }
+   else
+   {
+      TextRecord rec;
+      uint16_t *data = block->data;
+
+      if( block->lost )
+      {
+         rec.label( PSTR( "ADC" ) );
+         rec.value( block->lost );
+         rec.label( PSTR( " scans lost" ) );
+         rec.end();
+         mark();
+         // without the line the lost scans are not in the file
+         if( !put( rec.data(), rec.length() ) )
+            countSamples( false, block->lost );
+      }
+
+      for( uint8_t i = 0; i < scans; i++ )
+      {
+         rec.clear();
+         rec.stamp( timebase.millis( block->time + i * period_us ) );
+         rec.label( PSTR( " ADC" ) );
+
+         for( uint8_t ch = 0; ch < channels; ch++ )
+            rec.value( *data++ );
+
+         rec.end();
+         mark();
+         countSamples( put( rec.data(), rec.length() ), 1 );
+
+         // a text block doesn't fit into the ring buffer
+         if( !writeOut( false ) )
+            flags.sdcard_error = true;
+      }
+   }
+
+   adc.release();
+
+   if( captureFile.getError() )
+      flags.sdcard_error = true;
+
+   return true;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_PCINT
+
+#ifndef EDGE_CHUNK_SIZE
+   #define EDGE_CHUNK_SIZE             8           // max pin changes in one record
+#endif
+
+uint8_t Capture::edgePins( void )
+{
+   // D0 and D1 are RXD and TXD of the usart. While the serial interface is
+   // captured, their edges would fill the queue with the serial data, so they
+   // are read with SamplingRate instead, see sampledPins().
+
+   if( captureSource.sio )
+      return captureSource.digital & ~0x03;
+
+   return captureSource.digital;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::writeEdges( void )
+{
+   // write the queued pin changes, to the binary file as one record, to the
+   // text file one line per change. Return false when no change is queued.
+
+   PcintEvent_t *event = pcint.get();
+   if( event == NULL )
+      return false;
+
+   uint32_t first_us = event->time;
+   uint16_t lost = pcint.lostEvents();
+   edgesLost += lost;
+
+   if( settings.FileType == BinaryFile )
+   {
+      struct __attribute__( ( packed ) )
+      {
+         RecordHeader_t header;
+         uint32_t time;
+         EdgeBlockHeader_t edges;
+         struct __attribute__( ( packed ) )
+         {
+            uint32_t us;
+            uint8_t  state;
+         } edge[ EDGE_CHUNK_SIZE ];
+      } rec;
+
+      Source_t source = { 0 };
+      uint8_t count = 0;
+
+      while( event && count < EDGE_CHUNK_SIZE )
+      {
+         rec.edge[ count ].us = event->time;
+         rec.edge[ count ].state = event->state;
+         count++;
+         pcint.release();
+         event = pcint.get();
+      }
+
+      rec.header.sync = RECORD_SYNC_EDGE;
+      source.digital = edgePins();
+      rec.header.source = source.val;
+      rec.header.timeDelta = RECORD_TIME_EXT;
+      rec.time = first_us;
+      rec.edges.count = count;
+      rec.edges.lost = lost;
+
+      // the following record is relative to this one
+      mark();
+      bool written = put( &rec, sizeof( rec ) - ( EDGE_CHUNK_SIZE - count ) * sizeof( rec.edge[ 0 ] ) );
+      if( written )
+         lastRecordTime = first_us;
+      countSamples( written, count );
+   }
+   else
+   {
+      TextRecord rec;
+
+      // the ms time of the first change, from the us since then
+      uint32_t time = timebase.millis( first_us );
+
+      if( lost )
+      {
+         rec.label( PSTR( "DIG" ) );
+         rec.value( lost );
+         rec.label( PSTR( " changes lost" ) );
+         rec.end();
+         mark();
+         put( rec.data(), rec.length() );
+      }
+
+      for( uint8_t i = 0; event && i < EDGE_CHUNK_SIZE; i++ )
+      {
+         rec.clear();
+         rec.stamp( time + ( event->time - first_us ) / 1000 );
+         rec.label( PSTR( " DIG" ) );
+         rec.hex( event->state );
+         rec.value( event->time );
+         rec.label( PSTR( " us" ) );
+         rec.end();
+         mark();
+         countSamples( put( rec.data(), rec.length() ), 1 );
+
+         pcint.release();
+         event = pcint.get();
+      }
+   }
+
+   Led_Debug.oneshot();
+
+   if( captureFile.getError() )
+      flags.sdcard_error = true;
+
+   return true;
+}
+
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Capture::stop( void )
+{
+   // stop the capture soucre writing to file
+
+   bool rc = false;
+
+   // stop sources
+   if( captureSource.val )
+   {
+      if( captureSource.sio )
+      {
+#ifdef USE_UART_ISR
+         // write the remaining bursts, up to the stop pattern
+         while( writeSio() )
+            writeOut( true );
+
+         startMatcher.reset();
+#endif
+      }
+      if( captureSource.i2c )
+      {
+#ifdef USE_TWI
+         // write the remaining frames
+         while( writeI2c() )
+            writeOut( true );
+#endif
+      }
+      if( captureSource.analog )
+      {
+#ifdef USE_ADC_ISR
+         adc.end();
+
+         // write the remaining samples
+         do
+         {
+            writeOut( true );
+         }
+         while( writeAdcBlock() );
+#endif
+      }
+      if( captureSource.digital )
+      {
+#ifdef USE_PCINT
+         pcint.end();
+
+         // write the remaining pin changes
+         while( writeEdges() )
+            writeOut( true );
+
+         // lost after the last change in the queue
+         edgesLost += pcint.lostEvents();
+#endif
+      }
+      rc = true;
+   }
+
+   // write all collected data to the file
+   if( !writeOut( true ) )
+      flags.sdcard_error = true;
+
+#ifdef USE_RAW_WRITE
+   if( rawBuf && !rawStop() )
+      flags.sdcard_error = true;
+#endif
+
+   // print some statistics
+   // sampleCount
+   // startTime
+   // sampleTime
+   // deadline statistics
+   // i2c lost frames
+   // sio overflow
+   // pin changes lost
+   // droppedBytes, droppedSamples
+   // highWater
+
+   char print_buf[ PRINTF_BUFFER_SIZE ];
+   LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( print_buf ), print_buf );
+   uint8_t buflen = sizeof( print_buf ) - 1;
+   char time2str_buf[TIME2STR_LEN ];
+   LOGI( TAG, "alloc %d byte @ 0x%04x", sizeof( time2str_buf ), time2str_buf );
+
+   _log_time2str( time2str_buf, TIME2STR_LEN, startTime );
+   snprintf_P( print_buf, buflen, PSTR( "Capture start time: %s" ), time2str_buf );
+   LOG( TAG, "%s", print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
 
    _log_time2str( time2str_buf, TIME2STR_LEN, sampleTime );
    snprintf_P( print_buf, buflen, PSTR( "Capture end time:   %s" ), time2str_buf );
    LOG( TAG, "%s", print_buf );
-   captureFile.println( print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
+
+   if( rtc.valid() )
+   {
+      RtcDate_t date;
+      uint16_t ms;
+
+      Rtc::toDate( rtc.at( startTime, &ms ), &date );
+      snprintf_P( print_buf, buflen, PSTR( "Capture start clock: %04u-%02u-%02u %02u:%02u:%02u" ),
+                  date.year, date.month, date.day, date.hour, date.minute, date.second );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+
+      Rtc::toDate( rtc.at( sampleTime, &ms ), &date );
+      snprintf_P( print_buf, buflen, PSTR( "Capture end clock:   %04u-%02u-%02u %02u:%02u:%02u" ),
+                  date.year, date.month, date.day, date.hour, date.minute, date.second );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
 
    _log_time2str( time2str_buf, TIME2STR_LEN, sampleTime - startTime );
    snprintf_P( print_buf, buflen, PSTR( "Capture run time:   %s" ), time2str_buf );
    LOG( TAG, "%s", print_buf );
-   captureFile.println( print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
 
    snprintf_P( print_buf, buflen, PSTR( "Captured %ld samples" ), sampleCount );
    LOG( TAG, "%s", print_buf );
-   captureFile.println( print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
+
+   static const char deadline_name[ NUM_DEADLINES ][ 4 ] PROGMEM = { "SMP", "SIO", "I2C" };
+   uint32_t run_time = sampleTime - startTime;
+   for( uint8_t id = 0; id < NUM_DEADLINES; id++ )
+   {
+      if( deadline[ id ].count == 0 )
+         continue;
+
+      // achieved period, missed deadlines and max lateness
+      strcpy_P( print_buf, deadline_name[ id ] );
+      snprintf_P( print_buf + 3, buflen - 3, PSTR( " %ld samples, %ld ms, missed %u, late %u ms" ),
+                  deadline[ id ].count, run_time / deadline[ id ].count,
+                  deadline[ id ].missed, deadline[ id ].maxLate );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
+
+#ifdef USE_TWI
+   uint16_t i2c_lost = i2c.lostFrames() - i2cLostStart;
+   if( captureSource.i2c )
+   {
+      snprintf_P( print_buf, buflen, PSTR( "I2C lost %u frames" ), i2c_lost );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
+#else
+   uint16_t i2c_lost = 0;
+#endif
+
+#ifdef USE_UART_ISR
+   uint32_t sio_overflow = uart.overflows() - sioOverflowStart;
+   if( captureSource.sio )
+   {
+      snprintf_P( print_buf, buflen, PSTR( "SIO overflow %ld bytes" ), sio_overflow );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
+#else
+   uint32_t sio_overflow = 0;
+#endif
+
+#ifdef USE_PCINT
+   uint16_t edges_lost = edgesLost;
+   if( captureSource.digital )
+   {
+      snprintf_P( print_buf, buflen, PSTR( "DIG lost %u changes" ), edges_lost );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
+#else
+   uint16_t edges_lost = 0;
+#endif
+
+   if( rotating )
+   {
+      snprintf_P( print_buf, buflen, PSTR( "Captured %u parts" ), part + 1 );
+      LOG( TAG, "%s", print_buf );
+      if( settings.FileType == TextFile )
+         captureFile.println( print_buf );
+   }
+
+   snprintf_P( print_buf, buflen, PSTR( "Dropped %ld bytes, %ld samples, buffer max %d of %d" ), droppedBytes, droppedSamples, highWater, CAPTURE_BUFFER_SIZE );
+   LOG( TAG, "%s", print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
+
+   snprintf_P( print_buf, buflen, PSTR( "Synced %u times, %ld ms, max %ld us" ), syncCount, syncTotalUs / 1000, syncMaxUs );
+   LOG( TAG, "%s", print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
+
+   snprintf_P( print_buf, buflen, PSTR( "Max %ld bytes at risk" ), maxAtRisk );
+   LOG( TAG, "%s", print_buf );
+   if( settings.FileType == TextFile )
+      captureFile.println( print_buf );
+
+   if( settings.FileType == BinaryFile )
+   {
+      struct __attribute__( ( packed ) )
+      {
+         RecordHeader_t header;
+         RecordTrailer_t trailer;
+      } rec;
+
+      rec.header.sync = RECORD_SYNC;
+      rec.header.source = 0;
+      rec.header.timeDelta = 0;
+      rec.trailer.startTime = startTime;
+      rec.trailer.endTime = sampleTime;
+      rec.trailer.sampleCount = sampleCount;
+      rec.trailer.droppedBytes = droppedBytes;
+      rec.trailer.droppedSamples = droppedSamples;
+      rec.trailer.highWater = highWater;
+      rec.trailer.sioOverflow = sio_overflow;
+      rec.trailer.i2cLost = i2c_lost;
+      rec.trailer.edgesLost = edges_lost;
+      rec.trailer.parts = part + 1;
+      rec.trailer.syncCount = syncCount;
+      rec.trailer.syncTime = syncTotalUs;
+      rec.trailer.maxAtRisk = maxAtRisk;
+      rec.trailer.startClock = 0;
+      rec.trailer.endClock = 0;
+      if( rtc.valid() )
+      {
+         uint16_t ms;
+         rec.trailer.startClock = rtc.at( startTime, &ms );
+         rec.trailer.endClock = rtc.at( sampleTime, &ms );
+      }
+      captureFile.write( &rec, sizeof( rec ) );
+   }
+
+   // release the unused part of a preallocated file
+   LOGD( TAG, "captureFile.truncate: %ld", captureFile.curPosition() );
+   if( captureFile.isOpen() && !captureFile.truncate() )
+   {
+      LOGE( TAG, "Can't truncate capture file" );
+      flags.sdcard_error = true;
+   }
 
    LOGD( TAG, "captureFile.close" );
    captureFile.close();
+
+   // the next part is not needed anymore
+   if( nextFile.isOpen() && !nextFile.remove() )
+      LOGW( TAG, "Can't remove the next part" );
+   rotating = false;
+
+   // the capture was stopped cleanly, nothing to recover
+   if( !clearJournal() )
+      LOGW( TAG, "Can't remove the journal" );
+
    LOGI( TAG, "Stopped Capture %d", rc );
    return rc;
 }
@@ -1,5 +1,25 @@
 // --------------------------------------------------------------------------
 //
+// 2026-10-18  AWe   count the lost pin changes of the capture
+// 2026-10-18  AWe   read the pins without pin change events with SamplingRate
+// 2026-10-18  AWe   count only the deadlines with data
+// 2026-10-18  AWe   count the samples of the dropped records
+// 2026-10-18  AWe   count the i2c lost frames from the start
+// 2026-10-18  AWe   no pin change events of the usart pins
+// 2026-10-18  AWe   add sync checkpoints with bytes at risk statistics
+// 2026-10-18  AWe   record times in us of the timebase
+// 2026-10-18  AWe   add file rotation with a pre-created next file
+// 2026-10-18  AWe   add state of the adc delta encoding
+// 2026-10-18  AWe   write the pin change events
+// 2026-10-18  AWe   keep a pre-trigger history in the ring buffer
+// 2026-10-18  AWe   add start and stop pattern matcher
+// 2026-10-18  AWe   write the i2c frames from the queue
+// 2026-10-18  AWe   write the serial data in bursts
+// 2026-10-18  AWe   add deadline scheduler with per source statistics
+// 2026-10-18  AWe   stream to the card with a multi sector write
+// 2026-10-18  AWe   add ring buffer between the sources and the file
+// 2026-10-18  AWe   drain timer triggered adc blocks
+// 2026-10-18  AWe   add binary capture file format
 // 2020-06-16  AWe   print some statistics to capture file
 // 2020-06-03  AWe   initial version
 //
@@ -33,7 +53,30 @@
 #ifndef __CAPTURE_H__
 #define __CAPTURE_H__
 
+#include "DataLogger_config.h"
 #include "SdFat/SdFat.h"       // SdFile
+#include "SdFat/RingBuf.h"     // RingBuf
+#include "Matcher.h"
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef CAPTURE_BUFFER_SIZE
+   #define CAPTURE_BUFFER_SIZE   256      // ring buffer between sources and file
+#endif
+
+#ifndef CAPTURE_ROTATE_RESERVE
+   #define CAPTURE_ROTATE_RESERVE   1024  // bytes at the end of a part, for the data of one run()
+#endif
+
+#ifndef CAPTURE_HISTORY_RECORDS
+   #define CAPTURE_HISTORY_RECORDS  16    // records in the pre-trigger history, power of 2
+#endif
+
+#ifndef CAPTURE_TIME_KEEPALIVE
+   #define CAPTURE_TIME_KEEPALIVE   600000000UL // us, max time without a binary record
+#endif
 
 // --------------------------------------------------------------------------
 //
@@ -61,10 +104,116 @@ private:
    Source_t captureSource;
    uint32_t startTime;
    uint32_t sampleTime;
-   uint32_t nextSampleTime;
-   uint32_t nextSampleSioTime;
-   uint32_t nextSampleI2cTime;
+   uint32_t lastRecordTime;            // us of the timebase
    uint32_t sampleCount;
+   uint32_t fileSize;                  // preallocated size of the capture file
+
+   // file rotation, with settings.RotateSize or settings.RotateTime
+   SdFile nextFile;                    // created and preallocated before the switch
+   bool rotating;
+   uint16_t part;                      // 0 for the first file
+   uint32_t partStartTime;             // ms
+   uint32_t partStartMicros;           // us of the timebase at partStartTime
+
+   bool nextName( char *name );
+   bool createFile( SdFile *file, const char *name );
+   bool createNext( void );
+   uint32_t length( void );
+   bool rotateDue( void );
+   bool rotate( void );
+   void writeHeader( const char *previous );
+   void writeDirect( const void *buf, size_t len );
+
+   // sync checkpoints, with settings.SyncSize, SyncTime or SyncIdle
+   uint32_t syncPosition;              // file position at the last sync
+   uint32_t syncTime;                  // ms, last sync
+   uint32_t syncDataTime;              // ms, last change of the bytes at risk
+   uint32_t syncDataBytes;             // bytes at risk at syncDataTime
+   uint16_t syncCount;
+   uint32_t syncMaxUs;                 // longest sync
+   uint32_t syncTotalUs;               // time spent in sync
+   uint32_t maxAtRisk;                 // max bytes at risk of the capture
+
+   bool checkpoint( void );
+
+   // deadline scheduler, one entry per sampling rate
+   enum
+   {
+      SampleMain,                      // adc, digital; settings.SamplingRate
+      SampleSio,                       // settings.SerialSamplingRate
+      SampleI2c,                       // settings.I2cSamplingRate
+      NUM_DEADLINES
+   };
+
+   struct
+   {
+      uint32_t period;                 // ms, 0: every call of run()
+      uint32_t next;                   // ms, next deadline
+      uint32_t count;                  // deadlines which took a sample or wrote data
+      uint16_t missed;                 // deadlines skipped, because run() was too late
+      uint16_t maxLate;                // ms, max lateness of a sample
+   } deadline[ NUM_DEADLINES ];
+
+   void schedule( uint8_t id, uint32_t period );
+   bool due( uint8_t id );
+   void sampled( uint8_t id ) { deadline[ id ].count++; }
+
+   RingBuf< SdFile, CAPTURE_BUFFER_SIZE > ringBuf;
+   uint32_t droppedBytes;              // ring buffer was full
+   uint32_t droppedSamples;            // samples of the dropped records
+   uint16_t highWater;                 // max bytes used in the ring buffer
+
+   bool room( size_t len );
+   size_t put( const void *buf, size_t len );
+   void countSamples( bool written, uint16_t samples );
+   bool writeOut( bool all );
+
+   // pre-trigger history, kept in the ring buffer while ready for capture
+   bool armed;
+   uint8_t histLen[ CAPTURE_HISTORY_RECORDS ];   // bytes of each record
+   uint8_t histFirst;                  // index of the oldest record
+   uint8_t histCount;                  // number of records
+
+   void mark( void );
+   void dropOldest( void );
+
+#ifdef USE_RAW_WRITE
+   uint8_t *rawBuf;                    // sector buffer, NULL if not streaming
+   uint16_t rawCount;                  // bytes in rawBuf
+   uint32_t rawStartSector;            // first sector of the file
+   uint32_t rawSector;                 // next sector to write
+   uint32_t rawEndSector;              // last sector of the file
+
+   bool rawStart( void );
+   bool rawWriteOut( bool all );
+   bool rawStop( void );
+#endif
+
+   bool runText( void );
+   bool runBinary( void );
+   uint8_t sampledPins( void );
+   bool writeAdcBlock( void );
+#ifdef USE_ADC_DELTA
+   uint16_t adcPrev[ 6 ];              // last value of each enabled channel
+   uint8_t adcKeyCount;                // blocks since the last keyframe
+#endif
+#ifdef USE_PCINT
+   uint16_t edgesLost;                 // pin changes lost in this capture
+   bool writeEdges( void );
+   uint8_t edgePins( void );
+#endif
+   bool writeSio( void );
+
+#ifdef USE_UART_ISR
+   Matcher startMatcher;               // StartSample
+   Matcher stopMatcher;                // StopSample
+   bool sioStopped;                    // stop pattern received
+   uint32_t sioOverflowStart;          // uart overflows before the start
+#endif
+#ifdef USE_TWI
+   uint16_t i2cLostStart;              // i2c lost frames before the start
+#endif
+   bool writeI2c( void );
 
 public:
    Capture( void );
@@ -72,11 +221,15 @@ public:
 
    SdFile *file( void )    { return &captureFile; }
    Source_t source( void ) { return captureSource; }
+   uint32_t atRisk( void );            // bytes lost by a power loss now
 
    bool setup( void );
    bool start( void );
    bool run( void );
    bool stop( void );
+
+   void arm( void );
+   bool watch( void );
 };
 
 // --------------------------------------------------------------------------
@@ -10,6 +10,19 @@
 // Changelog
 //
 //
+// 2026-10-18  AWe   cast the pgm_read_ptr() of the parameter names
+// 2026-10-18  AWe   setOversampling(), setOversamplingBits() compared with =
+// 2026-10-18  AWe   setPreTrigger() compared with =, report a bad value
+// 2026-10-18  AWe   setSyncSize() started with an undefined size
+// 2026-10-18  AWe   get_file_size() compared with =, RotateSize 0 read garbage
+// 2026-10-18  AWe   setParameter() returns a value, required by the host build
+// 2026-10-18  AWe   add SyncSize, SyncTime, SyncIdle
+// 2026-10-18  AWe   add SystemTime and SerialStopBits to params[], set the rtc
+// 2026-10-18  AWe   add RotateSize, RotateTime
+// 2026-10-18  AWe   add Oversampling, OversamplingBits
+// 2026-10-18  AWe   add PreTrigger
+// 2026-10-18  AWe   store StartSample and StopSample
+// 2026-10-18  AWe   get sampling rate also in us, add unit us
 // 2020-06-03  AWe   initial version
 //
 // --------------------------------------------------------------------------
@@ -46,13 +59,21 @@
 //     x    setSamplingRate
 //     x    setSerialSamplingRate
 //     x    setI2cSamplingRate
-//          setStartSample
-//          setStopSample
+//     x    setStartSample
+//     x    setStopSample
 //     x    setSerialBaudrate
 //     x    setSerialBits
 //     x    setSerialParity
 //     x    setSerialStopBits
-//          setSystemTime
+//     x    setSystemTime
+//     x    setPreTrigger
+//     x    setOversampling
+//     x    setOversamplingBits
+//     x    setRotateSize
+//     x    setRotateTime
+//     x    setSyncSize
+//     x    setSyncTime
+//     x    setSyncIdle
 
 
 // --------------------------------------------------------------------------
@@ -76,6 +97,7 @@ static const char TAG[] PROGMEM = tag( "Config" );
 
 #include "Config.h"
 #include "Scanner.h"
+#include "Rtc.h"
 
 #include "SdFat/SdFat.h"       // SdVolume
 
@@ -100,6 +122,14 @@ void setSerialBits( void );
 void setSerialParity( void );
 void setSerialStopBits( void );
 void setSystemTime( void );
+void setPreTrigger( void );
+void setOversampling( void );
+void setOversamplingBits( void );
+void setRotateSize( void );
+void setRotateTime( void );
+void setSyncSize( void );
+void setSyncTime( void );
+void setSyncIdle( void );
 
 void DUMP_TOKEN( void );
 
@@ -133,6 +163,14 @@ Settings settings =
 #define str_param_11    "SerialParity"
 #define str_param_12    "SerialStopBits"
 #define str_param_13    "SystemTime"
+#define str_param_14    "PreTrigger"
+#define str_param_15    "Oversampling"
+#define str_param_16    "OversamplingBits"
+#define str_param_17    "RotateSize"
+#define str_param_18    "RotateTime"
+#define str_param_19    "SyncSize"
+#define str_param_20    "SyncTime"
+#define str_param_21    "SyncIdle"
 
 const char param_name_0[]  PROGMEM = str_param_0;
 const char param_name_1[]  PROGMEM = str_param_1;
@@ -148,6 +186,14 @@ const char param_name_10[] PROGMEM = str_param_10;
 const char param_name_11[] PROGMEM = str_param_11;
 const char param_name_12[] PROGMEM = str_param_12;
 const char param_name_13[] PROGMEM = str_param_13;
+const char param_name_14[] PROGMEM = str_param_14;
+const char param_name_15[] PROGMEM = str_param_15;
+const char param_name_16[] PROGMEM = str_param_16;
+const char param_name_17[] PROGMEM = str_param_17;
+const char param_name_18[] PROGMEM = str_param_18;
+const char param_name_19[] PROGMEM = str_param_19;
+const char param_name_20[] PROGMEM = str_param_20;
+const char param_name_21[] PROGMEM = str_param_21;
 
 //                               name           len                     id                  type                                 Example
 const Param_t param_0  PROGMEM = { param_name_0,  strlen( str_param_0  ), FileName,           Text   };   // FileName            "capture.txt"
@@ -164,6 +210,14 @@ const Param_t param_10 PROGMEM = { param_name_10, strlen( str_param_10 ), Serial
 const Param_t param_11 PROGMEM = { param_name_11, strlen( str_param_11 ), SerialParity,       Number };   // SerialParity        N, E, O
 const Param_t param_12 PROGMEM = { param_name_12, strlen( str_param_12 ), SerialStopBits,     Number };   // SerialStopBits      0, 1, 2
 const Param_t param_13 PROGMEM = { param_name_13, strlen( str_param_13 ), SystemTime,         Number };   // SystemTime          "2020-02-08 11:15:32"
+const Param_t param_14 PROGMEM = { param_name_14, strlen( str_param_14 ), PreTrigger,         Number };   // PreTrigger          0, 128, 256
+const Param_t param_15 PROGMEM = { param_name_15, strlen( str_param_15 ), Oversampling,       Number };   // Oversampling        1, 2, 4, .. 64
+const Param_t param_16 PROGMEM = { param_name_16, strlen( str_param_16 ), OversamplingBits,   Number };   // OversamplingBits    0 .. 5
+const Param_t param_17 PROGMEM = { param_name_17, strlen( str_param_17 ), RotateSize,         Number };   // RotateSize          0, 64M, 1G
+const Param_t param_18 PROGMEM = { param_name_18, strlen( str_param_18 ), RotateTime,         Number };   // RotateTime          0, 10min, 1h, 1d
+const Param_t param_19 PROGMEM = { param_name_19, strlen( str_param_19 ), SyncSize,           Number };   // SyncSize            0, 4K, 64K
+const Param_t param_20 PROGMEM = { param_name_20, strlen( str_param_20 ), SyncTime,           Number };   // SyncTime            0, 10 s, 1 min
+const Param_t param_21 PROGMEM = { param_name_21, strlen( str_param_21 ), SyncIdle,           Number };   // SyncIdle            0, 500 ms, 2 s
 
 const Param_t* const PROGMEM params[] PROGMEM =
 {
@@ -178,7 +232,17 @@ const Param_t* const PROGMEM params[] PROGMEM =
    &param_8,
    &param_9,
    &param_10,
-   &param_11
+   &param_11,
+   &param_12,
+   &param_13,
+   &param_14,
+   &param_15,
+   &param_16,
+   &param_17,
+   &param_18,
+   &param_19,
+   &param_20,
+   &param_21
 };
 
 const uint8_t num_params = sizeof( params ) / sizeof( Param_t* );
@@ -238,7 +302,7 @@ bool getConfiguration( void )
          {
             configFile.print( out_comment );
             const Param_t* param = ( const Param_t * )pgm_read_ptr( &params[ i ] );
-            const char *param_name = pgm_read_ptr( &param->name );
+            const char *param_name = ( const char * )pgm_read_ptr( &param->name );
             configFile.println( param_name );
          }
 
@@ -277,7 +341,7 @@ uint8_t getParameter( void )
          uint8_t param_nameLen = pgm_read_byte( &param->length );
          if( param_nameLen == tokenLen )
          {
-            const char *param_name = pgm_read_ptr( &param->name );
+            const char *param_name = ( const char * )pgm_read_ptr( &param->name );
             if( strncasecmp_P( token, param_name, tokenLen ) == 0 )
             {
                uint8_t param_id = pgm_read_byte( &param->id );
@@ -326,7 +390,16 @@ uint8_t setParameter( uint8_t param_id, uint8_t param_type )
       case SerialParity:         setSerialParity();         break;
       case SerialStopBits:       setSerialStopBits();       break;
       case SystemTime:           setSystemTime();           break;
+      case PreTrigger:           setPreTrigger();           break;
+      case Oversampling:         setOversampling();         break;
+      case OversamplingBits:     setOversamplingBits();     break;
+      case RotateSize:           setRotateSize();           break;
+      case RotateTime:           setRotateTime();           break;
+      case SyncSize:             setSyncSize();             break;
+      case SyncTime:             setSyncTime();             break;
+      case SyncIdle:             setSyncIdle();             break;
    }
+   return param_id;
 }
 
 // --------------------------------------------------------------------------
@@ -352,27 +425,37 @@ void DUMP_TOKEN( void )
 //
 // --------------------------------------------------------------------------
 
-void setFileName( void )
+void get_text( char *text, uint8_t size )
 {
-   // "filename.ext["]
+   // "text["]
 
-   char *filename = token;
+   char *str = token;
    uint8_t len = tokenLen;
 
-   if( *filename == '"' )
+   if( *str == '"' )
    {
-      filename++;
+      str++;
       len--;
    }
    len--;
-   if( filename[ len ] != '"' )
+   if( str[ len ] != '"' )
       len++;
 
-   if( len >= sizeof( settings.FileName ) )
-      len = sizeof( settings.FileName ) - 1;
+   if( len >= size )
+      len = size - 1;
+
+   strncpy( text, str, len );
+   text[ len ] = '\0';
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
 
-   strncpy( settings.FileName, filename, len );
-   settings.FileName[ len ] = '\0';
+void setFileName( void )
+{
+   // "filename.ext["]
+   get_text( settings.FileName, sizeof( settings.FileName ) );
    // SdFile::make83Name( const char* str, uint8_t* name )
 
    LOGI( TAG, "settings.FileName: <%s>", settings.FileName );
@@ -385,55 +468,116 @@ void setFileName( void )
 void setFileType( void )
 {
    if( strncasecmp_P( token, PSTR( "txt" ), 3 ) == 0 )
-      settings.FileType = 1; // txt
+      settings.FileType = TextFile;
    else
-      settings.FileType = 0; // bin
+      settings.FileType = BinaryFile;
 
-   LOGI( TAG, "settings.FileType: <%s>", settings.FileType ? "TXT" : "BIN" );
+   LOGI( TAG, "settings.FileType: <%s>", settings.FileType == TextFile ? "TXT" : "BIN" );
 }
 
 // --------------------------------------------------------------------------
 //
 // --------------------------------------------------------------------------
 
-void setFileSize( void )
+bool get_file_size( uint32_t *file_size )
 {
-   uint32_t value = ( uint32_t )( -1 );
-   uint32_t file_size = ( uint32_t )( -1 );
+   uint32_t value;
 
    DUMP_TOKEN();
    // get the number
-   if( tokenType = NUMBER )
+   if( tokenType == NUMBER )
    {
       value = atol( token );
 
       // get the unit of measurement
       // (none), G, M, K
       getToken();
-      if( tokenType = IDENT && tokenLen == 1 )
+      if( tokenType == IDENT && tokenLen == 1 )
       {
          if( *token == 'G' )
          {
-            file_size = value * 1024UL * 1024UL * 1024UL;
+            value *= 1024UL * 1024UL * 1024UL;
          }
          else if( *token == 'M' )
          {
-            file_size = value * 1024UL * 1024UL;
+            value *= 1024UL * 1024UL;
          }
          else if( *token == 'K' )
          {
-            file_size = value * 1024UL;
+            value *= 1024UL;
+         }
+         else
+         {
+            LOGE( TAG, "illegal size unit %c", *token );
+            return false;
          }
       }
-      else
+
+      *file_size = value;
+      return true;
+   }
+
+   return false;
+}
+
+// examples for file sizes
+// 2G, 1024M, 4K, 4096
+
+void setFileSize( void )
+{
+   uint32_t file_size = ( uint32_t )( -1 );
+
+   if( get_file_size( &file_size ) )
+      settings.FileSize = file_size;
+
+   LOGI( TAG, "settings.FileSize %d", settings.FileSize );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#define MIN_ROTATE_SIZE    ( 16 * 1024UL )
+
+void setRotateSize( void )
+{
+   // start a new capture file after this size, 0 is no rotation
+   uint32_t file_size = 0;
+
+   if( get_file_size( &file_size ) )
+   {
+      if( file_size && file_size < MIN_ROTATE_SIZE )
       {
-         file_size = value;
+         LOGW( TAG, "RotateSize too small, use %ld", MIN_ROTATE_SIZE );
+         file_size = MIN_ROTATE_SIZE;
       }
+      settings.RotateSize = file_size;
+   }
 
-      settings.FileSize = file_size;
+   LOGI( TAG, "settings.RotateSize %ld", settings.RotateSize );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void setSyncSize( void )
+{
+   // sync the capture file after this number of bytes, 0 is no sync by size
+   uint32_t sync_size = 0;
+
+   if( get_file_size( &sync_size ) )
+   {
+      // a sync writes at least one sector
+      if( sync_size && sync_size < 512 )
+      {
+         LOGW( TAG, "SyncSize too small, use %d", 512 );
+         sync_size = 512;
+      }
+      settings.SyncSize = sync_size;
    }
 
-   LOGI( TAG, "settings.FileSize %d", settings.FileSize );
+   LOGI( TAG, "settings.SyncSize %ld", settings.SyncSize );
 }
 
 // --------------------------------------------------------------------------
@@ -522,9 +666,10 @@ void setCaptureSource( void )
 //
 // --------------------------------------------------------------------------
 
-bool get_sampling_rate( uint32_t *sample_rate_ms )
+bool get_sampling_rate( uint32_t *sample_rate_ms, uint32_t *sample_period_us = NULL )
 {
    *sample_rate_ms = ( uint32_t )( -1 );
+   uint32_t period_us = ( uint32_t )( -1 );
    bool rc = false;
 
    // get the number
@@ -533,7 +678,7 @@ bool get_sampling_rate( uint32_t *sample_rate_ms )
       uint32_t value = atol( token );
 
       // get the unit of measurement
-      // ms, s, min, h, d, Hz, mHz
+      // us, ms, s, min, h, d, Hz, mHz
       getToken();
       if( tokenType = IDENT )
       {
@@ -554,13 +699,19 @@ bool get_sampling_rate( uint32_t *sample_rate_ms )
          }
          else if( tokenLen == 2 )
          {
-            if( strncasecmp_P( token, PSTR( "ms" ), 2 ) == 0 )
+            if( strncasecmp_P( token, PSTR( "us" ), 2 ) == 0 )
+            {
+               period_us = value;
+               *sample_rate_ms = value / 1000;
+            }
+            else if( strncasecmp_P( token, PSTR( "ms" ), 2 ) == 0 )
             {
                *sample_rate_ms = value;
             }
             else if( strncasecmp_P( token, PSTR( "Hz" ), 2 ) == 0 )
             {
-               *sample_rate_ms = ( ( 1000UL * 1000UL ) / value ) / 1000;
+               period_us = ( 1000UL * 1000UL ) / value;
+               *sample_rate_ms = period_us / 1000;
             }
          }
          else if( tokenLen == 3 )
@@ -571,17 +722,23 @@ bool get_sampling_rate( uint32_t *sample_rate_ms )
             }
             else if( strncasecmp_P( token, PSTR( "mHz" ), 3 ) == 0 )
             {
-               *sample_rate_ms = ( ( 1000UL * 1000UL * 1000UL ) / value ) / 1000;
+               period_us = ( 1000UL * 1000UL * 1000UL ) / value;
+               *sample_rate_ms = period_us / 1000;
             }
          }
       }
 
       if( *sample_rate_ms != ( uint32_t )( -1 ) )
+      {
+         if( period_us == ( uint32_t )( -1 ) && *sample_rate_ms < ( uint32_t )( -1 ) / 1000 )
+            period_us = *sample_rate_ms * 1000;
          rc = true;
+      }
    }
    else if( tokenType == IDENT && tokenLen == 3 && strncasecmp_P( token, PSTR( "MAX" ), 3 ) == 0 )
    {
       *sample_rate_ms = 0;
+      period_us = 0;
       rc = true;
    }
    else
@@ -589,20 +746,28 @@ bool get_sampling_rate( uint32_t *sample_rate_ms )
       // not a valid setting
    }
 
+   if( rc && sample_period_us )
+      *sample_period_us = period_us;
+
    return rc;
 }
 
 // examples for sample rates
-// 50ms, 1 h, 3600 s, 50Hz. MAX
+// 50ms, 1 h, 3600 s, 50Hz, 250us, MAX
 
 void setSamplingRate( void )
 {
    uint32_t sample_rate_ms;
+   uint32_t sample_period_us;
 
-   if( get_sampling_rate( &sample_rate_ms ) )
+   if( get_sampling_rate( &sample_rate_ms, &sample_period_us ) )
+   {
       settings.SamplingRate = sample_rate_ms;
+      settings.SamplingPeriodUs = sample_period_us;
+   }
 
    LOGI( TAG, "settings.SamplingRate %ld", settings.SamplingRate );
+   LOGI( TAG, "settings.SamplingPeriodUs %ld", settings.SamplingPeriodUs );
 }
 
 void setSerialSamplingRate( void )
@@ -625,12 +790,47 @@ void setI2cSamplingRate( void )
    LOGI( TAG, "settings.I2cSamplingRate %ld", settings.I2cSamplingRate );
 }
 
+void setRotateTime( void )
+{
+   // start a new capture file after this time, 0 is no rotation
+   uint32_t rotate_time_ms;
+
+   if( get_sampling_rate( &rotate_time_ms ) )
+      settings.RotateTime = rotate_time_ms;
+
+   LOGI( TAG, "settings.RotateTime %ld", settings.RotateTime );
+}
+
+void setSyncTime( void )
+{
+   // sync the capture file after this time, 0 is no sync by time
+   uint32_t sync_time_ms;
+
+   if( get_sampling_rate( &sync_time_ms ) )
+      settings.SyncTime = sync_time_ms;
+
+   LOGI( TAG, "settings.SyncTime %ld", settings.SyncTime );
+}
+
+void setSyncIdle( void )
+{
+   // sync the capture file when no data came for this time, 0 is no sync when idle
+   uint32_t sync_idle_ms;
+
+   if( get_sampling_rate( &sync_idle_ms ) )
+      settings.SyncIdle = sync_idle_ms;
+
+   LOGI( TAG, "settings.SyncIdle %ld", settings.SyncIdle );
+}
+
 // --------------------------------------------------------------------------
 //
 // --------------------------------------------------------------------------
 
 void setStartSample( void )
 {
+   // "pattern["]
+   get_text( settings.StartSample, sizeof( settings.StartSample ) );
    LOGI( TAG, "settings.StartSample: <%s>", settings.StartSample );
 }
 
@@ -640,6 +840,8 @@ void setStartSample( void )
 
 void setStopSample( void )
 {
+   // "pattern["]
+   get_text( settings.StopSample, sizeof( settings.StopSample ) );
    LOGI( TAG, "settings.StopSample: <%s>", settings.StopSample );
 }
 
@@ -722,9 +924,131 @@ void setSerialStopBits( void )
 //
 // --------------------------------------------------------------------------
 
+// the next token is the separator, the token behind it a number
+
+bool get_date_field( char separator, uint8_t *value )
+{
+   getToken();
+   if( tokenType != SYMBOL || *token != separator )
+      return false;
+
+   getToken();
+   if( tokenType != NUMBER )
+      return false;
+
+   *value = atol( token );
+   return true;
+}
+
+// --------------------------------------------------------------------------
+
+// 2020-07-17, 2020-07-17 08:44 or 2020-07-17 08:44:32
+
+bool get_system_time( uint32_t *time )
+{
+   RtcDate_t date = { 0 };
+
+   if( tokenType != NUMBER )
+      return false;
+   date.year = atol( token );
+
+   if( !get_date_field( '-', &date.month ) || !get_date_field( '-', &date.day ) )
+      return false;
+
+   // the time is optional
+   getToken();
+   if( tokenType == NUMBER )
+   {
+      date.hour = atol( token );
+      if( !get_date_field( ':', &date.minute ) )
+         return false;
+
+      // the seconds are optional, too
+      get_date_field( ':', &date.second );
+   }
+
+   if( date.year < 1980 || date.year > 2105 || date.month < 1 || date.month > 12 ||
+         date.day < 1 || date.day > 31 || date.hour > 23 || date.minute > 59 || date.second > 59 )
+      return false;
+
+   *time = Rtc::toTime( &date );
+   return true;
+}
+
+// --------------------------------------------------------------------------
+
 void setSystemTime( void )
 {
-   LOGI( TAG, "settings.SystemTime %d", settings.SystemTime );
+   uint32_t time;
+
+   // the config file is read again with each card, the clock is only set
+   // when SystemTime was changed
+   if( get_system_time( &time ) && time != settings.SystemTime )
+   {
+      settings.SystemTime = time;
+      rtc.set( time );
+   }
+
+   LOGI( TAG, "settings.SystemTime %ld", settings.SystemTime );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void setPreTrigger( void )
+{
+   // bytes of history, limited to the size of the capture ring buffer
+   if( tokenType == NUMBER )
+   {
+      settings.PreTrigger = atol( token );
+   }
+   else
+   {
+      LOGE( TAG, "PreTrigger must be a number of bytes" );
+   }
+
+   LOGI( TAG, "settings.PreTrigger %d", settings.PreTrigger );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void setOversampling( void )
+{
+   // number of adc scans summed up for one sample, a power of 2 up to 64
+   if( tokenType == NUMBER )
+   {
+      uint32_t oversampling = atol( token );
+
+      if( oversampling && oversampling <= 64 && ( oversampling & ( oversampling - 1 ) ) == 0 )
+         settings.Oversampling = oversampling;
+      else
+         LOGE( TAG, "Oversampling must be a power of 2 up to 64" );
+   }
+
+   LOGI( TAG, "settings.Oversampling %d", settings.Oversampling );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void setOversamplingBits( void )
+{
+   // additional bits of resolution, at most log2( Oversampling )
+   if( tokenType == NUMBER )
+   {
+      uint32_t bits = atol( token );
+
+      if( bits <= 5 )
+         settings.OversamplingBits = bits;
+      else
+         LOGE( TAG, "OversamplingBits must be 0 .. 5" );
+   }
+
+   LOGI( TAG, "settings.OversamplingBits %d", settings.OversamplingBits );
 }
 
 // --------------------------------------------------------------------------
@@ -1,5 +1,11 @@
 // --------------------------------------------------------------------------
 //
+// 2026-10-18  AWe   add sync checkpoint policy
+// 2026-10-18  AWe   add file rotation
+// 2026-10-18  AWe   add oversampling of the adc
+// 2026-10-18  AWe   add pre-trigger history size
+// 2026-10-18  AWe   add sampling period in us for the adc
+// 2026-10-18  AWe   add file types
 // 2020-06-03  AWe   initial version
 //
 // --------------------------------------------------------------------------
@@ -53,7 +59,21 @@ enum
    SerialBits,
    SerialParity,
    SerialStopBits,
-   SystemTime
+   SystemTime,
+   PreTrigger,
+   Oversampling,
+   OversamplingBits,
+   RotateSize,
+   RotateTime,
+   SyncSize,
+   SyncTime,
+   SyncIdle
+};
+
+enum
+{
+   BinaryFile,
+   TextFile
 };
 
 enum
@@ -85,7 +105,8 @@ typedef struct
    uint8_t  FileType;
    uint32_t FileSize;
    Source_t CaptureSource;
-   uint32_t SamplingRate;
+   uint32_t SamplingRate;           // ms
+   uint32_t SamplingPeriodUs;       // us, same as SamplingRate, used by the adc
    uint32_t SerialSamplingRate;
    uint32_t I2cSamplingRate;
    char     StartSample[ 9 ];
@@ -94,7 +115,15 @@ typedef struct
    uint8_t  SerialBits;
    uint8_t  SerialParity;
    uint8_t  SerialStopBits;
-   uint32_t SystemTime;
+   uint32_t SystemTime;             // s since 1970-01-01, start of the software rtc
+   uint16_t PreTrigger;             // bytes of history written before the start
+   uint8_t  Oversampling;           // adc scans per sample, power of 2
+   uint8_t  OversamplingBits;       // bits added to the 10 bit of the adc
+   uint32_t RotateSize;             // bytes, size of a capture file, 0 no rotation
+   uint32_t RotateTime;             // ms, duration of a capture file, 0 no rotation
+   uint32_t SyncSize;               // bytes written between two syncs, 0 no sync by size
+   uint32_t SyncTime;               // ms between two syncs, 0 no sync by time
+   uint32_t SyncIdle;               // ms without new data before a sync, 0 no sync when idle
 } Settings;
 
 // --------------------------------------------------------------------------
@@ -9,6 +9,10 @@
 // --------------------------------------------------------------------------
 // Changelog
 //
+// 2026-10-18  AWe   fill the free memory only on the AVR, not in the host build
+// 2026-10-18  AWe   start the us timebase on timer 1
+// 2026-10-18  AWe   run the text record benchmark with USE_BENCHMARK
+// 2026-10-18  AWe   use DbgSerial for the output, may be the own usart driver
 // 2020-06-14  AWe   move  BuildMsg to DataLogger.ino which is always compiled,
 //                   so we have the current build date and time
 // 2020-06-01  AWe   moved tasks to their own files
@@ -70,6 +74,9 @@ static const char TAG[] PROGMEM = tag( "DataLogger" );
 #include "UiTask.h"
 #include "Led.h"
 #include "Switch.h"
+#include "Uart.h"                      // UART_DEFAULT_BAUDRATE
+#include "Benchmark.h"                 // benchmarkTextRecord()
+#include "Timebase.h"                  // timebase.begin()
 
 // --------------------------------------------------------------------------
 // protoypes
@@ -95,11 +102,14 @@ Switch WriteProtect( WP_Pin );
 // Setup
 //------------------------------------------------------------------------------
 
+#ifdef __AVR__
 extern uint16_t __data_start;
 extern uint8_t* __brkval;
+#endif
 
 void setup()
 {
+#ifdef __AVR__
    // fill free memory with pattern
 
    uint8_t *start = __brkval;
@@ -108,6 +118,7 @@ void setup()
 
    while( tmp <  end )
       *tmp++ = 0xC5;
+#endif
 
 //   pinMode( BTN_Pin,   INPUT_PULLUP );
 //   pinMode( SS_Pin,    INPUT_PULLUP );
@@ -140,10 +151,10 @@ void setup()
 
 #ifdef USE_SERIAL_OUTPUT
    // Open serial communications and wait for port to open:
-   Serial.begin( 115200 );
+   DbgSerial.begin( UART_DEFAULT_BAUDRATE );
    delay( 2000 );
 
-   while( !Serial )
+   while( !DbgSerial )
    {
       ; // wait for serial port to connect. Needed for native USB port only
    }
@@ -151,26 +162,33 @@ void setup()
    for( uint8_t i = 0; i < num_buildmsg_str; i++ )
    {
       const char *ptr_P = ( char * ) pgm_read_ptr( &str_BuildMsg[ i ] );
-      Serial.println( ( const __FlashStringHelper * ) ptr_P );
+      DbgSerial.println( ( const __FlashStringHelper * ) ptr_P );
    }
 
  #ifdef EVAL_BREADBOARD
-   Serial.println( F( "Eval Board" ) );
+   DbgSerial.println( F( "Eval Board" ) );
  #else
    // ARDUINO_UNO_REV3
-   Serial.println( F( "Arduino Uno Board" ) );
+   DbgSerial.println( F( "Arduino Uno Board" ) );
  #endif
 #endif   // USE_SERIAL_OUTPUT
 
+#ifdef __AVR__
    LOGD( TAG, "start: 0x%04x end: 0x%04x", start, end );
    LOGD( TAG, "__data_start: 0x%04x", ( uint8_t * )&__data_start );
+#endif
    // dump_data_hex( ( const char* )&__data_start, 0x800 );
 
+#ifdef USE_BENCHMARK
+   benchmarkTextRecord();
+#endif
+
    posDISABLE_INTERRUPTS();  // disable interrupts
    posInit( 144 ); // put your setup code here, to run once:
    posENABLE_INTERRUPTS();   // enable interrupts
 
    Timer2init();
+   timebase.begin();
 
    // create the sdcard task
    uint8_t UiTaskID = posCreateTask( SdCardTask, 512 );
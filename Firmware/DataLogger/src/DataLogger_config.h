@@ -1,5 +1,10 @@
 // --------------------------------------------------------------------------
 //
+// 2026-10-18  AWe   USE_ADC_ISR, USE_ADC_DELTA, USE_PCINT off by default
+// 2026-10-18  AWe   add USE_BENCHMARK
+// 2026-10-18  AWe   add USE_ADC_DELTA
+// 2026-10-18  AWe   add USE_PCINT
+// 2026-10-18  AWe   add USE_ADC_ISR, USE_RAW_WRITE, USE_UART_ISR
 // 2020-05-25  AWe   adapted for use in DataLogger project
 // 2019-02-13  AWe   Pin D10 cannot used as input
 //                   see C:\Program Files (x86)\Arduino\hardware\arduino\avr\libraries\SPI\src\SPI.cpp(47):
@@ -46,6 +51,39 @@
 // serial output requires 1,816 kB flash memory
 #define USE_SERIAL_OUTPUT
 
+// The following options are off by default, the ATmega328P has 2 kB ram. The
+// bytes are those of the static data, as declared, without the stack.
+
+// sample the analog inputs with timer 1 and the adc interrupt,
+// instead of calling analogRead() from the capture loop,
+// the two adc blocks need 144 bytes ram, see Adc.h
+// #define USE_ADC_ISR
+
+// write the adc blocks of a binary file as zigzag deltas with varints, most
+// samples need one byte instead of two, see Record.h. Only with USE_ADC_ISR,
+// 13 bytes ram and 72 bytes stack while a block is written
+// #define USE_ADC_DELTA
+
+// stream a preallocated capture file with one multi sector write (CMD25)
+// directly to the card, the file system is not accessed while capturing,
+// the sectors are assembled in the cache of the volume, 16 bytes ram
+#define USE_RAW_WRITE
+
+// receive the serial data with an own usart interrupt into a large buffer with
+// burst time stamps, replaces the Arduino Serial, see Uart.cpp. Needed for
+// StartSample and StopSample. The receive buffer and the bursts need 185 bytes
+// ram, the matchers 24 bytes, instead of the 157 bytes of HardwareSerial
+#define USE_UART_ISR
+
+// record each change of the digital pins with the pin change interrupt and a
+// time in us, instead of sampling them with SamplingRate, see Pcint.cpp,
+// the event queue needs 46 bytes ram
+// #define USE_PCINT
+
+// format some text lines at startup with snprintf_P and with TextRecord and log
+// the records per second of both, see Benchmark.cpp
+// #define USE_BENCHMARK
+
 // --------------------------------------------------------------------------
 
 // LED_BUILDIN defineid in ...\avr\variants\standard\pins_arduino.h
@@ -0,0 +1,191 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          I2c.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   add clear()
+// 2026-10-18  AWe   include the Wire of the host build
+// 2026-10-18  AWe   frame time stamps in us of the timebase
+// 2026-10-18  AWe   initial version, queue of received i2c frames
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "I2c" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // noInterrupts(), interrupts(), ...
+   #include <Wire.h>
+#else
+   #include "WArduino.h"
+   #include "Wire.h"
+#endif
+
+#include "I2c.h"
+#include "Timebase.h"                  // timebase.micros()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// Wire calls the receive event from the twi interrupt, when the master has
+// finished the transaction. The next transaction overwrites the buffer of
+// Wire, so the frame is copied at once with its time into a free frame of the
+// pool. The capture task writes the frames later in the order of their
+// arrival. When no frame is free, the frame is dropped and counted.
+
+I2c i2c;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static void i2cReceiveEvent( int howMany )
+{
+   i2c.receiveIsr( howMany );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+I2c::I2c( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+I2c::~I2c( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void I2c::begin( uint8_t address )
+{
+   head = 0;
+   tail = 0;
+   lost = 0;
+
+   Wire.begin( address );                 // join i2c bus as slave
+   Wire.onReceive( i2cReceiveEvent );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void I2c::clear( void )
+{
+   noInterrupts();
+   tail = head;
+   interrupts();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+I2cFrame_t *I2c::get( void )
+{
+   if( tail == head )
+      return NULL;
+
+   return &frame[ tail ];
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void I2c::release( void )
+{
+   if( tail != head )
+      tail = ( tail + 1 ) & ( I2C_FRAME_COUNT - 1 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint16_t I2c::lostFrames( void )
+{
+   noInterrupts();
+   uint16_t count = lost;
+   interrupts();
+   return count;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void I2c::receiveIsr( int howMany )
+{
+   uint8_t next = ( head + 1 ) & ( I2C_FRAME_COUNT - 1 );
+
+   if( next == tail )
+   {
+      // no free frame, Wire flushes its buffer with the next transaction
+      lost++;
+      return;
+   }
+
+   I2cFrame_t *f = &frame[ head ];
+   f->time = timebase.micros();
+
+   uint8_t len = 0;
+   while( Wire.available() && len < I2C_FRAME_SIZE )
+      f->data[ len++ ] = Wire.read();
+   f->len = len;
+
+   head = next;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   add clear()
+// 2026-10-18  AWe   initial version, queue of received i2c frames
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __I2C_H__
+#define __I2C_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef I2C_FRAME_COUNT
+   #define I2C_FRAME_COUNT    4           // power of 2, frames in the pool
+#endif
+
+#ifndef I2C_FRAME_SIZE
+   #define I2C_FRAME_SIZE     32          // max bytes of a frame, BUFFER_LENGTH of Wire
+#endif
+
+typedef struct
+{
+   uint32_t time;                         // us of the timebase, end of the transaction
+   uint8_t  len;                          // number of bytes in data
+   uint8_t  data[ I2C_FRAME_SIZE ];
+} I2cFrame_t;
+
+class I2c
+{
+private:
+   I2cFrame_t frame[ I2C_FRAME_COUNT ];
+   volatile uint8_t head;                 // next free frame, written by the isr
+   volatile uint8_t tail;                 // next frame for the capture task
+   volatile uint16_t lost;                // frames dropped, because the pool was full
+
+public:
+   I2c( void );
+   ~I2c( void );
+
+   void begin( uint8_t address );
+   void clear( void );                    // drop the queued frames
+
+   I2cFrame_t *get( void );               // next received frame or NULL
+   void release( void );                  // give the frame back to the pool
+   uint16_t lostFrames( void );
+
+   void receiveIsr( int howMany );
+};
+
+extern I2c i2c;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __I2C_H__
@@ -0,0 +1,126 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Matcher.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, streaming pattern matcher for StartSample, StopSample
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "Matcher.h"
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// Knuth-Morris-Pratt matcher, the bytes are fed one by one as they are
+// received, nothing is buffered. After a mismatch the state falls back to the
+// longest prefix of the pattern, which is also a suffix of the matched part.
+// So each byte costs at most MATCHER_MAX_LEN steps, and a match is reported
+// exactly with its last byte.
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Matcher::Matcher( void )
+{
+   len = 0;
+   state = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Matcher::~Matcher( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Matcher::begin( const char *str )
+{
+   pattern = str;
+   len = strlen( str );
+   if( len > MATCHER_MAX_LEN )
+      len = MATCHER_MAX_LEN;
+   state = 0;
+
+   if( len == 0 )
+      return;
+
+   uint8_t k = 0;
+   fail[ 0 ] = 0;
+   for( uint8_t i = 1; i < len; i++ )
+   {
+      while( k > 0 && pattern[ i ] != pattern[ k ] )
+         k = fail[ k - 1 ];
+      if( pattern[ i ] == pattern[ k ] )
+         k++;
+      fail[ i ] = k;
+   }
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool Matcher::feed( uint8_t c )
+{
+   if( len == 0 )
+      return false;
+
+   while( state > 0 && c != ( uint8_t )pattern[ state ] )
+      state = fail[ state - 1 ];
+
+   if( c == ( uint8_t )pattern[ state ] )
+      state++;
+
+   if( state == len )
+   {
+      // overlapping matches are allowed
+      state = fail[ len - 1 ];
+      return true;
+   }
+   return false;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, streaming pattern matcher for StartSample, StopSample
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __MATCHER_H__
+#define __MATCHER_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef MATCHER_MAX_LEN
+   #define MATCHER_MAX_LEN    8           // same as StartSample, StopSample in Settings
+#endif
+
+class Matcher
+{
+private:
+   const char *pattern;                   // not copied, must stay valid
+   uint8_t  len;                          // 0: no pattern, never matches
+   uint8_t  state;                        // number of matched characters
+   uint8_t  fail[ MATCHER_MAX_LEN ];      // state after a mismatch
+
+public:
+   Matcher( void );
+   ~Matcher( void );
+
+   void begin( const char *str );
+   void reset( void )      { state = 0; }
+   bool enabled( void )    { return len != 0; }
+
+   bool feed( uint8_t c );                // true, if c completes the pattern
+};
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __MATCHER_H__
@@ -0,0 +1,211 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Pcint.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   only with USE_PCINT
+// 2026-10-18  AWe   time stamps from the timebase
+// 2026-10-18  AWe   initial version, queue of pin change events
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Pcint" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // noInterrupts(), interrupts(), ...
+   #include <avr/interrupt.h>       // ISR()
+#else
+   #include "WArduino.h"
+#endif
+
+#include "DataLogger_config.h"
+#include "Pcint.h"
+#include "Timebase.h"                  // timebase.micros()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_PCINT
+
+// The digital pins D0 .. D7 are the pins PD0 .. PD7 of port D, they share the
+// pin change interrupt PCINT2. Only the pins of the capture source are enabled
+// in PCMSK2. The isr reads PIND and queues the new state with the time in us,
+// so an edge is recorded independent of the sampling rate. The first event is
+// the state at begin().
+//
+// The isr only writes head and the capture task only writes tail, so the
+// queue needs no lock. When the queue is full, the edge is dropped and
+// counted.
+
+Pcint pcint;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Pcint::Pcint( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Pcint::~Pcint( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Pcint::begin( uint8_t pin_mask )
+{
+   noInterrupts();
+
+   mask = pin_mask;
+   lost = 0;
+   tail = 0;
+
+   last = PIND & mask;
+   event[ 0 ].time = timebase.micros();
+   event[ 0 ].state = last;
+   head = 1;
+
+   PCMSK2 = mask;
+   PCIFR = ( 1 << PCIF2 );                // clear a pending change
+   PCICR |= ( 1 << PCIE2 );
+
+   interrupts();
+
+   LOGD( TAG, "Pin change pins 0x%02x, state 0x%02x", mask, last );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Pcint::end( void )
+{
+   PCICR &= ~( 1 << PCIE2 );
+   PCMSK2 = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+PcintEvent_t *Pcint::get( void )
+{
+   if( tail == head )
+      return NULL;
+
+   return &event[ tail ];
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Pcint::release( void )
+{
+   if( tail != head )
+      tail = ( tail + 1 ) & ( PCINT_EVENT_COUNT - 1 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint16_t Pcint::lostEvents( void )
+{
+   noInterrupts();
+   uint16_t count = lost;
+   lost = 0;
+   interrupts();
+   return count;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Pcint::changeIsr( void )
+{
+   uint32_t time = timebase.micros();
+   uint8_t state = PIND & mask;
+
+   // a pulse shorter than the isr latency
+   if( state == last )
+      return;
+
+   last = state;
+
+   uint8_t next = ( head + 1 ) & ( PCINT_EVENT_COUNT - 1 );
+   if( next == tail )
+   {
+      lost++;
+      return;
+   }
+
+   event[ head ].time = time;
+   event[ head ].state = state;
+   head = next;
+}
+
+// --------------------------------------------------------------------------
+// Interrupt Service Routines
+// --------------------------------------------------------------------------
+
+ISR( PCINT2_vect )
+{
+   pcint.changeIsr();
+}
+
+#endif // USE_PCINT
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
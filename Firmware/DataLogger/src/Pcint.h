@@ -0,0 +1,80 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, queue of pin change events
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __PCINT_H__
+#define __PCINT_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef PCINT_EVENT_COUNT
+   #define PCINT_EVENT_COUNT  8           // power of 2, events in the queue
+#endif
+
+typedef struct
+{
+   uint32_t time;                         // us of the timebase at the pin change
+   uint8_t  state;                        // enabled pins D0 .. D7 after the change
+} PcintEvent_t;
+
+class Pcint
+{
+private:
+   PcintEvent_t event[ PCINT_EVENT_COUNT ];
+   volatile uint8_t head;                 // next free event, written by the isr
+   volatile uint8_t tail;                 // next event for the capture task
+   volatile uint16_t lost;                // events dropped, because the queue was full
+   uint8_t  mask;                         // enabled pins D0 .. D7
+   uint8_t  last;                         // pin state of the last event
+
+public:
+   Pcint( void );
+   ~Pcint( void );
+
+   void begin( uint8_t pin_mask );
+   void end( void );
+
+   PcintEvent_t *get( void );             // next event or NULL
+   void release( void );                  // give the event back to the queue
+   uint16_t lostEvents( void );           // dropped since the last call
+
+   void changeIsr( void );
+};
+
+extern Pcint pcint;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __PCINT_H__
@@ -0,0 +1,202 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   version 8, lost pin changes in the trailer
+// 2026-10-18  AWe   version 7, dropped samples in the trailer
+// 2026-10-18  AWe   version 6, recovery trailer
+// 2026-10-18  AWe   version 5, sync statistics in the trailer
+// 2026-10-18  AWe   version 4, clock time of the software rtc in header and trailer
+// 2026-10-18  AWe   version 3, record times in us of the timebase, time record
+// 2026-10-18  AWe   version 2, part number and previous file in the header
+// 2026-10-18  AWe   add adc delta block
+// 2026-10-18  AWe   add pin change record
+// 2026-10-18  AWe   pre-trigger records before the start
+// 2026-10-18  AWe   one record per i2c frame, add lost frames to the trailer
+// 2026-10-18  AWe   one record per serial burst, add sio overflow to the trailer
+// 2026-10-18  AWe   add ring buffer statistics to the trailer
+// 2026-10-18  AWe   add adc block record
+// 2026-10-18  AWe   initial version, binary capture file format
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __RECORD_H__
+#define __RECORD_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+// binary capture file format ( FileType BIN )
+// --------------------------------------------------------------------------
+
+// all values are little endian, the native byte order of the AVR
+//
+// file    := FileHeader_t { record } [ trailer ]
+//
+// record  := RecordHeader_t
+//            [ uint32_t time ]          if timeDelta == RECORD_TIME_EXT, us
+//            { uint16_t adc }           one word for each bit set in source.analog
+//            [ uint8_t  digital ]       if source.digital != 0, masked pin state
+//            [ uint8_t  len, data ]     if source.sio, received serial bytes, with
+//                                         USE_UART_ISR one burst in an own record
+//            [ uint8_t  len, data ]     if source.i2c, one received i2c frame
+//                                         in an own record
+//
+// adc     := RecordHeader_t with sync RECORD_SYNC_ADC and source.analog set,
+//            timeDelta is always RECORD_TIME_EXT
+//            uint32_t time                us of the first scan
+//            AdcBlockHeader_t
+//            { uint16_t adc }             scans * channels words, scan by scan
+//
+// adcd    := RecordHeader_t with sync RECORD_SYNC_ADC_DELTA and source.analog set,
+//            timeDelta is always RECORD_TIME_EXT
+//            uint32_t time                us of the first scan
+//            AdcBlockHeader_t
+//            AdcDeltaHeader_t
+//            { varint }                   scans * channels values, scan by scan
+//
+//            varint: 7 bits per byte, lowest bits first, bit 7 set when more
+//            bytes follow. The value is the zigzag encoded difference to the
+//            previous value of the channel, ( d << 1 ) ^ ( d >> 15 ). The
+//            previous values are 0 in a keyframe, so decoding can start there,
+//            otherwise they are the last scan of the previous adcd block.
+//
+// edges   := RecordHeader_t with sync RECORD_SYNC_EDGE and source.digital set,
+//            timeDelta is always RECORD_TIME_EXT
+//            uint32_t time                us of the first edge
+//            EdgeBlockHeader_t
+//            { uint32_t us, uint8_t state }  count pin changes, us is the time of
+//                                         the change, state the masked pins after it
+//
+// time    := RecordHeader_t with sync RECORD_SYNC_TIME and source == 0,
+//            timeDelta is always RECORD_TIME_EXT
+//            uint32_t time                written after CAPTURE_TIME_KEEPALIVE
+//                                         without any other record
+//
+// trailer := RecordHeader_t with source == 0, followed by RecordTrailer_t
+//            after a power loss the recovery at boot appends a trailer with
+//            sync RECORD_SYNC_RECOVERED, only startTime, endTime, sampleCount
+//            and parts are set, sampleCount is the number of records
+//
+// the record times are in us of the timebase, a 32 bit counter of timer 1
+// which wraps around after 71.6 minutes. The time of a record is the time of
+// the previous record plus timeDelta, the first record is relative to
+// FileHeader_t.partMicros. An absolute time is the lower 32 bit of the us,
+// the decoder takes the value next to the time of the previous record. There
+// are never more than CAPTURE_TIME_KEEPALIVE us between two records, so this
+// is unambiguous. FileHeader_t.partMicros is the us at FileHeader_t.partTime,
+// the ms of the log and of the text file are partTime + ( us - partMicros ) / 1000.
+// With SystemTime in config.txt FileHeader_t.clockTime is the date and time
+// at partMicros, so all record times can be converted to the clock time.
+//
+// The adc blocks are written when they are full, so their absolute time can
+// be older than the time of the previous record. The same is true for the pin
+// change records.
+//
+// with a PreTrigger setting the records captured before the start follow the
+// FileHeader_t, they all use RECORD_TIME_EXT and may be older than
+// FileHeader_t.startTime.
+//
+// with RotateSize or RotateTime a capture is split into parts, each part is
+// an own file with a FileHeader_t. FileHeader_t.previous links a part to the
+// file of the part before. The first record of a part uses RECORD_TIME_EXT,
+// so each part can be decoded by its own. Only the last part has a trailer.
+
+#define RECORD_MAGIC          "DLOG"
+#define RECORD_VERSION        8
+#define RECORD_SYNC           0xA5
+#define RECORD_SYNC_ADC       0xA6        // block of timer triggered adc scans
+#define RECORD_SYNC_ADC_DELTA 0xA8        // block of adc scans, delta encoded
+#define RECORD_SYNC_EDGE      0xA7        // pin change events of the digital pins
+#define RECORD_SYNC_TIME      0xA9        // only the time, without data for a long time
+#define RECORD_SYNC_RECOVERED 0xAA        // trailer of a file recovered after a power loss
+#define RECORD_TIME_EXT       0xFFFF      // timeDelta escape, absolute us follow
+
+typedef struct __attribute__( ( packed ) )
+{
+   char     magic[ 4 ];       // RECORD_MAGIC, not zero terminated
+   uint8_t  version;          // RECORD_VERSION
+   uint8_t  headerSize;       // sizeof( FileHeader_t )
+   uint16_t source;           // Source_t.val of the capture
+   uint32_t startTime;        // ms
+   uint32_t samplingRate;     // ms
+   uint16_t part;             // part of a rotated capture, 0 the first one
+   char     previous[ 13 ];   // 8.3 name of the file of the previous part, empty for part 0
+   uint32_t partTime;         // ms, start of this part, startTime for part 0
+   uint32_t partMicros;       // us of the timebase at partTime
+   uint32_t clockTime;        // s since 1970-01-01 at partMicros, 0 without SystemTime
+   uint16_t clockMs;          // ms of clockTime
+} FileHeader_t;
+
+typedef struct __attribute__( ( packed ) )
+{
+   uint8_t  sync;             // RECORD_SYNC
+   uint16_t source;           // Source_t.val of the data in this record
+   uint16_t timeDelta;        // us since previous record
+} RecordHeader_t;
+
+typedef struct __attribute__( ( packed ) )
+{
+   uint8_t  scans;            // number of scans in this block
+   uint16_t lost;             // scans dropped before this block
+   uint32_t period;           // us between two scans
+} AdcBlockHeader_t;
+
+typedef struct __attribute__( ( packed ) )
+{
+   uint8_t  keyframe;         // 1: deltas to 0, 0: deltas to the previous block
+   uint8_t  size;             // bytes of varints following
+} AdcDeltaHeader_t;
+
+typedef struct __attribute__( ( packed ) )
+{
+   uint8_t  count;            // number of pin changes in this block
+   uint16_t lost;             // pin changes dropped before this block
+} EdgeBlockHeader_t;
+
+typedef struct __attribute__( ( packed ) )
+{
+   uint32_t startTime;        // ms
+   uint32_t endTime;          // ms
+   uint32_t sampleCount;
+   uint32_t droppedBytes;     // lost, because the ring buffer was full
+   uint16_t highWater;        // max bytes used in the ring buffer
+   uint32_t sioOverflow;      // serial bytes lost, receive buffer full or usart overrun
+   uint16_t i2cLost;          // i2c frames lost, frame pool full
+   uint16_t parts;            // number of files of the capture
+   uint32_t startClock;       // s since 1970-01-01 at startTime, 0 without SystemTime
+   uint32_t endClock;         // s since 1970-01-01 at endTime, 0 without SystemTime
+   uint16_t syncCount;        // syncs of the capture file while capturing
+   uint32_t syncTime;         // us, spent in these syncs
+   uint32_t maxAtRisk;        // max bytes which a power loss would have lost
+   uint32_t droppedSamples;   // samples of the records dropped with droppedBytes
+   uint16_t edgesLost;        // pin changes lost since the start, event queue full
+} RecordTrailer_t;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __RECORD_H__
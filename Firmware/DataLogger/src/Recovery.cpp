@@ -0,0 +1,720 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Recovery.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   scan the cluster chain behind the directory size, keep the
+//                   files which can't be recovered, end a binary file at the
+//                   first record of an older capture
+// 2026-10-18  AWe   end a text file at the first line of an older capture, keep
+//                   files of an unknown version in the journal
+// 2026-10-18  AWe   initial version, recover capture files after a power loss
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Recovery" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // PROGMEM, ...
+#else
+   #include "WArduino.h"
+#endif
+
+#include <string.h>
+#include "Recovery.h"
+#include "Record.h"
+#include "Capture.h"                   // Source_t
+#include "Rtc.h"                       // Rtc::toTime()
+
+#define TRAILER   0x01                 // nextRecord() found the trailer
+
+#ifndef RECOVERY_SLACK
+   #define RECOVERY_SLACK  600000UL    // ms, a line or block may be older than the newest data
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// While a capture is running, the journal holds the names of its file and of
+// the pre-created next part. stop() removes the journal. So a journal found
+// after power on means the capture was never stopped: the directory entry of
+// a preallocated file has the full preallocated size with old data behind the
+// captured one, the size of a growing file is the one of the last sync, and
+// the next part has no content at all. rotate() writes the journal before
+// the first byte goes to the next part.
+//
+// recoverCaptureFiles() takes the size of each file of the journal from its
+// cluster chain, so the clusters a growing file got after the last sync are
+// read, too. Capture::checkpoint() syncs a growing file once after its first
+// cluster, before that the directory entry has no cluster at all. Clusters
+// of a FAT sector which was still in the cache are lost.
+//
+// The file is read from the start until the data isn't valid anymore. A
+// binary file is parsed record by record up to the first record of an older
+// capture, a text file ends at the first byte 0x00 or 0xff or at the first
+// line of an older capture, behind its last complete line. The file is
+// truncated there and a recovery trailer or line is appended.
+//
+// Only files which are provably empty are removed: a file without clusters
+// and the pre-created next part without valid data. A capture file without
+// valid data stays as it is. A file which can't be recovered, because of a
+// read or write error or an unknown version, stays in the journal.
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool writeJournal( SdFile *current, SdFile *next )
+{
+   SdFile journal;
+   char name[ 12 + 1 ];
+
+   if( !journal.open( RECOVERY_JOURNAL, ( O_WRITE | O_CREAT | O_TRUNC ) ) )
+      return false;
+
+   if( current->isOpen() && current->getName( name, sizeof( name ) ) )
+      journal.println( name );
+   if( next->isOpen() && next->getName( name, sizeof( name ) ) )
+      journal.println( name );
+
+   return journal.close();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool clearJournal( void )
+{
+   SdFile journal;
+
+   if( !journal.open( RECOVERY_JOURNAL, O_WRITE ) )
+      return true;
+
+   return journal.remove();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+static uint8_t countBits( uint8_t mask )
+{
+   uint8_t n = 0;
+
+   for( ; mask; mask >>= 1 )
+      n += mask & 1;
+   return n;
+}
+
+// --------------------------------------------------------------------------
+// skip the length byte and the data behind it
+// --------------------------------------------------------------------------
+
+static bool skipData( SdFile *file )
+{
+   uint8_t len;
+
+   if( file->read( &len, 1 ) != 1 )
+      return false;
+   return file->seekCur( len );
+}
+
+// --------------------------------------------------------------------------
+// check the record at the current position and move behind it, the time is
+// updated with the time of the record. Return the sync byte of the record,
+// TRAILER for the trailer, which is not skipped, or 0 when there is no valid
+// record or a record with a source which isn't captured.
+// --------------------------------------------------------------------------
+
+static uint8_t nextRecord( SdFile *file, uint16_t sources, uint32_t *time )
+{
+   RecordHeader_t header;
+   Source_t source;
+   uint32_t ext;
+
+   if( file->read( &header, sizeof( header ) ) != sizeof( header ) )
+      return 0;
+
+   source.val = header.source;
+   if( source.val & ~sources )
+      return 0;
+
+   if( header.timeDelta == RECORD_TIME_EXT )
+   {
+      if( file->read( &ext, sizeof( ext ) ) != sizeof( ext ) )
+         return 0;
+      *time = ext;
+   }
+   else if( header.sync == RECORD_SYNC && source.val != 0 )
+   {
+      *time += header.timeDelta;
+   }
+   else if( header.sync == RECORD_SYNC && header.timeDelta == 0 )
+   {
+      return TRAILER;
+   }
+   else
+   {
+      // all other records have an absolute time
+      return 0;
+   }
+
+   switch( header.sync )
+   {
+      case RECORD_SYNC:
+      {
+         if( source.val == 0 )
+            return 0;
+
+         if( !file->seekCur( countBits( source.analog ) * sizeof( uint16_t ) + ( source.digital ? 1 : 0 ) ) )
+            return 0;
+         if( source.sio && !skipData( file ) )
+            return 0;
+         if( source.i2c && !skipData( file ) )
+            return 0;
+      }
+      break;
+
+      case RECORD_SYNC_ADC:
+      case RECORD_SYNC_ADC_DELTA:
+      {
+         AdcBlockHeader_t adc;
+         uint8_t channels = countBits( source.analog );
+
+         if( channels == 0 || source.val != source.analog )
+            return 0;
+         if( file->read( &adc, sizeof( adc ) ) != sizeof( adc ) || adc.scans == 0 )
+            return 0;
+
+         if( header.sync == RECORD_SYNC_ADC )
+         {
+            if( !file->seekCur( adc.scans * channels * sizeof( uint16_t ) ) )
+               return 0;
+         }
+         else
+         {
+            AdcDeltaHeader_t delta;
+
+            if( file->read( &delta, sizeof( delta ) ) != sizeof( delta ) || delta.keyframe > 1 )
+               return 0;
+            if( !file->seekCur( delta.size ) )
+               return 0;
+         }
+      }
+      break;
+
+      case RECORD_SYNC_EDGE:
+      {
+         EdgeBlockHeader_t edges;
+
+         if( source.digital == 0 || source.val != ( source.digital << 8 ) )
+            return 0;
+         if( file->read( &edges, sizeof( edges ) ) != sizeof( edges ) || edges.count == 0 )
+            return 0;
+         if( !file->seekCur( edges.count * ( sizeof( uint32_t ) + sizeof( uint8_t ) ) ) )
+            return 0;
+      }
+      break;
+
+      case RECORD_SYNC_TIME:
+      {
+         if( source.val != 0 )
+            return 0;
+      }
+      break;
+
+      default:
+         return 0;
+   }
+
+   // a record at the end of the file is only valid, when it is complete
+   if( file->curPosition() > file->fileSize() )
+      return 0;
+
+   return header.sync;
+}
+
+// --------------------------------------------------------------------------
+// A preallocated file may hold records of an older capture behind the data,
+// see checkLine(). Each kind of record is written in time order, so a record
+// older than the previous record of its kind isn't part of the capture. The
+// adc and pin change blocks are written when they are full and may be older
+// than the newest record, but not by more than RECOVERY_SLACK. There are never
+// more than CAPTURE_TIME_KEEPALIVE us between two records, so a much newer
+// record isn't part of the capture either.
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   uint32_t newest;                    // us, newest record time
+   uint32_t last[ 4 ];                 // us, time of the previous record of each kind
+   uint8_t  seen;                      // bit mask, kinds with a previous record
+} Times_t;
+
+static bool checkRecord( uint8_t sync, uint32_t time, Times_t *times )
+{
+   uint8_t i = sync == RECORD_SYNC ? 0 : sync == RECORD_SYNC_EDGE ? 2 : sync == RECORD_SYNC_TIME ? 3 : 1;
+
+   int32_t d = time - times->newest;
+   if( d < -( int32_t )( RECOVERY_SLACK * 1000 ) || d > ( int32_t )( CAPTURE_TIME_KEEPALIVE + RECOVERY_SLACK * 1000 ) )
+      return false;
+
+   if( ( times->seen & ( 1 << i ) ) && ( int32_t )( time - times->last[ i ] ) < 0 )
+      return false;
+
+   times->last[ i ] = time;
+   times->seen |= 1 << i;
+   if( d > 0 )
+      times->newest = time;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// return 1, when the file was recovered, or -1 for an error. A valid header
+// is data, even without a record. With check the file isn't changed.
+// --------------------------------------------------------------------------
+
+static int8_t recoverBinary( SdFile *file, const FileHeader_t *header, bool check )
+{
+   uint32_t end = header->headerSize;
+   uint32_t count = 0;
+   uint32_t time = header->partMicros;
+   uint32_t ms = header->partTime;        // ms time of the last record
+   uint32_t ms_us = header->partMicros;   // us at ms
+   Times_t times;
+   uint8_t sync;
+
+   if( !file->seekSet( end ) )
+      return -1;
+
+   // the records before the start may be older than partMicros, too
+   memset( &times, 0, sizeof( times ) );
+   times.newest = header->partMicros;
+
+   while( ( sync = nextRecord( file, header->source, &time ) ) != 0 )
+   {
+      // the trailer is there, only the truncate() is missing
+      if( sync == TRAILER )
+      {
+         end += sizeof( RecordHeader_t ) + sizeof( RecordTrailer_t );
+         if( end > file->fileSize() )
+            break;
+
+         LOGI( TAG, "Trailer found at %ld", end - sizeof( RecordTrailer_t ) );
+         if( check )
+            return 1;
+         return file->truncate( end ) ? 1 : -1;
+      }
+
+      if( !checkRecord( sync, time, &times ) )
+      {
+         LOGI( TAG, "Record of an older capture at %ld", end );
+         break;
+      }
+
+      end = file->curPosition();
+      count++;
+
+      // follow the time forward, the adc and pin change blocks may be older
+      int32_t elapsed = time - ms_us;
+      if( elapsed >= 1000000L )
+      {
+         ms += elapsed / 1000;
+         ms_us += ( elapsed / 1000 ) * 1000;
+      }
+   }
+
+   LOGI( TAG, "%ld records, %ld bytes", count, end );
+   if( check )
+      return 1;
+
+   struct __attribute__( ( packed ) )
+   {
+      RecordHeader_t header;
+      RecordTrailer_t trailer;
+   } rec;
+
+   memset( &rec, 0, sizeof( rec ) );
+   rec.header.sync = RECORD_SYNC_RECOVERED;
+   rec.trailer.startTime = header->startTime;
+   rec.trailer.endTime = ms;
+   rec.trailer.sampleCount = count;
+   rec.trailer.parts = header->part + 1;
+
+   if( !file->truncate( end ) || !file->seekSet( end ) )
+      return -1;
+   return file->write( &rec, sizeof( rec ) ) == sizeof( rec ) ? 1 : -1;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The time stamp of a text line, the ms since boot "h:mm:ss.mmm" or the date
+// and time of the rtc "yyyy-mm-dd hh:mm:ss.mmm", see TextRecord::stamp().
+
+typedef struct
+{
+   uint32_t s;                         // since boot or since 1970
+   uint16_t ms;                        // NO_STAMP, no line yet
+   bool     clock;                     // date and time of the rtc
+} Stamp_t;
+
+#define NO_STAMP     0xFFFF
+
+static const char *readNumber( const char *str, uint32_t *value )
+{
+   if( *str < '0' || *str > '9' )
+      return NULL;
+
+   *value = 0;
+   while( *str >= '0' && *str <= '9' )
+      *value = *value * 10 + *str++ - '0';
+   return str;
+}
+
+// --------------------------------------------------------------------------
+// return the text behind the time stamp, or NULL for a line without one
+// --------------------------------------------------------------------------
+
+static const char *readStamp( const char *str, Stamp_t *stamp )
+{
+   uint32_t v[ 7 ];
+   uint8_t n = 0;
+   char c;
+
+   str = readNumber( str, &v[ n++ ] );
+   if( str == NULL )
+      return NULL;
+
+   const char *sep = *str == '-' ? PSTR( "-- ::." ) : PSTR( "::." );
+   while( ( c = pgm_read_byte( sep++ ) ) != '\0' )
+   {
+      if( *str++ != c )
+         return NULL;
+      str = readNumber( str, &v[ n++ ] );
+      if( str == NULL )
+         return NULL;
+   }
+
+   if( n == 7 )
+   {
+      RtcDate_t date;
+
+      date.year = v[ 0 ];
+      date.month = v[ 1 ];
+      date.day = v[ 2 ];
+      date.hour = v[ 3 ];
+      date.minute = v[ 4 ];
+      date.second = v[ 5 ];
+      stamp->s = Rtc::toTime( &date );
+      stamp->clock = true;
+   }
+   else
+   {
+      stamp->s = v[ 0 ] * 3600 + v[ 1 ] * 60 + v[ 2 ];
+      stamp->clock = false;
+   }
+   stamp->ms = v[ n - 1 ];
+   return str;
+}
+
+// --------------------------------------------------------------------------
+// true, when a is older than b by more than slack ms
+// --------------------------------------------------------------------------
+
+static bool older( const Stamp_t *a, const Stamp_t *b, uint32_t slack )
+{
+   if( a->clock != b->clock )
+      return true;
+
+   // more than 24 days apart, the ms don't fit
+   int32_t ds = b->s - a->s;
+   if( ds > 2000000L )
+      return true;
+   if( ds < -2000000L )
+      return false;
+
+   return ds * 1000L + b->ms - a->ms > ( int32_t )slack;
+}
+
+// --------------------------------------------------------------------------
+// A preallocated file may hold complete lines of an older capture behind the
+// data. Each source writes its lines in time order, so a line older than the
+// previous line of its source isn't part of the capture. The lines of the adc
+// blocks and pin changes are written when the block is full and may be older
+// than the first line of the file, but not by more than RECOVERY_SLACK.
+// Lines without a time stamp, like "ADC 3 scans lost", are always valid.
+// --------------------------------------------------------------------------
+
+static bool checkLine( const char *line, Stamp_t *first, Stamp_t *last )
+{
+   Stamp_t stamp;
+
+   const char *label = readStamp( line, &stamp );
+   if( label == NULL )
+      return true;
+
+   if( first->ms == NO_STAMP )
+      *first = stamp;
+   else if( older( &stamp, first, RECOVERY_SLACK ) )
+      return false;
+
+   // " ADC", " DIG", " SIO", " I2C"
+   const char *sources = PSTR( "ADSI" );
+   uint8_t i;
+   for( i = 0; i < 4 && pgm_read_byte( sources + i ) != label[ 1 ]; i++ )
+      ;
+   if( i == 4 )
+      return true;
+
+   if( last[ i ].ms != NO_STAMP && older( &stamp, &last[ i ], 0 ) )
+      return false;
+
+   last[ i ] = stamp;
+   return true;
+}
+
+// --------------------------------------------------------------------------
+// return 1, when the file was recovered, 0 when there is no complete line, or
+// -1 for an error. With check the file isn't changed.
+// --------------------------------------------------------------------------
+
+static int8_t recoverText( SdFile *file, bool check )
+{
+   uint8_t buf[ 32 ];
+   char line[ 32 ];                    // the start of the line, with the time stamp
+   uint8_t len = 0;
+   Stamp_t first;
+   Stamp_t last[ 4 ];
+   uint32_t end = 0;
+   int16_t n;
+
+   if( !file->seekSet( 0 ) )
+      return -1;
+
+   memset( &first, 0, sizeof( first ) );
+   memset( last, 0, sizeof( last ) );
+   first.ms = NO_STAMP;
+   for( uint8_t i = 0; i < 4; i++ )
+      last[ i ].ms = NO_STAMP;
+
+   // the end of the last complete line before the first invalid byte or line
+   while( ( n = file->read( buf, sizeof( buf ) ) ) > 0 )
+   {
+      uint32_t pos = file->curPosition() - n;
+      int16_t i;
+
+      for( i = 0; i < n; i++ )
+      {
+         if( buf[ i ] == 0x00 || buf[ i ] == 0xFF )
+            break;
+         if( buf[ i ] == '\n' )
+         {
+            line[ len ] = '\0';
+            len = 0;
+            if( !checkLine( line, &first, last ) )
+            {
+               LOGI( TAG, "Line of an older capture at %ld", end );
+               break;
+            }
+            end = pos + i + 1;
+         }
+         else if( len < sizeof( line ) - 1 )
+            line[ len++ ] = buf[ i ];
+      }
+      if( i < n )
+         break;
+   }
+
+   LOGI( TAG, "%ld bytes", end );
+   if( n < 0 )
+      return -1;
+   if( end == 0 )
+      return 0;
+   if( check )
+      return 1;
+
+   if( !file->truncate( end ) || !file->seekSet( end ) )
+      return -1;
+   return file->write( "Recovered after power loss\r\n", 28 ) == 28 ? 1 : -1;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// return false, when the file must stay in the journal. The next part is
+// only checked, it is removed when there is no valid data.
+
+static bool recoverFile( const char *name, bool next )
+{
+   SdFile file;
+   FileHeader_t header;
+   int8_t rc;
+
+   if( !file.open( name, O_RDWR ) )
+   {
+      LOGW( TAG, "Can't open <%s>", name );
+      return true;
+   }
+
+   // the clusters behind the size of the last sync
+   if( !file.sizeToChain() )
+   {
+      LOGE( TAG, "Can't read the clusters, keep <%s>", name );
+      file.close();
+      return false;
+   }
+
+   LOGI( TAG, "Recover <%s>, %ld bytes", name, file.fileSize() );
+
+   if( file.fileSize() == 0 )
+   {
+      LOGI( TAG, "Remove <%s>, no clusters", name );
+      file.remove();
+      return true;
+   }
+
+   if( file.read( &header, sizeof( header ) ) == sizeof( header ) &&
+         memcmp( header.magic, RECORD_MAGIC, sizeof( header.magic ) ) == 0 )
+   {
+      if( header.version != RECORD_VERSION || header.headerSize != sizeof( header ) )
+      {
+         // for the firmware which wrote it
+         LOGW( TAG, "Unknown version %d, keep <%s>", header.version, name );
+         file.close();
+         return false;
+      }
+      rc = recoverBinary( &file, &header, next );
+   }
+   else
+      rc = recoverText( &file, next );
+
+   if( rc < 0 )
+   {
+      LOGE( TAG, "Recovery failed, keep <%s>", name );
+      file.close();
+      return false;
+   }
+
+   if( rc == 0 && next )
+   {
+      LOGI( TAG, "Remove <%s>, no data", name );
+      file.remove();
+   }
+   else if( rc == 0 )
+   {
+      LOGW( TAG, "No data, keep <%s>", name );
+      file.close();
+   }
+   else if( next )
+   {
+      // not written by this capture, but maybe by another one
+      LOGW( TAG, "Data in the next part, keep <%s>", name );
+      file.close();
+   }
+   else
+   {
+      LOGI( TAG, "Recovered <%s>, %ld bytes", name, file.fileSize() );
+      file.close();
+   }
+   return true;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+bool recoverCaptureFiles( void )
+{
+   SdFile journal;
+   char name[ 12 + 1 ];
+   char keep[ 2 ][ 12 + 1 ];           // the current and the next part, see writeJournal()
+   uint8_t kept = 0;
+   uint8_t entry = 0;
+   uint8_t len = 0;
+   int c;
+
+   // remove() requires the write access
+   if( !journal.open( RECOVERY_JOURNAL, O_RDWR ) )
+      return false;
+
+   LOGW( TAG, "Capture was not stopped" );
+
+   // one 8.3 name per line
+   do
+   {
+      c = journal.read();
+      if( c >= 0 && c != '\r' && c != '\n' )
+      {
+         if( len < sizeof( name ) - 1 )
+            name[ len++ ] = c;
+      }
+      else if( len )
+      {
+         name[ len ] = '\0';
+         len = 0;
+         if( !recoverFile( name, entry++ > 0 ) && kept < 2 )
+            strcpy( keep[ kept++ ], name );
+      }
+   }
+   while( c >= 0 );
+
+   if( kept == 0 )
+      return journal.remove();
+
+   // only the files which were not recovered
+   if( !journal.truncate( 0 ) )
+      return false;
+   for( uint8_t i = 0; i < kept; i++ )
+      journal.println( keep[ i ] );
+   return journal.close();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
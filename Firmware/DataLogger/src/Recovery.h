@@ -0,0 +1,53 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, recover capture files after a power loss
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __RECOVERY_H__
+#define __RECOVERY_H__
+
+#include <stdint.h>
+#include "SdFat/SdFat.h"       // SdFile
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef RECOVERY_JOURNAL
+   #define RECOVERY_JOURNAL   "CAPTURE.JNL"  // names of the files of a running capture
+#endif
+
+bool writeJournal( SdFile *current, SdFile *next );
+bool clearJournal( void );
+bool recoverCaptureFiles( void );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __RECOVERY_H__
@@ -0,0 +1,248 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Rtc.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, software rtc kept by the timer 1 overflow
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Rtc" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // millis(), noInterrupts(), interrupts(), ...
+#else
+   #include "WArduino.h"
+#endif
+
+#include "Rtc.h"
+#include "Timebase.h"                  // TIMEBASE_TICKS_PER_US
+#include "SdFat/common/FsDateTime.h"   // FsDateTime::setCallback()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The board has no rtc, so the date and time of SystemTime in config.txt is
+// the start of a software clock. The timer 1 overflow of the timebase adds
+// its 32768 us to the clock, the same crystal clocks the time stamps of the
+// records. now() adds the ticks since the last overflow, so the clock has
+// the resolution of the timebase.
+//
+// The time is in seconds since 1970-01-01 00:00:00, without time zone. Once
+// the clock is set, SdFat asks it for the time stamps of the files.
+
+Rtc rtc;
+
+static void fsDateTime( uint16_t *date, uint16_t *time, uint8_t *ms10 );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Rtc::Rtc( void )
+{
+   isSet = false;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Rtc::~Rtc( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Rtc::set( uint32_t time )
+{
+   noInterrupts();
+   seconds = time;
+   fraction = 0;
+   interrupts();
+
+   if( !isSet )
+      FsDateTime::setCallback( fsDateTime );
+   isSet = true;
+
+   RtcDate_t date;
+   toDate( time, &date );
+   LOGI( TAG, "clock set to %04u-%02u-%02u %02u:%02u:%02u",
+         date.year, date.month, date.day, date.hour, date.minute, date.second );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint32_t Rtc::now( uint16_t *ms )
+{
+   uint8_t sreg = SREG;
+   noInterrupts();
+
+   uint32_t s = seconds;
+   uint32_t us = fraction;
+   uint16_t ticks = TCNT1;
+
+   // the overflow isr has not run yet, a small ticks value was read after it
+   if( ( TIFR1 & ( 1 << TOV1 ) ) && ticks < 0x8000 )
+      us += 32768;
+
+   SREG = sreg;
+
+   us += ticks / TIMEBASE_TICKS_PER_US;
+   while( us >= 1000000 )
+   {
+      us -= 1000000;
+      s++;
+   }
+
+   if( ms )
+      *ms = us / 1000;
+   return s;
+}
+
+// --------------------------------------------------------------------------
+// the clock time of a millis() time of the last 49 days
+// --------------------------------------------------------------------------
+
+uint32_t Rtc::at( uint32_t boot_ms, uint16_t *ms )
+{
+   uint16_t now_ms;
+   uint32_t s = now( &now_ms );
+   uint32_t age = millis() - boot_ms;
+
+   s -= age / 1000;
+   uint16_t age_ms = age % 1000;
+   if( now_ms < age_ms )
+   {
+      now_ms += 1000;
+      s--;
+   }
+
+   *ms = now_ms - age_ms;
+   return s;
+}
+
+// --------------------------------------------------------------------------
+// days since 1970-01-01 of a date and back, see
+// http://howardhinnant.github.io/date_algorithms.html
+// --------------------------------------------------------------------------
+
+uint32_t Rtc::toTime( const RtcDate_t *date )
+{
+   // the year starts in march, so the leap day is the last day of the year
+   uint16_t y = date->year - ( date->month <= 2 );
+   uint8_t m = date->month > 2 ? date->month - 3 : date->month + 9;
+
+   uint16_t era = y / 400;
+   uint16_t yoe = y - era * 400;                                  // 0 .. 399
+   uint16_t doy = ( 153 * m + 2 ) / 5 + date->day - 1;            // 0 .. 365
+   uint32_t doe = yoe * 365UL + yoe / 4 - yoe / 100 + doy;        // 0 .. 146096
+   uint32_t days = era * 146097UL + doe - 719468UL;
+
+   return ( ( days * 24 + date->hour ) * 60 + date->minute ) * 60 + date->second;
+}
+
+// --------------------------------------------------------------------------
+
+void Rtc::toDate( uint32_t time, RtcDate_t *date )
+{
+   uint32_t days = time / 86400UL;
+   uint32_t rest = time - days * 86400UL;
+
+   date->hour = rest / 3600;
+   rest -= date->hour * 3600UL;
+   date->minute = rest / 60;
+   date->second = rest - date->minute * 60;
+
+   days += 719468UL;
+   uint16_t era = days / 146097UL;
+   uint32_t doe = days - era * 146097UL;                                // 0 .. 146096
+   uint16_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365; // 0 .. 399
+   uint16_t doy = doe - ( 365UL * yoe + yoe / 4 - yoe / 100 );         // 0 .. 365
+   uint8_t mp = ( 5 * doy + 2 ) / 153;                                  // 0 .. 11
+
+   date->day = doy - ( 153 * mp + 2 ) / 5 + 1;
+   date->month = mp < 10 ? mp + 3 : mp - 9;
+   date->year = era * 400 + yoe + ( date->month <= 2 );
+}
+
+// --------------------------------------------------------------------------
+// called from the timer 1 overflow interrupt of the timebase
+// --------------------------------------------------------------------------
+
+void Rtc::tickIsr( void )
+{
+   uint32_t us = fraction + 32768;
+
+   if( us >= 1000000 )
+   {
+      us -= 1000000;
+      seconds++;
+   }
+   fraction = us;
+}
+
+// --------------------------------------------------------------------------
+// called by SdFat, when a file is created or its directory entry is updated
+// --------------------------------------------------------------------------
+
+static void fsDateTime( uint16_t *date, uint16_t *time, uint8_t *ms10 )
+{
+   uint16_t ms;
+   RtcDate_t now;
+   Rtc::toDate( rtc.now( &ms ), &now );
+
+   *date = FS_DATE( now.year, now.month, now.day );
+   *time = FS_TIME( now.hour, now.minute, now.second );
+   *ms10 = ( now.second & 1 ) * 100 + ms / 10;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, software rtc kept by the timer 1 overflow
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __RTC_H__
+#define __RTC_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+typedef struct
+{
+   uint16_t year;                         // 1970 .. 2105
+   uint8_t  month;                        // 1 .. 12
+   uint8_t  day;                          // 1 .. 31
+   uint8_t  hour;
+   uint8_t  minute;
+   uint8_t  second;
+} RtcDate_t;
+
+class Rtc
+{
+private:
+   volatile uint32_t seconds;             // since 1970-01-01 00:00:00
+   volatile uint32_t fraction;            // us of the current second, at the last overflow
+   bool isSet;
+
+public:
+   Rtc( void );
+   ~Rtc( void );
+
+   void set( uint32_t time );             // s since 1970-01-01 00:00:00
+   bool valid( void )                     { return isSet; }
+
+   uint32_t now( uint16_t *ms = 0 );      // s since 1970, ms of the second
+   uint32_t at( uint32_t boot_ms, uint16_t *ms );  // the same for a past millis()
+
+   static uint32_t toTime( const RtcDate_t *date );
+   static void toDate( uint32_t time, RtcDate_t *date );
+
+   void tickIsr( void );
+};
+
+extern Rtc rtc;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __RTC_H__
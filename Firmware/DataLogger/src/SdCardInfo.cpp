@@ -10,6 +10,7 @@
 // Changelog
 //
 //
+// 2026-10-18  AWe   use DbgSerial for the output, may be the own usart driver
 // 2020-06-16  AWe   fix issue with dumpDirectory()
 // 2020-06-01  AWe   initial version
 //
@@ -93,32 +94,32 @@ uint8_t dumpCID( void )
       sdErrorMsg( F( "readCID failed" ) );
       return false;
    }
-   Serial.print( F( "\nManufacturer ID:" ) );
-   Serial.println( cid.mid, HEX );
+   DbgSerial.print( F( "\nManufacturer ID:" ) );
+   DbgSerial.println( cid.mid, HEX );
 
-   Serial.print( F( "OEM ID: " ) );
-   Serial.print( cid.oid[0] );
-   Serial.println( cid.oid[1] );
+   DbgSerial.print( F( "OEM ID: " ) );
+   DbgSerial.print( cid.oid[0] );
+   DbgSerial.println( cid.oid[1] );
 
-   Serial.print( F( "Product: " ) );
+   DbgSerial.print( F( "Product: " ) );
    for( uint8_t i = 0; i < 5; i++ )
    {
-      Serial.print( cid.pnm[i] );
+      DbgSerial.print( cid.pnm[i] );
    }
-   Serial.println();
+   DbgSerial.println();
 
-   Serial.print( F( "\nVersion: " ) );
-   Serial.print( cid.prv_n );
-   Serial.print( '.' );
-   Serial.println( cid.prv_m );
+   DbgSerial.print( F( "\nVersion: " ) );
+   DbgSerial.print( cid.prv_n );
+   DbgSerial.print( '.' );
+   DbgSerial.println( cid.prv_m );
 
-   Serial.print( F( "Serial number: " ) );
-   Serial.println( cid.psn, HEX );
+   DbgSerial.print( F( "Serial number: " ) );
+   DbgSerial.println( cid.psn, HEX );
 
-   Serial.print( F( "Manufacturing date: " ) );
-   Serial.print( cid.mdt_month );
-   Serial.print( '/' );
-   Serial.println( 2000 + cid.mdt_year_low + 10 * cid.mdt_year_high );
+   DbgSerial.print( F( "Manufacturing date: " ) );
+   DbgSerial.print( cid.mdt_month );
+   DbgSerial.print( '/' );
+   DbgSerial.println( 2000 + cid.mdt_year_low + 10 * cid.mdt_year_high );
 
    return true;
 }
@@ -150,29 +151,29 @@ uint8_t dumpCSD( void )
    }
    else
    {
-      Serial.println( F( "csd version error" ) );
+      DbgSerial.println( F( "csd version error" ) );
       return false;
    }
 
    eraseSize++;
    // LOGD( TAG, "cardSize %ld sectors", cardSize );
-   Serial.print( F( "cardSize: " ) );
+   DbgSerial.print( F( "cardSize: " ) );
    // Serial.print( 0.000512 * cardSize );
-   Serial.print( ( ( cardSize + 500 ) / 1000L * 512L + 500 ) / 1000L );
-   Serial.println( F( "MB (MB = 1,000,000 bytes)" ) );
+   DbgSerial.print( ( ( cardSize + 500 ) / 1000L * 512L + 500 ) / 1000L );
+   DbgSerial.println( F( "MB (MB = 1,000,000 bytes)" ) );
 
-   Serial.print( F( "flashEraseSize: " ) );
-   Serial.print( eraseSize );
-   Serial.println( F( " blocks" ) );
+   DbgSerial.print( F( "flashEraseSize: " ) );
+   DbgSerial.print( eraseSize );
+   DbgSerial.println( F( " blocks" ) );
 
-   Serial.print( F( "eraseSingleBlock: " ) );
+   DbgSerial.print( F( "eraseSingleBlock: " ) );
    if( eraseSingleBlock )
    {
-      Serial.println( F( "true" ) );
+      DbgSerial.println( F( "true" ) );
    }
    else
    {
-      Serial.println( F( "false" ) );
+      DbgSerial.println( F( "false" ) );
    }
 
    return true;
@@ -208,24 +209,24 @@ uint8_t dumpMBR( void )
       }
    }
 
-   Serial.println( F( "\nSD Partition Table" ) );
-   Serial.println( F( "part,boot,type,start,length" ) );
+   DbgSerial.println( F( "\nSD Partition Table" ) );
+   DbgSerial.println( F( "part,boot,type,start,length" ) );
 
    for( uint8_t ip = 1; ip < 5; ip++ )
    {
       MbrPart_t *pt = &mbr.part[ip - 1];
-      Serial.print( pt->boot, HEX );
-      Serial.print( F( ", " ) );
-      Serial.print( pt->type, HEX );
-      Serial.print( F( ", " ) );
-      Serial.print( getLe32( pt->relativeSectors ) );
-      Serial.print( F( ", " ) );
-      Serial.println( getLe32( pt->totalSectors ) );
+      DbgSerial.print( pt->boot, HEX );
+      DbgSerial.print( F( ", " ) );
+      DbgSerial.print( pt->type, HEX );
+      DbgSerial.print( F( ", " ) );
+      DbgSerial.print( getLe32( pt->relativeSectors ) );
+      DbgSerial.print( F( ", " ) );
+      DbgSerial.println( getLe32( pt->totalSectors ) );
    }
 
    if (!valid)
    {
-      Serial.println( F( "\nNo MBR. Assuming Super Floppy format." ) );
+      DbgSerial.println( F( "\nNo MBR. Assuming Super Floppy format." ) );
    }
    return true;
 }
@@ -239,34 +240,34 @@ void dumpVolume( void )
    uint32_t freeClusterCount = sd.freeClusterCount();
    if( sd.fatType() <= 32 )
    {
-      Serial.print( F( "\nVolume is FAT" ) );
-      Serial.println( sd.fatType() );
+      DbgSerial.print( F( "\nVolume is FAT" ) );
+      DbgSerial.println( sd.fatType() );
    }
    else
    {
-      Serial.print( F( "\nVolume is exFAT" ) );
+      DbgSerial.print( F( "\nVolume is exFAT" ) );
    }
 
-   Serial.print( F( "sectorsPerCluster: " ) );
-   Serial.println( sd.sectorsPerCluster() );
+   DbgSerial.print( F( "sectorsPerCluster: " ) );
+   DbgSerial.println( sd.sectorsPerCluster() );
 
-   Serial.print( F( "clusterCount: " ) );
-   Serial.println( sd.clusterCount() );
+   DbgSerial.print( F( "clusterCount: " ) );
+   DbgSerial.println( sd.clusterCount() );
 
    uint32_t volFree = sd.freeClusterCount();
-   Serial.print( F( "freeClusters: " ) );
-   Serial.println( volFree );
+   DbgSerial.print( F( "freeClusters: " ) );
+   DbgSerial.println( volFree );
 
-   Serial.print( F( "fatStartSector: " ) );
-   Serial.println( sd.fatStartSector() );
+   DbgSerial.print( F( "fatStartSector: " ) );
+   DbgSerial.println( sd.fatStartSector() );
 
-   Serial.print( F( "dataStartSector: " ) );
-   Serial.println( sd.dataStartSector() );
+   DbgSerial.print( F( "dataStartSector: " ) );
+   DbgSerial.println( sd.dataStartSector() );
 
    if( sd.vol()->dataStartSector() % eraseSize )
    {
-      Serial.println( F( "Data area is not aligned on flash erase boundaries!" ) );
-      Serial.println( F( "Download and use formatter from www.sdcard.org!" ) );
+      DbgSerial.println( F( "Data area is not aligned on flash erase boundaries!" ) );
+      DbgSerial.println( F( "Download and use formatter from www.sdcard.org!" ) );
    }
 }
 
@@ -276,30 +277,30 @@ void dumpVolume( void )
 
 void printCardType( void )
 {
-   Serial.print( F( "Card type: " ) );
+   DbgSerial.print( F( "Card type: " ) );
    switch( sd.card()->type() )
    {
       case SD_CARD_TYPE_SD1:
-         Serial.println( F( "SD1" ) );
+         DbgSerial.println( F( "SD1" ) );
          break;
 
       case SD_CARD_TYPE_SD2:
-         Serial.println( F( "SD2" ) );
+         DbgSerial.println( F( "SD2" ) );
          break;
 
       case SD_CARD_TYPE_SDHC:
          if( cardSize < 70000000 )
          {
-            Serial.println( F( "SDHC" ) );
+            DbgSerial.println( F( "SDHC" ) );
          }
          else
          {
-            Serial.println( F( "SDXC" ) );
+            DbgSerial.println( F( "SDXC" ) );
          }
          break;
 
       default:
-         Serial.println( F( "Unknown" ) );
+         DbgSerial.println( F( "Unknown" ) );
    }
 }
 
@@ -309,10 +310,10 @@ void printCardType( void )
 
 void dumpSdCardInfo( void )
 {
-   Serial.println( F( "\nInitializing SD card..." ) );
+   DbgSerial.println( F( "\nInitializing SD card..." ) );
 
-   Serial.print( F( "SdFat version: " ) );
-   Serial.println( SD_FAT_VERSION );
+   DbgSerial.print( F( "SdFat version: " ) );
+   DbgSerial.println( SD_FAT_VERSION );
 
    cardSize = sd.card()->sectorCount() * 512;
    if( cardSize == 0 )
@@ -344,8 +345,8 @@ void dumpSdCardInfo( void )
       return;
    }
 
-   Serial.print( F( "OCR: " ) );
-   Serial.println( ocr, HEX );
+   DbgSerial.print( F( "OCR: " ) );
+   DbgSerial.println( ocr, HEX );
 
 #ifdef HAVE_SPACE
    // becasue of low memory space we cannot dump the partition information
@@ -373,10 +374,10 @@ void dumpSdCardInfo( void )
 
 void dumpDirectory( SdFat *dir )
 {
-   Serial.println( F( "\nFiles found on the card (name, date and size in bytes): " ) );
+   DbgSerial.println( F( "\nFiles found on the card (name, date and size in bytes): " ) );
 
    // list all files in the card with date and size
-   Serial.println( F( "list all files in the card with date and size" ) );
+   DbgSerial.println( F( "list all files in the card with date and size" ) );
    dir->ls( LS_R | LS_DATE | LS_SIZE );
 }
 
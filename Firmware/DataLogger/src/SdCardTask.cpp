@@ -10,6 +10,10 @@
 // Changelog
 //
 //
+// 2026-10-18  AWe   don't access the card for the removal check after the start
+// 2026-10-18  AWe   recover the files of a capture which was not stopped
+// 2026-10-18  AWe   arm the pre-trigger history when ready for capture
+// 2026-10-18  AWe   start the capture also with the start pattern
 // 2020-06-16  AWe   dump sdcard info and list files
 // 2020-06-01  AWe   initial version
 //
@@ -69,6 +73,7 @@ static const char TAG[] PROGMEM = tag( "SdCardTask" );
 #include "UiTask.h"
 #include "Config.h"
 #include "Capture.h"
+#include "Recovery.h"
 #include "Led.h"
 #include "Switch.h"
 
@@ -342,6 +347,10 @@ void SdCardTask_loop( void )
 #endif
             // extern uint16_t __data_start;
             // dump_data_hex( ( const char* )&__data_start, 0x800 );
+
+            // a capture was running, when the power failed or the card was removed
+            recoverCaptureFiles();
+
             // get the configuration or create a default configursation file
             if( getConfiguration() )
             {
@@ -362,6 +371,7 @@ void SdCardTask_loop( void )
                   posSemaphoreTake( StartStopCapture );
                   Led_R.off();
                   Led_G.off();
+                  capture.arm();
                   state = ReadyForCapture;
                }
             }
@@ -388,6 +398,10 @@ void SdCardTask_loop( void )
          // sdcard is prepared to get captured data
          // control capture process
 
+         // sample the pre-trigger history or wait for the start pattern
+         // on the serial interface
+         capture.watch();
+
          // wait for button to start capture process
          if( posSemaphoreTake( StartStopCapture ) )
          {
@@ -410,10 +424,9 @@ void SdCardTask_loop( void )
                state = FatalError;
             }
          }
-
          // start button not pressed
-         // check for card removed
-         if( isSdCardRemoved() )
+         // check for card removed, not while the capture streams to the card
+         else if( isSdCardRemoved() )
          {
             LOGD( TAG, "SdCard is removed" );
             flags.sdcard_ready = false;
@@ -438,6 +451,7 @@ void SdCardTask_loop( void )
             LOGD( TAG, "Stop capture" );
             capture.stop();
             Led_R.off();
+            capture.arm();
             state = ReadyForCapture;
 
             extern uint16_t __data_start;
@@ -751,6 +751,47 @@ bool FatFile::preAllocate(uint32_t length) {
   return false;
 }
 //------------------------------------------------------------------------------
+bool FatFile::sizeToChain() {
+  uint32_t cluster = m_firstCluster;
+  uint32_t next;
+  uint32_t count = 0;
+  uint32_t size;
+  int8_t fg;
+  if (!isFile() || !isWritable()) {
+    DBG_FAIL_MACRO;
+    goto fail;
+  }
+  while (cluster && count < m_vol->clusterCount()) {
+    count++;
+    fg = m_vol->fatGet(cluster, &next);
+    if (fg < 0) {
+      DBG_FAIL_MACRO;
+      goto fail;
+    }
+    if (fg == 0) {
+      break;
+    }
+    if (next < 2) {
+      // the FAT sector with the end of chain was not written
+      if (!m_vol->fatPutEOC(cluster)) {
+        DBG_FAIL_MACRO;
+        goto fail;
+      }
+      break;
+    }
+    cluster = next;
+  }
+  size = count > (0XFFFFFFFF >> m_vol->bytesPerClusterShift()) ?
+         0XFFFFFFFF : count << m_vol->bytesPerClusterShift();
+  if (size > m_fileSize) {
+    m_fileSize = size;
+  }
+  return true;
+
+ fail:
+  return false;
+}
+//------------------------------------------------------------------------------
 int FatFile::read(void* buf, size_t nbyte) {
   int8_t fg;
   uint8_t sectorOfCluster = 0;
@@ -576,6 +576,16 @@ class FatFile {
    * \return true for success or false for failure.
    */
   bool preAllocate(uint32_t length);
+  /** Set the size of the file to the size of its cluster chain.
+   *
+   * Used to read the data of a file which was not closed. The directory
+   * size is the one of the last sync(), the cluster chain may be longer.
+   * A chain which ends with a free cluster, a lost FAT sector, is ended
+   * there. The file must be open for write.
+   *
+   * \return true for success or false for failure.
+   */
+  bool sizeToChain();
   /** Print a file's access date
    *
    * \param[in] pr Print stream for output.
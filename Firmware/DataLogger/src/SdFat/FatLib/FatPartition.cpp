@@ -178,7 +178,7 @@ int8_t FatPartition::fatGet(uint32_t cluster, uint32_t* value) {
   if (fatType() == 32) {
     sector = m_fatStartSector + (cluster >> (m_bytesPerSectorShift - 2));
     pc = fatCachePrepare(sector, FsCache::CACHE_FOR_READ);
-    LOGD( TAG, "FAT32 fatCachePrepare sector 0x%04x, pc 0x%04x", ( uint16_t )sector, ( uint16_t )pc );
+    LOGD( TAG, "FAT32 fatCachePrepare sector 0x%04x, pc 0x%04x", ( uint16_t )sector, ( uint16_t )( uintptr_t )pc );
     if (!pc) {
       LOGE( TAG, "FAT32 cacheFetchFat failed" );
       DBG_FAIL_MACRO;
@@ -37,7 +37,13 @@
 // #define USE_UTF8_LONG_NAMES 1
 //
 // For minimum flash size use these settings:
+// The contiguous flag saves the FAT lookups and sector reads while writing
+// into the preallocated capture file without USE_RAW_WRITE, at the cost of
+// flash.
+// Build with -DUSE_FAT_FILE_FLAG_CONTIGUOUS=1 to use it.
+#ifndef USE_FAT_FILE_FLAG_CONTIGUOUS
 #define USE_FAT_FILE_FLAG_CONTIGUOUS 0
+#endif  // USE_FAT_FILE_FLAG_CONTIGUOUS
 #define ENABLE_DEDICATED_SPI 0
 #define USE_LONG_FILE_NAMES 0
 #define SDFAT_FILE_TYPE 1
@@ -60,7 +66,7 @@
 #endif  // PLATFORM_ID
 #endif  // ENABLE_ARDUINO_FEATURES
 
-#ifdef ARDUINO
+#if defined( ARDUINO ) || defined( WARDUINO )
    #include "../aweLog_config.h"    // USE_ALTERNATIVE_SERIAL_OUTPUT
 
    #ifndef DbgSerial
@@ -364,7 +370,7 @@ typedef uint8_t SdCsPin_t;
 #if defined(PLATFORM_ID) || defined(ESP8266)
 // If Particle device or ESP8266 call yield.
 #define WDT_YIELD_TIME_MILLIS 100
-#elif defined( ARDUINO )
+#elif defined( ARDUINO ) || defined( WARDUINO )
 #define WDT_YIELD_TIME_MILLIS 1
 #else  // defined(PLATFORM_ID) || defined(ESP8266)
 #define WDT_YIELD_TIME_MILLIS 0
@@ -55,7 +55,7 @@ class SysCall {
   static void yield();
 };
 #if ENABLE_ARDUINO_FEATURES
-#if defined(ARDUINO)
+#if defined(ARDUINO) || defined(WARDUINO)
 /** Use Arduino Print. */
 typedef Print print_t;
 /** Use Arduino Stream. */
@@ -76,7 +76,7 @@ inline void SysCall::yield() {
     Particle.process();
   }
 }
-#elif defined(ARDUINO)
+#elif defined(ARDUINO) || defined(WARDUINO)
 inline void SysCall::yield() {
   // Use the external Arduino yield() function.
   ::yield();
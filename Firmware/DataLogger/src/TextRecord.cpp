@@ -0,0 +1,211 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          TextRecord.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   add the clock time of the software rtc
+// 2026-10-18  AWe   initial version, printf free line encoder for text files
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // PROGMEM, pgm_read_byte(), ...
+#else
+   #include "WArduino.h"
+#endif
+
+#include "TextRecord.h"
+#include "Rtc.h"
+#include "SdFat/common/FmtNumber.h"    // fmtBase10()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::append( char c )
+{
+   if( len < TEXT_RECORD_SIZE - 2 )
+      buf[ len++ ] = c;
+}
+
+void TextRecord::append( const char *str, uint8_t n )
+{
+   if( n > room() )
+      n = room();
+
+   memcpy( buf + len, str, n );
+   len += n;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::time( uint32_t ms )
+{
+   uint32_t s = ms / 1000;
+   uint16_t msec = ms - s * 1000;
+   uint16_t hh = s / 3600;                // 0..1193 hours
+   uint16_t rest = s - hh * 3600UL;
+   uint8_t mm = rest / 60;
+   uint8_t ss = rest - mm * 60;
+
+   char tmp[ 5 ];
+   char *str = fmtBase10( tmp + sizeof( tmp ), hh );
+   append( str, tmp + sizeof( tmp ) - str );
+
+   append( ':' );
+   append( '0' + mm / 10 );
+   append( '0' + mm % 10 );
+   append( ':' );
+   append( '0' + ss / 10 );
+   append( '0' + ss % 10 );
+   append( '.' );
+   append( '0' + msec / 100 );
+   append( '0' + ( msec / 10 ) % 10 );
+   append( '0' + msec % 10 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::clock( uint32_t time, uint16_t ms )
+{
+   RtcDate_t date;
+   Rtc::toDate( time, &date );
+
+   char tmp[ 5 ];
+   char *str = fmtBase10( tmp + sizeof( tmp ), date.year );
+   append( str, tmp + sizeof( tmp ) - str );
+
+   append( '-' );
+   append( '0' + date.month / 10 );
+   append( '0' + date.month % 10 );
+   append( '-' );
+   append( '0' + date.day / 10 );
+   append( '0' + date.day % 10 );
+   append( ' ' );
+   append( '0' + date.hour / 10 );
+   append( '0' + date.hour % 10 );
+   append( ':' );
+   append( '0' + date.minute / 10 );
+   append( '0' + date.minute % 10 );
+   append( ':' );
+   append( '0' + date.second / 10 );
+   append( '0' + date.second % 10 );
+   append( '.' );
+   append( '0' + ms / 100 );
+   append( '0' + ( ms / 10 ) % 10 );
+   append( '0' + ms % 10 );
+}
+
+// --------------------------------------------------------------------------
+// ms is a millis() time
+// --------------------------------------------------------------------------
+
+void TextRecord::stamp( uint32_t ms )
+{
+   if( rtc.valid() )
+   {
+      uint16_t msec;
+      uint32_t time = rtc.at( ms, &msec );
+      clock( time, msec );
+   }
+   else
+      time( ms );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::label( const char *str_P )
+{
+   char c;
+
+   while( ( c = pgm_read_byte( str_P++ ) ) != '\0' )
+      append( c );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::text( const void *data, uint8_t n )
+{
+   append( ( const char * )data, n );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::value( uint32_t n )
+{
+   char tmp[ 11 ];
+   char *str = fmtBase10( tmp + sizeof( tmp ), n );
+
+   append( ' ' );
+   append( str, tmp + sizeof( tmp ) - str );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::hex( uint8_t n )
+{
+   static const char digits[] PROGMEM = "0123456789abcdef";
+
+   append( ' ' );
+   append( '0' );
+   append( 'x' );
+   append( pgm_read_byte( &digits[ n >> 4 ] ) );
+   append( pgm_read_byte( &digits[ n & 15 ] ) );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void TextRecord::end( void )
+{
+   buf[ len++ ] = '\r';
+   buf[ len++ ] = '\n';
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
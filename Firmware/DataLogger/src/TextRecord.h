@@ -0,0 +1,81 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   add clock() and stamp(), the date takes 11 more bytes
+// 2026-10-18  AWe   initial version, printf free line encoder for text files
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __TEXT_RECORD_H__
+#define __TEXT_RECORD_H__
+
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef TEXT_RECORD_SIZE
+   #define TEXT_RECORD_SIZE   80          // one line of a text file, with the line end
+#endif
+
+// A line of the text capture file is assembled in one buffer and then put
+// into the ring buffer with one call. The numbers are converted with the
+// integer routines of SdFat, there is no format string to parse. When the
+// line is full, the rest is cut off, the line end always fits.
+
+class TextRecord
+{
+private:
+   char buf[ TEXT_RECORD_SIZE ];
+   uint8_t len;
+
+   void append( char c );
+   void append( const char *str, uint8_t n );
+
+public:
+   TextRecord( void )            { len = 0; }
+
+   void clear( void )            { len = 0; }
+   const char *data( void )      { return buf; }
+   uint8_t length( void )        { return len; }
+   uint8_t room( void )          { return TEXT_RECORD_SIZE - 2 - len; }
+
+   void time( uint32_t ms );                 // h:mm:ss.mmm, as _log_time2str()
+   void clock( uint32_t time, uint16_t ms ); // yyyy-mm-dd hh:mm:ss.mmm, time in s since 1970
+   void stamp( uint32_t ms );                // clock() when the rtc is set, else time()
+   void label( const char *str_P );          // text from flash, PSTR( " ADC" )
+   void text( const void *data, uint8_t n ); // bytes as they are
+   void value( uint32_t n );                 // " 123"
+   void hex( uint8_t n );                    // " 0x1f"
+   void end( void );                         // "\r\n"
+};
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __TEXT_RECORD_H__
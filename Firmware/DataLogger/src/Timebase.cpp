@@ -0,0 +1,169 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Timebase.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   keep the software rtc with the overflow
+// 2026-10-18  AWe   initial version, 32 bit us timebase on timer 1
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Timebase" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // millis(), noInterrupts(), interrupts(), ...
+   #include <avr/interrupt.h>       // ISR()
+#else
+   #include "WArduino.h"
+#endif
+
+#include "Timebase.h"
+#include "Rtc.h"                       // rtc.tickIsr()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// Timer 1 runs free in normal mode with prescaler 8 from setup() on and is
+// never stopped. The overflow interrupt counts the 65536 ticks or 32768 us
+// periods, micros() puts the count and TCNT1 together. An overflow which is
+// pending, because micros() is called with disabled interrupts, is added
+// from TOV1. So micros() can be called from every isr, its resolution is
+// 0.5 us, while the micros() of the arduino core has 4 us and millis() 1 ms.
+//
+// The adc uses the compare match B of the same timer for its trigger, so
+// the scans and all time stamps have the same clock.
+
+Timebase timebase;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Timebase::Timebase( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Timebase::~Timebase( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Timebase::begin( void )
+{
+   noInterrupts();
+
+   TCCR1A = 0;                                     // normal mode
+   TCCR1B = ( 1 << CS11 );                         // prescaler 8
+   TCNT1  = 0;
+   overflows = 0;
+   TIFR1  = ( 1 << TOV1 );
+   TIMSK1 |= ( 1 << TOIE1 );
+
+   interrupts();
+
+   LOGI( TAG, "timer 1 timebase, %d ticks per us", TIMEBASE_TICKS_PER_US );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint32_t Timebase::micros( void )
+{
+   uint8_t sreg = SREG;
+   noInterrupts();
+
+   uint16_t ticks = TCNT1;
+   uint32_t count = overflows;
+
+   // the overflow isr has not run yet, a small ticks value was read after it
+   if( ( TIFR1 & ( 1 << TOV1 ) ) && ticks < 0x8000 )
+      count++;
+
+   SREG = sreg;
+
+   return ( count << 15 ) | ( ticks >> 1 );
+}
+
+// --------------------------------------------------------------------------
+// the ms time of the arduino core for a us time of the last hour,
+// as the text file and the log show it
+// --------------------------------------------------------------------------
+
+uint32_t Timebase::millis( uint32_t us )
+{
+   uint32_t ms = ::millis();
+   return ms - ( micros() - us ) / 1000;
+}
+
+// --------------------------------------------------------------------------
+// called from the timer 1 overflow interrupt
+// --------------------------------------------------------------------------
+
+void Timebase::overflowIsr( void )
+{
+   overflows++;
+}
+
+// --------------------------------------------------------------------------
+// Interrupt Service Routines
+// --------------------------------------------------------------------------
+
+ISR( TIMER1_OVF_vect )
+{
+   timebase.overflowIsr();
+   rtc.tickIsr();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
@@ -0,0 +1,369 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          Uart.cpp
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   peekBurst() returned old bytes after clear()
+// 2026-10-18  AWe   burst time stamps in us of the timebase
+// 2026-10-18  AWe   add peekBurst(), skip()
+// 2026-10-18  AWe   initial version, usart driver with rx interrupt and burst time stamps
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+// debug support
+// --------------------------------------------------------------------------
+
+#define LOG_LOCAL_LEVEL    LOG_INFO
+#include "aweLog.h"
+static const char TAG[] PROGMEM = tag( "Uart" );
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // noInterrupts(), interrupts(), ...
+   #include <avr/interrupt.h>       // ISR()
+#else
+   #include "WArduino.h"
+#endif
+
+#include "DataLogger_config.h"
+#include "Uart.h"
+#include "Timebase.h"                  // timebase.micros()
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint8_t uartConfig( uint8_t bits, uint8_t parity, uint8_t stop_bits )
+{
+   uint8_t config = 0;
+
+   // 5 .. 8 data bits, default 8
+   if( bits < 5 || bits > 8 )
+      bits = 8;
+   config |= ( bits - 5 ) << UCSZ00;
+
+   if( parity == 1 )                   // odd
+      config |= ( 1 << UPM01 ) | ( 1 << UPM00 );
+   else if( parity == 2 )              // even
+      config |= ( 1 << UPM01 );
+
+   if( stop_bits == 2 )
+      config |= ( 1 << USBS0 );
+
+   return config;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifdef USE_UART_ISR
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// The usart has only one receive interrupt, so this driver replaces the
+// Arduino Serial completely. The log output is transmitted without interrupt,
+// write() waits until the data register is empty.
+//
+// The receive interrupt puts the bytes into rxBuf. A byte after a pause of more
+// than UART_BURST_GAP us starts a new burst, the isr notes its time and its
+// position in rxBuf. readBurst() never returns bytes of two bursts, so each
+// chunk can be written with the time of its burst. When rxBuf is full, the
+// bytes are dropped and counted, as well as the bytes lost by a hardware
+// overrun.
+
+Uart uart;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Uart::Uart( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+Uart::~Uart( void )
+{
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::begin( uint32_t baudrate, uint8_t config )
+{
+   if( baudrate == 0 )
+      baudrate = UART_DEFAULT_BAUDRATE;
+
+   // same baudrate calculation as HardwareSerial::begin()
+   uint8_t ucsr0a = 1 << U2X0;
+   uint16_t baud_setting = ( F_CPU / 4 / baudrate - 1 ) / 2;
+
+   if( ( ( F_CPU == 16000000UL ) && ( baudrate == 57600 ) ) || ( baud_setting > 4095 ) )
+   {
+      ucsr0a = 0;
+      baud_setting = ( F_CPU / 8 / baudrate - 1 ) / 2;
+   }
+
+   // send the pending log output with the old settings
+   flush();
+
+   UCSR0B = 0;
+   UCSR0A = ucsr0a;
+   UBRR0 = baud_setting;
+   UCSR0C = config;
+
+   clear();
+
+   UCSR0B = ( 1 << RXEN0 ) | ( 1 << TXEN0 ) | ( 1 << RXCIE0 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::end( void )
+{
+   flush();
+   UCSR0B = 0;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::clear( void )
+{
+   noInterrupts();
+   rxHead = 0;
+   rxTail = 0;
+   burstHead = 0;
+   burstTail = 0;
+   memset( burst, 0, sizeof( burst ) );
+   overflow = 0;
+   interrupts();
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+int Uart::available( void )
+{
+   return ( uint8_t )( rxHead - rxTail ) & ( UART_RX_BUFFER_SIZE - 1 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+int Uart::read( void )
+{
+   uint8_t tail = rxTail;
+
+   if( tail == rxHead )
+      return -1;
+
+   uint8_t c = rxBuf[ tail ];
+   rxTail = ( tail + 1 ) & ( UART_RX_BUFFER_SIZE - 1 );
+   return c;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint8_t Uart::readBurst( uint8_t *buf, uint8_t len, uint32_t *time )
+{
+   len = peekBurst( buf, len, time );
+   skip( len );
+   return len;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint8_t Uart::peekBurst( uint8_t *buf, uint8_t len, uint32_t *time )
+{
+   uint8_t tail = rxTail;
+   uint8_t b = burstTail;
+   uint8_t next_b;
+   uint8_t end;
+
+   // without a burst there are no bytes, the entries behind burstHead are
+   // those of old bursts
+   if( b == burstHead )
+      return 0;
+
+   // skip the bursts which are read completely, the last burst is kept,
+   // the isr may append more bytes to it
+   for( ;; )
+   {
+      next_b = ( b + 1 ) & ( UART_BURST_COUNT - 1 );
+      end = ( next_b != burstHead ) ? burst[ next_b ].start : rxHead;
+      if( tail != end || next_b == burstHead )
+         break;
+      b = next_b;
+   }
+   burstTail = b;
+
+   if( tail == end )
+      return 0;
+
+   *time = burst[ b ].time;
+
+   // the bytes stay in rxBuf until skip()
+   uint8_t n = 0;
+   while( tail != end && n < len )
+   {
+      buf[ n++ ] = rxBuf[ tail ];
+      tail = ( tail + 1 ) & ( UART_RX_BUFFER_SIZE - 1 );
+   }
+
+   return n;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::skip( uint8_t len )
+{
+   rxTail = ( rxTail + len ) & ( UART_RX_BUFFER_SIZE - 1 );
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+uint32_t Uart::overflows( void )
+{
+   noInterrupts();
+   uint32_t count = overflow;
+   interrupts();
+   return count;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+size_t Uart::write( uint8_t c )
+{
+   while( !( UCSR0A & ( 1 << UDRE0 ) ) )
+      ;
+
+   // clear the transmit complete flag for flush(), keep double speed mode
+   UCSR0A = ( UCSR0A & ( 1 << U2X0 ) ) | ( 1 << TXC0 );
+   UDR0 = c;
+   written = true;
+   return 1;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::flush( void )
+{
+   if( !written )
+      return;
+
+   while( !( UCSR0A & ( 1 << TXC0 ) ) )
+      ;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void Uart::rxIsr( void )
+{
+   uint8_t status = UCSR0A;
+   uint8_t c = UDR0;
+
+   // at least one byte was lost in the usart
+   if( status & ( 1 << DOR0 ) )
+      overflow++;
+
+   uint8_t next = ( rxHead + 1 ) & ( UART_RX_BUFFER_SIZE - 1 );
+   if( next == rxTail )
+   {
+      overflow++;
+      return;
+   }
+
+   uint32_t now = timebase.micros();
+   if( burstHead == burstTail || now - lastRxTime > UART_BURST_GAP )
+   {
+      // without a free entry the byte is appended to the current burst
+      uint8_t next_burst = ( burstHead + 1 ) & ( UART_BURST_COUNT - 1 );
+      if( next_burst != burstTail )
+      {
+         burst[ burstHead ].time = now;
+         burst[ burstHead ].start = rxHead;
+         burstHead = next_burst;
+      }
+   }
+   lastRxTime = now;
+
+   rxBuf[ rxHead ] = c;
+   rxHead = next;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+ISR( USART_RX_vect )
+{
+   uart.rxIsr();
+}
+
+#endif // USE_UART_ISR
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
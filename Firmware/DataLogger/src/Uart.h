@@ -0,0 +1,115 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   add peekBurst(), skip()
+// 2026-10-18  AWe   initial version, usart driver with rx interrupt and burst time stamps
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __UART_H__
+#define __UART_H__
+
+#ifdef ARDUINO
+   #include <Arduino.h>             // Print
+#else
+   #include "WArduino.h"
+#endif
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+#ifndef UART_RX_BUFFER_SIZE
+   #define UART_RX_BUFFER_SIZE   128      // power of 2, max. 256
+#endif
+
+#ifndef UART_BURST_COUNT
+   #define UART_BURST_COUNT      8        // power of 2, bursts waiting in the buffer
+#endif
+
+#ifndef UART_BURST_GAP
+   #define UART_BURST_GAP     2000        // us, a longer pause starts a new burst
+#endif
+
+#define UART_DEFAULT_BAUDRATE    115200   // for the log output
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+// value for UCSR0C, same as SERIAL_8N1, ... of HardwareSerial
+uint8_t uartConfig( uint8_t bits, uint8_t parity, uint8_t stop_bits );
+
+class Uart : public Print
+{
+private:
+   uint8_t rxBuf[ UART_RX_BUFFER_SIZE ];
+   volatile uint8_t rxHead;               // written by the isr
+   volatile uint8_t rxTail;               // read by the capture task
+
+   struct
+   {
+      uint32_t time;                      // us of the timebase, first byte of the burst
+      uint8_t  start;                     // index of the first byte in rxBuf
+   } burst[ UART_BURST_COUNT ];
+   volatile uint8_t burstHead;            // next free entry
+   volatile uint8_t burstTail;            // burst which is read
+
+   uint32_t lastRxTime;                   // us, last received byte
+   volatile uint32_t overflow;            // bytes lost, buffer full or hardware overrun
+   bool     written;                      // something was transmitted, see flush()
+
+public:
+   Uart( void );
+   ~Uart( void );
+
+   void begin( uint32_t baudrate, uint8_t config = 0x06 );   // 8N1
+   void end( void );
+
+   int available( void );
+   int read( void );
+   uint8_t readBurst( uint8_t *buf, uint8_t len, uint32_t *time );
+   uint8_t peekBurst( uint8_t *buf, uint8_t len, uint32_t *time );
+   void skip( uint8_t len );
+
+   uint32_t overflows( void );
+   void clear( void );
+
+   virtual size_t write( uint8_t c );
+   using Print::write;
+   void flush( void );
+   operator bool() { return true; }
+
+   void rxIsr( void );
+};
+
+extern Uart uart;
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __UART_H__
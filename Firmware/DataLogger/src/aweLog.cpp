@@ -1,5 +1,8 @@
 // ------------------------------------------------------------------------------
 //
+// 2026-10-18  AWe   _log_write() wrote the zero behind print_buf, when a message was cut
+// 2026-10-18  AWe   the host build has no __brkval, fix the log level of the host format
+// 2026-10-18  AWe   use DbgSerial for the output, may be the own usart driver
 // 2020-06-03  AWe   add debugHelper
 // 2020-05-29  AWe   fix issue when __brkval is not set
 // 2019-08-08  AWe   add #include "aweLog_config.h" to aweLog.h
@@ -121,6 +124,10 @@ int freeMemory( void )
    }
    return free_memory;
 
+#elif !defined( __AVR__ )
+   // the host build has no heap below the stack
+   return INT16_MAX;
+
 #else
    // see F:\Arduino\libraries\SdFat\src\FreeStack.h
    char* sp = reinterpret_cast<char*>( SP );
@@ -178,13 +185,16 @@ void _log_write( char log_level, const char *tag_fmt, uint32_t log_time, uint16_
 #ifdef __AVR__
    written = snprintf_P( buf, buflen - TIME2STR_LEN, tag_fmt, log_level, time2str_buf, line );
 #else
-   written = snprintf( buf, buflen - TIME2STR_LEN, tag_fmt, time2str_buf, line );
+   written = snprintf( buf, buflen - TIME2STR_LEN, tag_fmt, log_level, time2str_buf, line );
 #endif
+   // snprintf returns the length of the whole string, also when it was cut
+   if( written > buflen - TIME2STR_LEN - 1 )
+      written = buflen - TIME2STR_LEN - 1;
    buf[ written ] = '\0';
    // buf += written;
    // buflen -= written;
 
-   Serial.print( print_buf );
+   DbgSerial.print( print_buf );
 
    va_list args;
    va_start( args, format );
@@ -198,8 +208,10 @@ void _log_write( char log_level, const char *tag_fmt, uint32_t log_time, uint16_
 #endif
    va_end( args );
 
+   if( written > buflen - 1 )
+      written = buflen - 1;
    buf[ written ] = '\0';
-   Serial.println( print_buf );
+   DbgSerial.println( print_buf );
 #endif // USE_SERIAL_OUTPUT
 }
 
@@ -261,7 +273,7 @@ int dump_data( const char* data, unsigned short len )
    }
    buf[i] = 0;
 
-   Serial.println( print_buf );
+   DbgSerial.println( print_buf );
    return i;
 }
 
@@ -282,14 +294,14 @@ int dump_text( const char* data, unsigned short len )
       char c = data[ i ];
       if( ( c >= 0x20 && c < 0x80 ) )
       {
-         cnt += Serial.print( c );
+         cnt += DbgSerial.print( c );
       }
       else
       {
-         cnt += Serial.print( c, HEX );
+         cnt += DbgSerial.print( c, HEX );
       }
    }
-   cnt += Serial.println();
+   cnt += DbgSerial.println();
    return cnt;
 }
 
@@ -321,7 +333,7 @@ int dump_data_hex( const char* data, unsigned short len )
          {
             *buf++ = '\0';
             // LOGD( TAG, "%d %d print_buf <%s> %d", i, j, print_buf, buflen );
-            Serial.print( print_buf );
+            DbgSerial.print( print_buf );
             buflen = sizeof( print_buf ) - 1;      // reserve one byte for the terminating zero
             buf = print_buf;
          }
@@ -339,7 +351,7 @@ int dump_data_hex( const char* data, unsigned short len )
       buflen--;
       *buf++ = '\0';
       // LOGD( TAG, "%d %d print_buf <%s> %d", i, j, print_buf, buflen );
-      Serial.print( print_buf );
+      DbgSerial.print( print_buf );
       buflen = sizeof( print_buf ) - 1;      // reserve one byte for the terminating zero
       buf = print_buf;
    }
@@ -9,6 +9,7 @@
 // --------------------------------------------------------------------------
 // Changelog
 //
+// 2026-10-18  AWe   define DbgSerial, the port for the log output
 // 2019-08-08  AWe   add project specific settings for aweLog here
 //
 // --------------------------------------------------------------------------
@@ -50,6 +51,19 @@
 #define PRINTF_BUFFER_SIZE          64          // resulting string limited to 64 chars
 #define CONFIG_LOG_DEFAULT_LEVEL    LOG_NONE
 
+// serial port for the log output
+#ifndef DbgSerial
+   #ifdef USE_UART_ISR
+      #include "Uart.h"
+      #define DbgSerial    uart
+   #elif defined( USE_ALTERNATIVE_SERIAL_OUTPUT )
+      // for Leonardo compatible boards use the hardware serial port for debug outputs
+      #define DbgSerial    Serial1
+   #else
+      #define DbgSerial    Serial
+   #endif
+#endif
+
 // --------------------------------------------------------------------------
 //
 // --------------------------------------------------------------------------
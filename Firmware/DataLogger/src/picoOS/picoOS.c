@@ -34,6 +34,7 @@
 // --------------------------------------------------------------------------
 // Changelog
 //
+//    2026-10-18  AWe   the host port implements the task switch by its own
 //    2020-06-02  AWe   add support for stack overflow checking
 //    2020-06-02  AWe   add support for posSemaphores
 //    2019-01-11  AWe   adapted for use with Arduino
@@ -51,12 +52,14 @@
 
 extern unsigned long posMillis( void );
 
+#ifndef posPORT_TASK_SWITCH
 unsigned char currentTask;
 unsigned char numTasks;
 
 stackPtrType taskStackPtrList[ 1 + MAX_TASKS ]; // main program counts as task zero
 stackPtrType taskMaxStackPtrList[ 1 + MAX_TASKS ];
 stackPtrType stackEnd;
+#endif
 
 posSemaphores_t posSemaphores = 0;
 
@@ -64,6 +67,7 @@ posSemaphores_t posSemaphores = 0;
 //
 // --------------------------------------------------------------------------
 
+#ifndef posPORT_TASK_SWITCH
 // SP defined in C:\Program Files (x86)\Arduino\hardware\tools\avr\avr\include\avr\common.h(89):
 
 void posInit( stackSizeType root_stack_size )
@@ -126,6 +130,8 @@ void posTaskSwitch( signed char taskID )
    }
 }
 
+#endif // posPORT_TASK_SWITCH
+
 //----------------------------------------------------------------------
 // Wait Task
 //----------------------------------------------------------------------
@@ -157,6 +163,7 @@ void posWait( unsigned char( *waitForReadyFunc )( void ) )
 // set task stack pointer with address to memory
 // save TaskAddress to task stack
 
+#ifndef posPORT_TASK_SWITCH
 unsigned char posCreateTask( taskFunctionType task, stackSizeType stack_size )
 {
    unsigned char rc = 0; // means could not create a new task
@@ -182,6 +189,7 @@ unsigned char posCreateTask( taskFunctionType task, stackSizeType stack_size )
 
    return rc;
 }
+#endif // posPORT_TASK_SWITCH
 
 // --------------------------------------------------------------------------
 //
@@ -261,6 +269,7 @@ posSemaphores_t posSemaphoreWait( posSemaphores_t semaphores, unsigned long time
 //
 // --------------------------------------------------------------------------
 
+#ifndef posPORT_TASK_SWITCH
 short posCheckStack( void )
 {
    return ( ( short )taskMaxStackPtrList[ currentTask ] - ( short )SP - sizeof( stackPtrType ) ) * posSTACK_GROWTH;
@@ -275,6 +284,7 @@ stackPtrType posGetCurrentStackEnd( void )
 {
    return taskMaxStackPtrList[ currentTask ];
 }
+#endif // posPORT_TASK_SWITCH
 
 // --------------------------------------------------------------------------
 //
@@ -36,6 +36,7 @@
 // --------------------------------------------------------------------------
 // Changelog
 //
+//    2026-10-18  AWe   add the host port for the WArduino build
 //    08.11.2012  AWe   start implemtation
 //
 // --------------------------------------------------------------------------
@@ -54,6 +55,9 @@
 #elif defined( __XC8)
    #include "posPort_XC8.h"
 
+#elif defined( WARDUINO )
+   #include "posPort_HOST.h"
+
 #endif
 
 // --------------------------------------------------------------------------
@@ -0,0 +1,173 @@
+// --------------------------------------------------------------------------
+//
+// Project       DataLogger
+//
+// File          posPort_HOST.c
+//
+// Author        Axel Werner
+//
+// --------------------------------------------------------------------------
+// Changelog
+//
+// 2026-10-18  AWe   initial version, task switch with swapcontext()
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#include "picoOS.h"
+
+#ifdef posPORT_TASK_SWITCH
+
+#include <stdlib.h>
+#include <ucontext.h>
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+unsigned char currentTask;
+unsigned char numTasks;
+
+static ucontext_t taskContext[ 1 + MAX_TASKS ];   // main program counts as task zero
+static char      *taskStack[ 1 + MAX_TASKS ];     // lowest address, NULL for the root task
+static size_t     taskStackSize[ 1 + MAX_TASKS ];
+
+// --------------------------------------------------------------------------
+// the lower 16 bit of the address as the stack pointer of the logs
+// --------------------------------------------------------------------------
+
+static stackPtrType stackPtr( const void *p )
+{
+   return ( stackPtrType )( uintptr_t )p;
+}
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+
+void posInit( stackSizeType root_stack_size )
+{
+   ( void )root_stack_size;               // the root task runs on the stack of main()
+
+   currentTask = 0;
+   numTasks = 1;                          // the first task is the root task
+   taskStack[ 0 ] = NULL;
+   taskStackSize[ 0 ] = 0;
+}
+
+// --------------------------------------------------------------------------
+// Start Task or change to next task
+// --------------------------------------------------------------------------
+
+void posTaskSwitch( signed char taskID )
+{
+   if( taskID < ( signed char )numTasks )
+   {
+      unsigned char prevTask = currentTask;
+
+      if( taskID == NEXT_TASK )
+      {
+         // switch to next task, round robbin priority
+         currentTask++;                            // select next task
+         if( !( currentTask < numTasks ) )
+         {
+            currentTask = ROOT_TASK;               // wrap around
+         }
+      }
+      else
+      {
+         // start the task matching the taskID
+         currentTask = taskID;
+      }
+
+      posHostTaskSwitch();
+
+      if( currentTask != prevTask )
+         swapcontext( &taskContext[ prevTask ], &taskContext[ currentTask ] );
+   }
+}
+
+// --------------------------------------------------------------------------
+// create task
+// --------------------------------------------------------------------------
+
+unsigned char posCreateTask( taskFunctionType task, stackSizeType stack_size )
+{
+   unsigned char rc = 0; // means could not create a new task
+
+   if( numTasks < 1 + MAX_TASKS )
+   {
+      unsigned char newTaskId = numTasks;
+      size_t size = stack_size < posHOST_MIN_STACKSIZE ? posHOST_MIN_STACKSIZE : stack_size;
+
+      char *stack = ( char * )malloc( size );
+      if( stack == NULL )
+         return 0;
+
+      getcontext( &taskContext[ newTaskId ] );
+      taskContext[ newTaskId ].uc_stack.ss_sp = stack;
+      taskContext[ newTaskId ].uc_stack.ss_size = size;
+      taskContext[ newTaskId ].uc_link = NULL;     // the tasks never return
+      makecontext( &taskContext[ newTaskId ], task, 0 );
+
+      taskStack[ newTaskId ] = stack;
+      taskStackSize[ newTaskId ] = size;
+      numTasks++;
+
+      rc = newTaskId;
+   }
+
+   return rc;
+}
+
+// --------------------------------------------------------------------------
+// unused bytes of the stack of the current task, the root task has the
+// stack of the process
+// --------------------------------------------------------------------------
+
+short posCheckStack( void )
+{
+   char top;
+
+   if( taskStack[ currentTask ] == NULL )
+      return 0x7FFF;
+
+   long left = &top - taskStack[ currentTask ];
+   return left > 0x7FFF ? 0x7FFF : ( short )left;
+}
+
+stackPtrType posGetStackEnd( signed char task_num )
+{
+   return stackPtr( taskStack[ task_num ] );
+}
+
+stackPtrType posGetCurrentStackEnd( void )
+{
+   return stackPtr( taskStack[ currentTask ] );
+}
+
+#endif // posPORT_TASK_SWITCH
@@ -0,0 +1,89 @@
+// --------------------------------------------------------------------------
+//
+// 2026-10-18  AWe   initial version, host port for the WArduino build
+//
+// --------------------------------------------------------------------------
+
+// --------------------------------------------------------------------------
+//
+// MIT License
+//
+// Copyright (c) 2021 Axel Werner (ataweg)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// --------------------------------------------------------------------------
+
+#ifndef __POSPORT_HOST_H__
+#define __POSPORT_HOST_H__
+
+// --------------------------------------------------------------------------
+// picoOS on the host, the tasks run on own stacks of the process and the
+// task switch is done with swapcontext(), see posPort_HOST.c
+// --------------------------------------------------------------------------
+
+#include <stdint.h>
+
+// the stack pointers are only printed in the logs, the lower 16 bit are
+// enough for this
+typedef unsigned short stackPtrType;
+typedef unsigned short stackSizeType;
+
+// the task switch, posInit(), posCreateTask() and the stack functions are
+// implemented by the port, not by picoOS.c
+#define posPORT_TASK_SWITCH
+
+// the stack sizes of the AVR are much too small for the host, a task
+// gets at least this number of bytes
+#ifndef posHOST_MIN_STACKSIZE
+   #define posHOST_MIN_STACKSIZE    ( 256 * 1024L )
+#endif
+
+// direction in which the stack growths, -1 means stack grows downwards
+#define posSTACK_GROWTH            ( -1 )
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// interrupt flag of the simulated cpu, see WArduino.cpp
+void cli( void );
+void sei( void );
+
+// called by the task switch, the simulation spends the time of the switch
+void posHostTaskSwitch( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#define posENTER_CRITICAL()        cli()
+#define posEXIT_CRITICAL()         sei()
+
+#define posDISABLE_INTERRUPTS()    cli();
+#define posENABLE_INTERRUPTS()     sei();
+
+// each task has its own host stack, the locals survive the task switch
+#define posPushShort( value )
+#define posPopShort( value )
+
+// --------------------------------------------------------------------------
+//
+// --------------------------------------------------------------------------
+#endif // __POSPORT_HOST_H__
@@ -9,6 +9,7 @@
 // --------------------------------------------------------------------------
 // Changelog
 //
+// 2026-10-18  AWe   declare ltoa() for the host build
 // 2019-11-06  AWe   suppress the printing of zero, for 0h0m, 0hm or 0m
 // 2019-10-31  AWe   fix issue with negative time value
 // 2019-09-30  AWe   for esp32 use itoa() instead of ltoa(), because we have
@@ -48,6 +49,10 @@
 // --------------------------------------------------------------------------
 
 #include <stdlib.h>     // ltoa()
+#ifdef WARDUINO
+   // avr-libc, not in the c library of the host, see WArduino.cpp
+   char *ltoa( long value, char *buf, int radix );
+#endif
 #include <string.h>     // strlen()
 #include "time2str.h"
 